@@ -1311,9 +1311,9 @@ static int Krb5_send_nocrypt( int *sock, int transfer_timeout, char *tempfile,
 }
 
 const struct security kerberos5_auth =
-	{ "kerberos*", "kerberos", "kerberos", IP_SOCKET_ONLY, 0,           Krb5_send, 0, Krb5_receive };
+	{ "kerberos*", "kerberos", "kerberos", IP_SOCKET_ONLY, 0,           Krb5_send, 0, Krb5_receive, 0, 0, 0 };
 const struct security k5conn_auth =
-	{ "k5conn", "k5conn", "kerberos", IP_SOCKET_ONLY, 0,           Krb5_send_nocrypt, 0, Krb5_receive_nocrypt };
+	{ "k5conn", "k5conn", "kerberos", IP_SOCKET_ONLY, 0,           Krb5_send_nocrypt, 0, Krb5_receive_nocrypt, 0, 0, 0 };
 
 
 #ifdef WITHPLUGINS
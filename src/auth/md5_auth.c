@@ -94,6 +94,38 @@ static void MDFile( int fd, unsigned char *outstring )
 	MD5Final(&mdContext, outstring);
 }
 
+/*
+ * MDCopy - copy size bytes (or up to EOF if size < 0) from in_fd to
+ *  out_fd,  hashing the data on the way so that it is not read again.
+ *  Returns 0, -1 on a read error or short input, -2 on a write error
+ */
+
+static int MDCopy( int timeout, int in_fd, double size, int out_fd,
+	unsigned char *outstring )
+{
+	MD5_CONTEXT mdContext;
+	unsigned char buffer[LARGEBUFFER];
+	int n, len, status = 0;
+
+	MD5Init (&mdContext);
+	while( size != 0 ){
+		len = sizeof(buffer);
+		if( size > 0 && len > size ) len = size;
+		if( (n = Read_fd_len_timeout( timeout, in_fd, (char *)buffer, len )) <= 0 ){
+			if( n < 0 || size > 0 ) status = -1;
+			break;
+		}
+		MD5Update(&mdContext, buffer, n);
+		if( Write_fd_len( out_fd, (char *)buffer, n ) < 0 ){
+			status = -2;
+			break;
+		}
+		if( size > 0 ) size -= n;
+	}
+	MD5Final(&mdContext, outstring);
+	return( status );
+}
+
 static char *hexstr( const unsigned char *str, int len, char *outbuf, int outlen )
 {
 	int i, j;
@@ -161,11 +193,15 @@ static int md5key( const char *keyfile, char *name, char *key, int keysize, char
  * input=%04t1          <- input that is 
  *   If you need to set a 'secure id' then you set the 'FROM'
  *
+ * The hash of the file is part of the response, which is sent before
+ * the file.  md5_send_stream() gets the job on in_fd and hashes it while
+ * it is copied into the tempfile,  md5_send() has to read the tempfile
+ * to hash it.
  **************************************************************/
 
-static int md5_send( int *sock, int transfer_timeout, char *tempfile,
-	char *errmsg, int errlen,
-	const struct security *security UNUSED, struct line_list *info )
+static int md5_send_work( int *sock, int transfer_timeout,
+	int in_fd, double size, char *tempfile,
+	char *errmsg, int errlen, struct line_list *info )
 {
 	unsigned char destkey[KEY_LENGTH+1];
 	unsigned char challenge[KEY_LENGTH+1];
@@ -276,17 +312,36 @@ static int md5_send( int *sock, int transfer_timeout, char *tempfile,
 	DEBUG1("md5_send: challenge^destkey^idkey '%s'", 
 		hexstr( challenge, KEY_LENGTH, buffer, sizeof(buffer) ));
 
-	DEBUG1("md5_send: opening tempfile '%s'", tempfile );
+	if( in_fd >= 0 ){
+		DEBUG1("md5_send: copying %0.0f bytes to tempfile '%s'", size, tempfile );
+		if( (tempfd = Checkwrite(tempfile,&statb,O_RDWR|O_TRUNC,1,0)) < 0){
+			plp_snprintf(errmsg, errlen,
+				"md5_send: open '%s' for write failed - %s",
+				tempfile, Errormsg(errno) );
+			status = JABORT;
+			goto error;
+		}
+		if( (n = MDCopy( transfer_timeout, in_fd, size, tempfd, filehash )) ){
+			plp_snprintf(errmsg, errlen,
+				"md5_send: %s failed - %s",
+				n == -1 ? "read of job" : "write to tempfile",
+				Errormsg(errno) );
+			status = JABORT;
+			goto error;
+		}
+	} else {
+		DEBUG1("md5_send: opening tempfile '%s'", tempfile );
 
-	if( (tempfd = Checkread(tempfile,&statb)) < 0){
-		plp_snprintf(errmsg, errlen,
-			"md5_send: open '%s' for read failed - %s",
-			tempfile, Errormsg(errno) );
-		status = JABORT;
-		goto error;
+		if( (tempfd = Checkread(tempfile,&statb)) < 0){
+			plp_snprintf(errmsg, errlen,
+				"md5_send: open '%s' for read failed - %s",
+				tempfile, Errormsg(errno) );
+			status = JABORT;
+			goto error;
+		}
+		DEBUG1("md5_send: doing md5 of file");
+		MDFile( tempfd, filehash);
 	}
-	DEBUG1("md5_send: doing md5 of file");
-	MDFile( tempfd, filehash);
 	DEBUG1("md5_send: filehash '%s'", 
 		hexstr( filehash, KEY_LENGTH, buffer, sizeof(buffer) ));
 
@@ -401,6 +456,23 @@ static int md5_send( int *sock, int transfer_timeout, char *tempfile,
 	return(status);
 }
 
+static int md5_send( int *sock, int transfer_timeout, char *tempfile,
+	char *errmsg, int errlen,
+	const struct security *security UNUSED, struct line_list *info )
+{
+	return( md5_send_work( sock, transfer_timeout, -1, 0, tempfile,
+		errmsg, errlen, info ) );
+}
+
+static int md5_send_stream( int *sock, int transfer_timeout,
+	int in_fd, double size, char *tempfile,
+	char *errmsg, int errlen,
+	const struct security *security UNUSED, struct line_list *info )
+{
+	return( md5_send_work( sock, transfer_timeout, in_fd, size, tempfile,
+		errmsg, errlen, info ) );
+}
+
 
 static int md5_receive( int *sock, int transfer_timeout,
 	char *user UNUSED, char *jobsize, int from_server, char *authtype UNUSED,
@@ -549,41 +621,26 @@ static int md5_receive( int *sock, int transfer_timeout,
 		plp_snprintf(errmsg, errlen,
 			"md5_receive: reopen of '%s' for write failed",
 			tempfile );
+		goto error;
 	}
 
 	DEBUGF(DRECV1)("md5_receive: starting read dest socket %d", *sock );
-	while( (n = Read_fd_len_timeout(transfer_timeout, *sock, buffer,sizeof(buffer)-1)) > 0 ){
-		buffer[n] = 0;
-		DEBUGF(DRECV4)("md5_receive: remote read '%d' '%s'", n, buffer );
-		if( write( tempfd,buffer,n ) != n ){
+	/* the file is hashed as it is received */
+	if( (n = MDCopy( transfer_timeout, *sock, -1, tempfd, filehash )) ){
+		if( n == -1 ){
+			plp_snprintf(errmsg, errlen,
+			"md5_receive: bad read reading file - '%s'", Errormsg(errno) );
+		} else {
 			plp_snprintf(errmsg, errlen,
 				"md5_receive: bad write to '%s' - '%s'",
 				tempfile, Errormsg(errno) );
-			goto error;
 		}
-	}
-
-	if( n < 0 ){
-		plp_snprintf(errmsg, errlen,
-		"md5_receive: bad read '%d' reading file ", n );
 		goto error;
 	}
 	close(tempfd); tempfd = -1;
 	DEBUGF(DRECV4)("md5_receive: end read" );
-
-	DEBUG1("md5_receive: opening tempfile '%s'", tempfile );
-
-	if( (tempfd = Checkread(tempfile,&statb)) < 0){
-		plp_snprintf(errmsg, errlen,
-			"md5_receive: open '%s' for read failed - %s",
-			tempfile, Errormsg(errno) );
-		goto error;
-	}
-	DEBUG1("md5_receive: doing md5 of file");
-	MDFile( tempfd, filehash);
 	DEBUG1("md5_receive: filehash '%s'", 
 		hexstr( filehash, KEY_LENGTH, buffer, sizeof(buffer) ));
-	close(tempfd); tempfd = -1;
 
 	DEBUGF(DRECV1)("md5_receive: challenge '%s'",
 		hexstr( challenge, KEY_LENGTH, buffer, sizeof(buffer) ));
@@ -687,7 +744,8 @@ static int md5_receive( int *sock, int transfer_timeout,
 
 
 const struct security md5_auth =
-	{ "md5",       "md5",	"md5",      0,              0,           md5_send, 0, md5_receive };
+	{ "md5",       "md5",	"md5",      0,              0,           md5_send, 0, md5_receive,
+		md5_send_stream, 0, 0 };
 
 #ifdef WITHPLUGINS
 plugin_get_func getter_name(md5);
@@ -11,6 +11,7 @@
 #include "fileopen.h"
 #include "errorcodes.h"
 #include "getqueue.h"
+#include "child.h"
 #ifdef SSL_ENABLE
 /* The Kerberos 5 support is MIT-specific. */
 #define OPENSSL_NO_KRB5
@@ -72,6 +73,9 @@ static int SSL_Initialize_ctx(
 	SSL_CTX **ctx_ret,
 	char *errmsg, int errlen );
 static void Destroy_ctx(SSL_CTX *ctx);
+static int Get_ctx( SSL_CTX **ctx_ret, char *errmsg, int errlen );
+static int New_session_callback( SSL *ssl, SSL_SESSION *session );
+static SSL_SESSION *Find_session( const char *host );
 static void Get_cert_info( SSL *ssl, struct line_list *info );
 static int Open_SSL_connection( int sock, SSL_CTX *ctx, SSL **ssl_ret,
 	struct line_list *info, char *errmsg, int errlen );
@@ -194,7 +198,6 @@ static int SSL_Initialize_ctx(
 	char header[SMALLBUFFER];
 	char certbuf[4096], pwbuf[4096]; 
 	struct stat statb;
-	int pid;
 	char *file, *s;
 	int fd = -1, n;
     
@@ -210,34 +213,35 @@ static int SSL_Initialize_ctx(
 		return -1;
 	}
 	mycert = 0;
-	/* get the directory for the SSL certificates */
-	if( ISNULL(Ssl_ca_path_DYN) && !ISNULL(Ssl_ca_file_DYN) ){
-		Set_DYN(&Ssl_ca_path_DYN, Ssl_ca_file_DYN);
-		if( (s = strrchr(Ssl_ca_path_DYN, '/')) ) *s = 0;
-	}
 	cp = certpath = Ssl_ca_path_DYN;
 	cf = certfile = Ssl_ca_file_DYN;
 	if( Is_server ){
 		mycert = Ssl_server_cert_DYN;
 		file = Ssl_server_password_file_DYN;
 		if( file ){
+			/* errors are returned,  as the lpd server itself does this */
 			if( (fd = Checkread( file, &statb )) < 0 ){
-				Errorcode = JABORT;
-				logerr_die(LOG_ERR, "SSL_initialize: cannot open server_password_file '%s'",
-					file );
+				plp_snprintf( errmsg,errlen,
+					"SSL_initialize: cannot open server_password_file '%s' - %s",
+					file, Errormsg(errno) );
+				return -1;
 			}
-			if( (n = ok_read(fd, password_value, sizeof(password_value)-1)) < 0 ){
-				Errorcode = JABORT;
-				logerr_die(LOG_ERR, "SSL_initialize: cannot read server_password_file '%s'",
-					file );
+			n = ok_read(fd, password_value, sizeof(password_value)-1);
+			close(fd); fd = -1;
+			if( n < 0 ){
+				plp_snprintf( errmsg,errlen,
+					"SSL_initialize: cannot read server_password_file '%s' - %s",
+					file, Errormsg(errno) );
+				return -1;
 			}
 			password_value[n] = 0;
 			if( (s = safestrchr(password_value,'\n')) ) *s = 0;
 			n = strlen(password_value);
 			if( n == 0 ){
-				Errorcode = JABORT;
-				logerr_die(LOG_ERR, "SSL_initialize: zero length server_password_file '%s'",
+				plp_snprintf( errmsg,errlen,
+					"SSL_initialize: zero length server_password_file '%s'",
 					file );
+				return -1;
 			}
 		}
 	} else {
@@ -320,15 +324,21 @@ static int SSL_Initialize_ctx(
 
 	/* we set the session id context for the server.
 	 * This has no effect on clients, but appears to be
-	 * harmless.
+	 * harmless.  It is the same in all of the lpd processes
+	 * so that a session can be resumed with any of them.
 	 */
-	pid = getpid();
 	if( !SSL_CTX_set_session_id_context(ctx,
-			(void*)&pid, sizeof pid) ){
+			(void*)"LPRng", 5) ){
 		Set_ERR_str( "SSL_initialize: SSL_CTX_set_session_id_context failed", errmsg, errlen );
 		return(-1);
 	}
 
+	/* clients save their sessions (see New_session_callback),
+	 * servers resume them from session tickets
+	 */
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH);
+	SSL_CTX_sess_set_new_cb(ctx, New_session_callback);
+
 
 #if (OPENSSL_VERSION_NUMBER < 0x00905100L)
     SSL_CTX_set_verify_depth(ctx,1);
@@ -341,6 +351,152 @@ static void Destroy_ctx(SSL_CTX *ctx)
     SSL_CTX_free(ctx);
 }
 
+/*
+ * The SSL context is kept for the life of the process:  making one
+ * loads the CA list and certificate and decrypts the private key,
+ * which costs more than the transfer of a typical job.  The lpd
+ * server makes it before it forks (Ssl_server_init) so all of its
+ * children use the same one,  and with it the same session ticket
+ * key,  so a client can resume its session with whichever child
+ * takes the next connection.  It is made again if the configuration
+ * it was made from changes.
+ */
+
+static SSL_CTX *Ssl_ctx;
+static char *Ssl_ctx_config;
+
+static int Get_ctx( SSL_CTX **ctx_ret, char *errmsg, int errlen )
+{
+	char config[LARGEBUFFER];
+	SSL_CTX *ctx = 0;
+	char *s;
+
+	/* get the directory for the SSL certificates */
+	if( ISNULL(Ssl_ca_path_DYN) && !ISNULL(Ssl_ca_file_DYN) ){
+		Set_DYN(&Ssl_ca_path_DYN, Ssl_ca_file_DYN);
+		if( (s = strrchr(Ssl_ca_path_DYN, '/')) ) *s = 0;
+	}
+	plp_snprintf( config, sizeof(config), "%d %ld %s %s %s %s %s %s",
+		Is_server, (long)getuid(), Ssl_ca_path_DYN, Ssl_ca_file_DYN,
+		Ssl_server_cert_DYN, Ssl_server_password_file_DYN,
+		getenv("LPR_SSL_FILE"), getenv("LPR_SSL_PASSWORD") );
+	if( Ssl_ctx && !safestrcmp( config, Ssl_ctx_config ) ){
+		DEBUG1("Get_ctx: reusing context");
+		*ctx_ret = Ssl_ctx;
+		return 0;
+	}
+	DEBUG1("Get_ctx: new context for '%s'", config );
+	if( SSL_Initialize_ctx( &ctx, errmsg, errlen ) ){
+		if( ctx ) Destroy_ctx( ctx );
+		*ctx_ret = 0;
+		return -1;
+	}
+	if( Ssl_ctx ) Destroy_ctx( Ssl_ctx );
+	if( Ssl_ctx_config ) free( Ssl_ctx_config );
+	Ssl_ctx = ctx;
+	Ssl_ctx_config = safestrdup( config, __FILE__,__LINE__ );
+	*ctx_ret = ctx;
+	return 0;
+}
+
+/*
+ * Client sessions are saved in a file for each host,  in the spool
+ * directory for the lpd server and in ~/.lpr for users,  and offered
+ * to the host on the next connection.  They cannot be kept in memory,
+ * as each job is sent by a new process.
+ */
+
+static char *Session_file( const char *host )
+{
+	char dir[SMALLBUFFER], name[SMALLBUFFER];
+	struct passwd *pw;
+
+	if( ISNULL(host) || strchr(host,'/') ) return( 0 );
+	if( Is_server ){
+		if( ISNULL(Spool_dir_DYN) ) return( 0 );
+		mystrncpy( dir, Spool_dir_DYN, sizeof(dir) );
+	} else if( (pw = getpwuid( getuid() )) ){
+		plp_snprintf( dir, sizeof(dir), "%s/.lpr", pw->pw_dir );
+	} else {
+		return( 0 );
+	}
+	plp_snprintf( name, sizeof(name), "ssl_session.%s", host );
+	return( Make_pathname( dir, name ) );
+}
+
+/*
+ * Find_session - the saved session for the host, which the
+ *  caller must free, or 0
+ */
+
+static SSL_SESSION *Find_session( const char *host )
+{
+	unsigned char buffer[LARGEBUFFER];
+	const unsigned char *p = buffer;
+	SSL_SESSION *session = 0;
+	struct stat statb;
+	char *file;
+	int fd, len;
+
+	if( !(file = Session_file( host )) ) return( 0 );
+	if( (fd = Checkread( file, &statb )) >= 0 ){
+		if( (len = ok_read( fd, (char *)buffer, sizeof(buffer) )) > 0 ){
+			session = d2i_SSL_SESSION( 0, &p, len );
+		}
+		close( fd );
+	}
+	DEBUG1("Find_session: '%s' session %d", file, session != 0 );
+	free( file );
+	return( session );
+}
+
+static int New_session_callback( SSL *ssl, SSL_SESSION *session )
+{
+	unsigned char buffer[LARGEBUFFER], *p = buffer;
+	char *file, *tempfile;
+	char pid[32];
+	struct stat statb;
+	int fd, len;
+
+	if( SSL_is_server( ssl ) ) return( 0 );
+	if( !(file = Session_file( SSL_get_app_data( ssl ) )) ) return( 0 );
+	len = i2d_SSL_SESSION( session, 0 );
+	if( len > 0 && len <= (int)sizeof(buffer) ){
+		len = i2d_SSL_SESSION( session, &p );
+		/* write a new file so readers never see a partial one */
+		plp_snprintf( pid, sizeof(pid), ".%ld", (long)getpid() );
+		tempfile = safestrdup2( file, pid, __FILE__,__LINE__ );
+		if( (fd = Checkwrite( tempfile, &statb, O_WRONLY|O_TRUNC, 1, 0 )) >= 0 ){
+			if( Write_fd_len( fd, (char *)buffer, len ) < 0
+				|| rename( tempfile, file ) ){
+				unlink( tempfile );
+			}
+			close( fd );
+		}
+		DEBUG1("New_session_callback: saved %d bytes in '%s'", len, file );
+		free( tempfile );
+	}
+	free( file );
+	return( 0 );
+}
+
+/*
+ * Ssl_server_init - make the context in the lpd server if it is
+ *  configured for ssl,  so the processes it forks share it
+ */
+
+static void Ssl_server_init( void )
+{
+	char errmsg[SMALLBUFFER];
+	SSL_CTX *ctx;
+
+	if( ISNULL(Ssl_server_cert_DYN) ) return;
+	errmsg[0] = 0;
+	if( Get_ctx( &ctx, errmsg, sizeof(errmsg) ) ){
+		logmsg(LOG_INFO, "Ssl_server_init: %s", errmsg );
+	}
+}
+
 /*
  * get peer certificate information
  */
@@ -410,6 +566,7 @@ static int Open_SSL_connection( int sock, SSL_CTX *ctx, SSL **ssl_ret,
 	char buffer[SMALLBUFFER];
 	int status = 0;
 	X509 *peer;
+	SSL_SESSION *session;
 
 	/* we get the SSL context.  No connection yet */
 	ssl = SSL_new(ctx);
@@ -429,6 +586,13 @@ static int Open_SSL_connection( int sock, SSL_CTX *ctx, SSL **ssl_ret,
 	}
     SSL_set_bio(ssl,bio,bio);
 
+	/* offer the last session we had with the host */
+	SSL_set_app_data( ssl, RemoteHost_DYN );
+	if( (session = Find_session( RemoteHost_DYN )) ){
+		SSL_set_session( ssl, session );
+		SSL_SESSION_free( session );
+	}
+
 	/* if you get any sort of error, give up */
 	ret = SSL_connect( ssl );
 	DEBUG1("Open_SSL_connection: SSL_connect returned %d, SSL_get_error = %d",
@@ -445,6 +609,7 @@ static int Open_SSL_connection( int sock, SSL_CTX *ctx, SSL **ssl_ret,
 			goto done;
 			break;
 	}
+	DEBUG1("Open_SSL_connection: session reused %d", SSL_session_reused(ssl) );
 
 
 	/* now we check to see which server we talked to */
@@ -542,7 +707,10 @@ static int Accept_SSL_connection( int sock, int timeout, SSL_CTX *ctx, SSL **ssl
 		DEBUG1("Accept_SSL_connection: SSL_accept returned %d, SSL_get_error = %d",
 			ret, n  );
 		switch( n ){
-			case SSL_ERROR_NONE: finished = 1; break;
+			case SSL_ERROR_NONE: finished = 1;
+				DEBUG1("Accept_SSL_connection: session reused %d",
+					SSL_session_reused(ssl) );
+				break;
 			case SSL_ERROR_WANT_READ: wait_for_read = 1; break;
 			case SSL_ERROR_WANT_WRITE: wait_for_write = 1; break;
 			default:
@@ -742,9 +910,14 @@ static const char * Error_SSL_name( int i )
 	return(s);
 }
 
-static int Ssl_send( int *sock,
+/*
+ * Ssl_send_stream - send size bytes read from in_fd,  and put the
+ *  reply (or the error message) in the tempfile
+ */
+
+static int Ssl_send_stream( int *sock,
 	int transfer_timeout,
-	char *tempfile,
+	int in_fd, double size, char *tempfile,
 	char *errmsg, int errlen,
 	const struct security *security, struct line_list *info )
 {
@@ -752,7 +925,6 @@ static int Ssl_send( int *sock,
 	struct stat statb;
 	int tempfd = -1, len;
 	int status = 0;
-	double size;
 	SSL_CTX *ctx = 0;
 	SSL *ssl = 0;
 
@@ -761,7 +933,7 @@ static int Ssl_send( int *sock,
 	if(DEBUGL1)Dump_line_list("Ssl_send: info", info );
 	DEBUG1("Ssl_send: sending on socket %d", *sock );
 
-	if( SSL_Initialize_ctx(&ctx, errmsg, errlen ) ){
+	if( Get_ctx(&ctx, errmsg, errlen ) ){
 		status = JFAIL;
 		goto t_error;
 	}
@@ -770,14 +942,6 @@ static int Ssl_send( int *sock,
 		goto t_error;
 	}
 
-	if( (tempfd = Checkread(tempfile,&statb)) < 0){
-		plp_snprintf(errmsg, errlen,
-			"Ssl_send: open '%s' for read failed - %s",
-			tempfile, Errormsg(errno) );
-		status = JABORT;
-		goto t_error;
-	}
-	size = statb.st_size;
 	plp_snprintf(buffer,sizeof(buffer), "%0.0f\n", size );
 	DEBUG1("Ssl_send: writing '%s'", buffer );
 	if( Write_SSL_connection( transfer_timeout, ssl, buffer, strlen(buffer), errmsg, errlen) ){
@@ -786,22 +950,25 @@ static int Ssl_send( int *sock,
 	}
 
 	DEBUG1("Ssl_send: starting send");
-	while( (len = ok_read( tempfd, buffer, sizeof(buffer)-1 )) > 0 ){
+	while( size > 0 ){
+		len = sizeof(buffer)-1;
+		if( len > size ) len = size;
+		if( (len = ok_read( in_fd, buffer, len )) <= 0 ){
+			plp_snprintf(errmsg, errlen,
+				"Ssl_send: read of job failed - %s",
+				len < 0 ? Errormsg(errno) : "unexpected EOF" );
+			status = JFAIL;
+			goto t_error;
+		}
 		buffer[len] = 0;
 		DEBUG4("Ssl_send: file information '%s'", buffer );
 		if( Write_SSL_connection( transfer_timeout, ssl, buffer, len, errmsg, errlen) ){
 			status = JFAIL;
 			goto t_error;
 		}
-	}
-	if( len < 0 ){
-		plp_snprintf(errmsg, errlen,
-			"Ssl_send: read from '%s' failed - %s", tempfile, Errormsg(errno) );
-		status = JFAIL;
-		goto t_error;
+		size -= len;
 	}
 
-	close(tempfd); tempfd = -1;
 	if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0){
 		Errorcode = JABORT;
 		fatal(LOG_ERR,
@@ -843,7 +1010,6 @@ static int Ssl_send( int *sock,
 
  t_error:
 	DEBUG1("Ssl_send: t_error - status %d, errmsg '%s'", status, errmsg);
-	close(tempfd); tempfd = -1;
 	if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0){
 		Errorcode = JFAIL;
 		fatal(LOG_ERR,
@@ -856,6 +1022,7 @@ static int Ssl_send( int *sock,
 	DEBUG1("Ssl_send: error - status %d, errmsg '%s'", status, errmsg);
 	Write_fd_str(tempfd, errmsg );
 	Write_fd_str(tempfd, "\n" );
+	close( tempfd ); tempfd = -1;
 
  done:
 	DEBUG1("Ssl_send: done - status %d, errmsg '%s'", status, errmsg);
@@ -863,24 +1030,65 @@ static int Ssl_send( int *sock,
 		Close_SSL_connection( *sock, ssl );
 	}
 	if( ssl ) SSL_free( ssl );
-	if( ctx ) Destroy_ctx( ctx );
 	return(status);
 }
 
-static int Ssl_receive( int *sock, int transfer_timeout,
+static int Ssl_send( int *sock,
+	int transfer_timeout,
+	char *tempfile,
+	char *errmsg, int errlen,
+	const struct security *security, struct line_list *info )
+{
+	struct stat statb;
+	int tempfd, status;
+
+	if( (tempfd = Checkread(tempfile,&statb)) < 0){
+		plp_snprintf(errmsg, errlen,
+			"Ssl_send: open '%s' for read failed - %s",
+			tempfile, Errormsg(errno) );
+		if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0){
+			Errorcode = JFAIL;
+			fatal(LOG_ERR,
+				"Ssl_send: open '%s' for write failed - %s",
+				tempfile, Errormsg(errno) );
+		}
+		Write_fd_str(tempfd, errmsg );
+		Write_fd_str(tempfd, "\n" );
+		close( tempfd );
+		return( JABORT );
+	}
+	status = Ssl_send_stream( sock, transfer_timeout, tempfd,
+		(double)statb.st_size, tempfile, errmsg, errlen, security, info );
+	close( tempfd );
+	return( status );
+}
+
+/*
+ * Ssl_receive_work
+ *  With do_secure_work the job is read into the tempfile and then
+ *  processed;  with do_stream_work it is written to a pipe that a
+ *  subprocess running do_stream_work reads from.
+ *  Either puts the reply in the tempfile.
+ */
+
+static int Ssl_receive_work( int *sock, int transfer_timeout,
 	char *user, char *jobsize, int from_server, char *authtype,
 	struct line_list *info,
 	char *errmsg, int errlen,
 	struct line_list *header_info,
 	const struct security *security, char *tempfile,
-	SECURE_WORKER_PROC do_secure_work)
+	SECURE_WORKER_PROC do_secure_work,
+	SECURE_STREAM_WORKER_PROC do_stream_work )
 {
-	int tempfd, status, n, len;
+	int tempfd, status, n, len, p[2];
 	char buffer[LARGEBUFFER];
 	struct stat statb;
 	double size;
 	SSL_CTX *ctx = 0;
 	SSL *ssl = 0;
+	plp_status_t procstatus;
+	pid_t pid, result;
+	char *reply;
 
 	DEBUGFC(DRECV1)Dump_line_list("Ssl_receive: info", info );
 	DEBUGFC(DRECV1)Dump_line_list("Ssl_receive: header_info", header_info );
@@ -893,7 +1101,7 @@ static int Ssl_receive( int *sock, int transfer_timeout,
 		goto error;
 	}
 
-	if( SSL_Initialize_ctx(&ctx, errmsg, errlen ) ){
+	if( Get_ctx(&ctx, errmsg, errlen ) ){
 		status = JFAIL;
 		goto error;
 	}
@@ -903,13 +1111,6 @@ static int Ssl_receive( int *sock, int transfer_timeout,
 	}
 	DEBUGFC(DRECV1)Dump_line_list("Ssl_receive: after accept info", header_info );
 
-	/* open a file for the output */
-	if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
-		Errorcode = JFAIL;
-		logerr_die(LOG_INFO, "Ssl_receive: open of '%s' for write failed",
-			tempfile );
-	}
-
 	DEBUGF(DRECV1)("Ssl_receive: getting read size");
 	if( Gets_SSL_connection( transfer_timeout, ssl, buffer, sizeof(buffer), errmsg, errlen) ){
 		status = JFAIL;
@@ -918,31 +1119,97 @@ static int Ssl_receive( int *sock, int transfer_timeout,
 	size = strtod( buffer, 0 );
 	DEBUGF(DRECV1)("Ssl_receive: read size '%s'", buffer );
 
-	while( size > 0 ){
-		len = sizeof(buffer);
-		if( len > size ) len = size;
-		if( Read_SSL_connection( transfer_timeout, ssl, buffer, &len, errmsg, errlen) ){
-			status = JFAIL;
-			goto error;
+	if( do_stream_work ){
+		if( pipe( p ) == -1 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Ssl_receive: pipe failed" );
 		}
-		DEBUGF(DRECV1)("Ssl_receive: rcvd '%d' '%s'", len, buffer );
-		if( write( tempfd,buffer,len ) != len ){
+		/* the child loses the tempfile list, and the name with it */
+		reply = safestrdup( tempfile, __FILE__,__LINE__ );
+		if( (pid = dofork(0)) < 0 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Ssl_receive: fork failed" );
+		} else if( pid == 0 ){
+			close( p[1] );
+			Errorcode = do_stream_work( jobsize, from_server, p[0],
+				reply, header_info );
+			cleanup(0);
+		}
+		free( reply ); reply = 0;
+		close( p[0] );
+		while( size > 0 ){
+			len = sizeof(buffer);
+			if( len > size ) len = size;
+			if( Read_SSL_connection( transfer_timeout, ssl, buffer, &len, errmsg, errlen) ){
+				status = JFAIL;
+				goto error;
+			}
+			DEBUGF(DRECV4)("Ssl_receive: rcvd '%d'", len );
+			/* if the worker gave up, keep reading to stay in step */
+			if( p[1] >= 0 && Write_fd_len( p[1], buffer, len ) < 0 ){
+				DEBUGF(DRECV1)("Ssl_receive: worker closed pipe - %s",
+					Errormsg(errno) );
+				close( p[1] ); p[1] = -1;
+			}
+			size -= len;
+		}
+		if( p[1] >= 0 ) close( p[1] ); p[1] = -1;
+		DEBUGF(DRECV1)("Ssl_receive: end read" );
+		while( (result = plp_waitpid( pid, &procstatus, 0 )) != pid ){
+			if( result == -1 && errno != EINTR ){
+				Errorcode = JFAIL;
+				logerr_die(LOG_INFO, "Ssl_receive: waitpid %ld failed",
+					(long)pid );
+			}
+		}
+		if( WIFEXITED(procstatus) ){
+			status = WEXITSTATUS(procstatus);
+		} else {
 			status = JFAIL;
-			logerr_die(LOG_ERR,
-				"Ssl_receive: bad write to '%s' - '%s'",
-					tempfile, Errormsg(errno) );
+			if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
+				Errorcode = JFAIL;
+				logerr_die(LOG_INFO, "Ssl_receive: open of '%s' for write failed",
+					tempfile );
+			}
+			plp_snprintf( buffer, sizeof(buffer), "job receiver %s\n",
+				Decode_status( &procstatus ) );
+			Write_fd_str( tempfd, buffer );
+			close( tempfd ); tempfd = -1;
+		}
+	} else {
+		/* open a file for the output */
+		if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Ssl_receive: open of '%s' for write failed",
+				tempfile );
 		}
-		size -= len;
-	}
-	close(tempfd); tempfd = -1;
-	DEBUGF(DRECV1)("Ssl_receive: end read" );
 
-	/*** at this point you can check the format of the received file, etc.
-     *** if you have an error message at this point, you should write it
-	 *** to the socket,  and arrange protocol can handle this.
-	 ***/
+		while( size > 0 ){
+			len = sizeof(buffer);
+			if( len > size ) len = size;
+			if( Read_SSL_connection( transfer_timeout, ssl, buffer, &len, errmsg, errlen) ){
+				status = JFAIL;
+				goto error;
+			}
+			DEBUGF(DRECV1)("Ssl_receive: rcvd '%d' '%s'", len, buffer );
+			if( write( tempfd,buffer,len ) != len ){
+				status = JFAIL;
+				logerr_die(LOG_ERR,
+					"Ssl_receive: bad write to '%s' - '%s'",
+						tempfile, Errormsg(errno) );
+			}
+			size -= len;
+		}
+		close(tempfd); tempfd = -1;
+		DEBUGF(DRECV1)("Ssl_receive: end read" );
 
-	status = do_secure_work( jobsize, from_server, tempfile, header_info );
+		/*** at this point you can check the format of the received file, etc.
+		 *** if you have an error message at this point, you should write it
+		 *** to the socket,  and arrange protocol can handle this.
+		 ***/
+
+		status = do_secure_work( jobsize, from_server, tempfile, header_info );
+	}
 
 	/*** if an error message is returned, you should write this
 	 *** message to the tempfile and the proceed to send the contents
@@ -984,8 +1251,35 @@ static int Ssl_receive( int *sock, int transfer_timeout,
 	return(status);
 }
 
+static int Ssl_receive( int *sock, int transfer_timeout,
+	char *user, char *jobsize, int from_server, char *authtype,
+	struct line_list *info,
+	char *errmsg, int errlen,
+	struct line_list *header_info,
+	const struct security *security, char *tempfile,
+	SECURE_WORKER_PROC do_secure_work)
+{
+	return( Ssl_receive_work( sock, transfer_timeout, user, jobsize,
+		from_server, authtype, info, errmsg, errlen, header_info,
+		security, tempfile, do_secure_work, 0 ) );
+}
+
+static int Ssl_receive_stream( int *sock, int transfer_timeout,
+	char *user, char *jobsize, int from_server, char *authtype,
+	struct line_list *info,
+	char *errmsg, int errlen,
+	struct line_list *header_info,
+	const struct security *security, char *tempfile,
+	SECURE_STREAM_WORKER_PROC do_stream_work)
+{
+	return( Ssl_receive_work( sock, transfer_timeout, user, jobsize,
+		from_server, authtype, info, errmsg, errlen, header_info,
+		security, tempfile, 0, do_stream_work ) );
+}
+
 const struct security ssl_auth =
-	{ "ssl",      "ssl",	"ssl",       0,              0,           Ssl_send, 0, Ssl_receive };
+	{ "ssl",      "ssl",	"ssl",       0,              0,           Ssl_send, 0, Ssl_receive,
+		Ssl_send_stream, Ssl_receive_stream, Ssl_server_init };
 
 #ifdef WITHPLUGINS
 plugin_get_func getter_name(ssl);
@@ -103,9 +103,9 @@ static int Test_accept( int *sock, int transfer_timeout,
  *
  **************************************************************/
 
-static int Test_send( int *sock,
+static int Test_send_stream( int *sock,
 	int transfer_timeout,
-	char *tempfile,
+	int in_fd, double size, char *tempfile,
 	char *errmsg, int errlen,
 	const struct security *security UNUSED, struct line_list *info )
 {
@@ -115,16 +115,17 @@ static int Test_send( int *sock,
 	int status = 0;
 
 	if(DEBUGL1)Dump_line_list("Test_send: info", info );
-	DEBUG1("Test_send: sending on socket %d", *sock );
-	if( (tempfd = Checkread(tempfile,&statb)) < 0){
-		plp_snprintf(errmsg, errlen,
-			"Test_send: open '%s' for read failed - %s",
-			tempfile, Errormsg(errno) );
-		status = JABORT;
-		goto error;
-	}
-	DEBUG1("Test_send: starting read");
-	while( (len = Read_fd_len_timeout( transfer_timeout, tempfd, buffer, sizeof(buffer)-1 )) > 0 ){
+	DEBUG1("Test_send: sending %0.0f bytes on socket %d", size, *sock );
+	while( size > 0 ){
+		len = sizeof(buffer)-1;
+		if( len > size ) len = size;
+		if( (len = Read_fd_len_timeout( transfer_timeout, in_fd, buffer, len )) <= 0 ){
+			plp_snprintf(errmsg, errlen,
+				"Test_send: read of job failed - %s",
+				len < 0 ? Errormsg(errno) : "unexpected EOF" );
+			status = JABORT;
+			goto error;
+		}
 		buffer[len] = 0;
 		DEBUG4("Test_send: file information '%s'", buffer );
 		if( write( *sock, buffer, len) != len ){
@@ -133,14 +134,8 @@ static int Test_send( int *sock,
 			status = JABORT;
 			goto error;
 		}
+		size -= len;
 	}
-	if( len < 0 ){
-		plp_snprintf(errmsg, errlen,
-			"Test_send: read from '%s' failed - %s", tempfile, Errormsg(errno) );
-		status = JABORT;
-		goto error;
-	}
-	close(tempfd); tempfd = -1;
 	/* we close the writing side */
 	shutdown( *sock, 1 );
 
@@ -171,17 +166,49 @@ static int Test_send( int *sock,
 	return(status);
 }
 
-static int Test_receive( int *sock, int transfer_timeout,
-	char *user UNUSED, char *jobsize, int from_server, char *authtype UNUSED,
+static int Test_send( int *sock,
+	int transfer_timeout,
+	char *tempfile,
+	char *errmsg, int errlen,
+	const struct security *security, struct line_list *info )
+{
+	struct stat statb;
+	int tempfd, status;
+
+	if( (tempfd = Checkread(tempfile,&statb)) < 0){
+		plp_snprintf(errmsg, errlen,
+			"Test_send: open '%s' for read failed - %s",
+			tempfile, Errormsg(errno) );
+		return( JABORT );
+	}
+	status = Test_send_stream( sock, transfer_timeout, tempfd,
+		(double)statb.st_size, tempfile, errmsg, errlen, security, info );
+	close(tempfd);
+	return( status );
+}
+
+/*
+ * Test_receive_work
+ *  With do_secure_work the job is read into the tempfile and then
+ *  processed;  with do_stream_work it is written to a pipe that a
+ *  subprocess running do_stream_work reads from.
+ */
+
+static int Test_receive_work( int *sock, int transfer_timeout,
+	char *jobsize, int from_server,
 	struct line_list *info,
 	char *errmsg, int errlen,
 	struct line_list *header_info,
-	const struct security *security UNUSED, char *tempfile,
-	SECURE_WORKER_PROC do_secure_work)
+	char *tempfile,
+	SECURE_WORKER_PROC do_secure_work,
+	SECURE_STREAM_WORKER_PROC do_stream_work )
 {
-	int tempfd, status, n;
+	int tempfd, status, n, p[2];
 	char buffer[LARGEBUFFER];
 	struct stat statb;
+	plp_status_t procstatus;
+	pid_t pid, result;
+	char *reply;
 
 	tempfd = -1;
 
@@ -195,8 +222,27 @@ static int Test_receive( int *sock, int transfer_timeout,
 		goto error;
 	}
 
-	/* open a file for the output */
-	if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
+	if( do_stream_work ){
+		if( pipe( p ) == -1 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Test_receive: pipe failed" );
+		}
+		/* the child loses the tempfile list, and the name with it */
+		reply = safestrdup( tempfile, __FILE__,__LINE__ );
+		if( (pid = dofork(0)) < 0 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Test_receive: fork failed" );
+		} else if( pid == 0 ){
+			close( p[1] );
+			Errorcode = do_stream_work( jobsize, from_server, p[0],
+				reply, header_info );
+			cleanup(0);
+		}
+		free( reply ); reply = 0;
+		close( p[0] );
+		tempfd = p[1];
+	} else if( (tempfd = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
+		/* open a file for the output */
 		Errorcode = JFAIL;
 		logerr_die(LOG_INFO, "Test_receive: reopen of '%s' for write failed",
 			tempfile );
@@ -226,7 +272,18 @@ static int Test_receive( int *sock, int transfer_timeout,
 	 *** to the socket,  and arrange protocol can handle this.
 	 ***/
 
-	status = do_secure_work( jobsize, from_server, tempfile, header_info );
+	if( do_stream_work ){
+		while( (result = plp_waitpid( pid, &procstatus, 0 )) != pid ){
+			if( result == -1 && errno != EINTR ){
+				Errorcode = JFAIL;
+				logerr_die(LOG_INFO, "Test_receive: waitpid %ld failed",
+					(long)pid );
+			}
+		}
+		status = WIFEXITED(procstatus) ? WEXITSTATUS(procstatus) : JFAIL;
+	} else {
+		status = do_secure_work( jobsize, from_server, tempfile, header_info );
+	}
 
 	/*** if an error message is returned, you should write this
 	 *** message to the tempfile and the proceed to send the contents
@@ -260,8 +317,33 @@ static int Test_receive( int *sock, int transfer_timeout,
 	return(status);
 }
 
+static int Test_receive( int *sock, int transfer_timeout,
+	char *user UNUSED, char *jobsize, int from_server, char *authtype UNUSED,
+	struct line_list *info,
+	char *errmsg, int errlen,
+	struct line_list *header_info,
+	const struct security *security UNUSED, char *tempfile,
+	SECURE_WORKER_PROC do_secure_work)
+{
+	return( Test_receive_work( sock, transfer_timeout, jobsize, from_server,
+		info, errmsg, errlen, header_info, tempfile, do_secure_work, 0 ) );
+}
+
+static int Test_receive_stream( int *sock, int transfer_timeout,
+	char *user UNUSED, char *jobsize, int from_server, char *authtype UNUSED,
+	struct line_list *info,
+	char *errmsg, int errlen,
+	struct line_list *header_info,
+	const struct security *security UNUSED, char *tempfile,
+	SECURE_STREAM_WORKER_PROC do_stream_work)
+{
+	return( Test_receive_work( sock, transfer_timeout, jobsize, from_server,
+		info, errmsg, errlen, header_info, tempfile, 0, do_stream_work ) );
+}
+
 const struct security test_auth =
-	{ "test",      "test",	"test",     0,              0,           Test_send, 0, Test_receive };
+	{ "test",      "test",	"test",     0,              0,           Test_send, 0, Test_receive,
+		Test_send_stream, Test_receive_stream, 0 };
 
 #ifdef WITHPLUGINS
 plugin_get_func getter_name(test);
@@ -18,6 +18,9 @@
 #include "child.h"
 #include "linksupport.h"
 #include "fileopen.h"
+#include "lockfile.h"
+#include "lpd_worker.h"
+#include "stats.h"
 /**** ENDINCLUDE ****/
 
 /*
@@ -64,10 +67,157 @@
 
 */
 
+/*
+ Accounting journal
+
+  Running the :af filter or connecting to the accounting server for
+  each :as and :ae record costs two process starts or connections for
+  each job.  If accounting_journal is set to a pathname in lpd.conf
+  and the :as or :ae value is a string going to an :af filter or
+  host%port,  the queue server appends a line with the printer name
+  and the record to the journal instead.
+
+  The accounting process started by lpd takes the journal every
+  accounting_journal_interval seconds,  by renaming it to journal.work
+  (through journal.work.new),  and sends the records of each printer to
+  its :af destination with one filter run or connection.  Records that
+  could not be sent stay in journal.work and are tried again;  the
+  journal taken in the next interval is added to them,  so one failing
+  :af does not hold up the others.  The journal is locked while it is
+  appended to or renamed,  and a writer that finds that it was renamed
+  while waiting for the lock opens the new one.
+
+  With :achk the replies are kept for accounting_check_cache seconds,
+  keyed by the printer,  user and accounting name,  in a segment shared
+  by the lpd processes.  A job that finds a reply there journals its
+  start record and uses it.  Otherwise the check is done as before,
+  which also delivers the start record.
+*/
+
+#define ACCOUNTING_CACHE 1024
+#define ACCOUNTING_KEYLEN 128
+
+struct accounting_check {
+	volatile unsigned long writing;	/* odd while the entry is being written */
+	volatile time_t expires;
+	volatile int status;
+	char key[ACCOUNTING_KEYLEN];
+};
+
+static struct accounting_check *Accounting_cache;
+
+void Accounting_init( void )
+{
+	if( Accounting_cache ) return;
+	Accounting_cache = Shared_segment( ACCOUNTING_CACHE * sizeof(Accounting_cache[0]) );
+}
+
+static struct accounting_check *Accounting_check_entry( const char *key )
+{
+	unsigned int h = 0;
+	const char *s;
+
+	if( Accounting_cache == 0 || Accounting_check_cache_DYN <= 0 ) return( 0 );
+	for( s = key; *s; ++s ) h = h * 31 + (unsigned char)*s;
+	return( &Accounting_cache[h % ACCOUNTING_CACHE] );
+}
+
+/*
+ * Accounting_check_get - the cached reply for the key,  or -1
+ */
+
+static int Accounting_check_get( const char *key )
+{
+	struct accounting_check *c;
+	unsigned long w;
+	int status;
+
+	if( (c = Accounting_check_entry( key )) == 0 ) return( -1 );
+	w = c->writing;
+	STATS_SYNC();
+	if( (w & 1) || c->expires < time( (void *)0 ) || strcmp( c->key, key ) ){
+		return( -1 );
+	}
+	status = c->status;
+	STATS_SYNC();
+	if( c->writing != w ) return( -1 );
+	return( status );
+}
+
+static void Accounting_check_put( const char *key, int status )
+{
+	struct accounting_check *c;
+	unsigned long w;
+
+	if( (c = Accounting_check_entry( key )) == 0 ) return;
+	w = c->writing;
+	if( (w & 1) || !STATS_CAS( c->writing, w, w + 1 ) ) return;
+	mystrncpy( c->key, key, sizeof(c->key) );
+	c->status = status;
+	c->expires = time( (void *)0 ) + Accounting_check_cache_DYN;
+	STATS_SYNC();
+	c->writing = w + 2;
+}
+
+/*
+ * Accounting_journaled - the record goes in the journal
+ */
+
+static int Accounting_journaled( char *command )
+{
+	return( cval(Accounting_journal_DYN) == '/'
+		&& cval(command) != '|' && cval(command) != '/'
+		&& ( cval(Accounting_file_DYN) == '|'
+			|| (isalnum(cval(Accounting_file_DYN))
+				&& safestrchr( Accounting_file_DYN, '%' )) ) );
+}
+
+/*
+ * Accounting_journal_write - append 'printer record' to the journal
+ *  returns 0,  or -1 if it cannot be written
+ */
+
+static int Accounting_journal_write( char *record )
+{
+	struct stat statb, pathb;
+	char *line, *s;
+	int fd, n, status = -1;
+
+	line = safestrdup3( Printer_DYN, " ", record,__FILE__,__LINE__);
+	for( s = line; (s = safestrchr( s, '\n' )) && s[1]; ) *s = ' ';
+	for( n = 0; status < 0 && n < 10; ++n ){
+		if( (fd = Checkwrite( Accounting_journal_DYN, &statb, 0, 1, 0 )) < 0 ){
+			logerr( LOG_INFO, "Accounting_journal_write: cannot open '%s'",
+				Accounting_journal_DYN );
+			break;
+		}
+		/* the journal may have been taken while we waited */
+		if( Do_lock( fd, 1 ) < 0 ){
+			logerr( LOG_INFO, "Accounting_journal_write: cannot lock '%s'",
+				Accounting_journal_DYN );
+			close( fd );
+			break;
+		}
+		if( fstat( fd, &statb ) == 0 && stat( Accounting_journal_DYN, &pathb ) == 0
+			&& statb.st_dev == pathb.st_dev && statb.st_ino == pathb.st_ino ){
+			if( (status = Write_fd_str( fd, line )) < 0 ){
+				logerr( LOG_INFO, "Accounting_journal_write: write to '%s' failed",
+					Accounting_journal_DYN );
+				close( fd );
+				break;
+			}
+		}
+		close( fd );
+	}
+	DEBUG2("Accounting_journal_write: '%s' status %d", line, status );
+	free( line );
+	return( status );
+}
+
 int Do_accounting( int end, char *command, struct job *job, int timeout )
 {
-	int n, err, len, tempfd;
-	char msg[SMALLBUFFER];
+	int n, err, len, tempfd, journal;
+	char msg[SMALLBUFFER], key[ACCOUNTING_KEYLEN];
 	char *s, *t;
 	struct line_list args;
 	struct stat statb;
@@ -90,6 +240,34 @@ int Do_accounting( int end, char *command, struct job *job, int timeout )
 
 	tempfd = -1;
 
+	if( (journal = Accounting_journaled( command )) ){
+		err = -1;
+		key[0] = 0;
+		if( end == 0 && Accounting_check_DYN ){
+			if( plp_snprintf( key, sizeof(key), "%s %s %s", Printer_DYN,
+				Find_str_value(&job->info,LOGNAME),
+				Find_str_value(&job->info,ACCNTNAME) ) >= (int)sizeof(key) ){
+				/* a cut off key could match another one,  do not cache */
+				key[0] = 0;
+			} else {
+				err = Accounting_check_get( key );
+			}
+			DEBUG1("Do_accounting: check '%s' cached %d", key, err );
+			if( err >= 0 ){
+				setstatus(job, "accounting check cached, status %s",
+					Server_status(err) );
+			}
+		}
+		if( (end || !Accounting_check_DYN || err >= 0)
+			&& Accounting_journal_write( args.list[0] ) == 0 ){
+			Free_line_list(&args);
+			if( err < 0 ) err = JSUCC;
+			DEBUG2("Do_accounting: journaled, status %s", Server_status(err) );
+			return( err );
+		}
+		err = JSUCC;
+	}
+
 	if( (cval(command) == '|') || (cval(command) == '/') ){
 		if( end == 0 && Accounting_check_DYN ){
 			tempfd = Make_temp_fd( 0 );
@@ -187,9 +365,226 @@ int Do_accounting( int end, char *command, struct job *job, int timeout )
 				err = JABORT;
 			}
 		}
+		if( journal && key[0] && err != JABORT ) Accounting_check_put( key, err );
 	}
 	if( tempfd > 0 ) close(tempfd); tempfd = -1;
 	Free_line_list(&args);
 	DEBUG2("Do_accounting: status %s", Server_status(err) );
 	return( err );
 }
+
+/*
+ * Accounting_send - send the records of a printer to its :af
+ *  returns 0 if they were sent,  or they cannot ever be sent
+ */
+
+static int Accounting_send( char *printer, char *records )
+{
+	char error[SMALLBUFFER];
+	struct stat statb;
+	struct job job;
+	int fd, status = 0;
+
+	Set_DYN(&Printer_DYN,0);
+	if( Setup_printer( printer, error, sizeof(error), 0 ) ){
+		logmsg( LOG_ERR, "Accounting_send: dropping records for '%s' - %s",
+			printer, error );
+		return( 0 );
+	}
+	DEBUG1("Accounting_send: '%s' af '%s'", printer, Accounting_file_DYN );
+	if( ISNULL(Accounting_file_DYN) ){
+		logmsg( LOG_ERR, "Accounting_send: dropping records for '%s' - no af",
+			printer );
+	} else if( cval(Accounting_file_DYN) == '|' ){
+		Init_job(&job);
+		fd = Make_temp_fd( 0 );
+		if( Write_fd_str( fd, records ) < 0 || lseek(fd,0,SEEK_SET) == -1 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Accounting_send: write of tempfile failed" );
+		}
+		status = Filter_file( Send_query_rw_timeout_DYN, fd, -1, "ACCOUNTING_FILTER",
+			Accounting_file_DYN, Filter_options_DYN, &job, 0, 1 );
+		close(fd);
+		/* the process runs until lpd exits */
+		Remove_tempfiles();
+		Free_job(&job);
+		if( status ){
+			logmsg( LOG_ERR, "Accounting_send: '%s' for '%s' failed - %s",
+				Accounting_file_DYN, printer, Server_status(status) );
+		}
+	} else if( isalnum(cval(Accounting_file_DYN))
+		&& safestrchr( Accounting_file_DYN, '%' ) ){
+		error[0] = 0;
+		if( (fd = Link_open( Accounting_file_DYN, Connect_timeout_DYN, 0, 0,
+				error, sizeof(error) )) < 0 ){
+			logmsg( LOG_ERR, "Accounting_send: connection to '%s' failed '%s'",
+				Accounting_file_DYN, error );
+			status = JFAIL;
+		} else {
+			if( Write_fd_str( fd, records ) < 0 ){
+				logerr( LOG_INFO, "Accounting_send: write to '%s' failed",
+					Accounting_file_DYN );
+				status = JFAIL;
+			}
+			shutdown(fd,1);
+			close(fd);
+		}
+	} else if( (fd = Checkwrite( Accounting_file_DYN, &statb, 0, Create_files_DYN, 0 )) >= 0 ){
+		/* the queue was changed to use a file */
+		if( Write_fd_str( fd, records ) < 0 ){
+			logerr( LOG_INFO, "Accounting_send: write to '%s' failed",
+				Accounting_file_DYN );
+			status = JFAIL;
+		}
+		close(fd);
+	}
+	return( status );
+}
+
+/*
+ * Accounting_deliver - take the journal and send the records in it
+ */
+
+static void Accounting_deliver( const char *work )
+{
+	struct line_list lines, printers, keep;
+	struct stat statb;
+	char buffer[LARGEBUFFER];
+	char *image = 0, *records = 0, *s, *tempfile, *taken;
+	int fd, out, i, j, n, len = 0, max = 0, rlen = 0, rmax = 0;
+
+	/* take the journal every time,  even if some records in the work
+	 * file are still waiting for a printer whose :af is failing */
+	taken = safestrdup2( work, ".new",__FILE__,__LINE__);
+	if( stat( taken, &statb ) < 0
+		&& (fd = Checkread( Accounting_journal_DYN, &statb )) >= 0 ){
+		/* we get the lock so nobody is in the middle of a record */
+		if( statb.st_size > 0 ){
+			if( Do_lock( fd, 1 ) < 0 ){
+				logerr( LOG_INFO, "Accounting_deliver: cannot lock '%s'",
+					Accounting_journal_DYN );
+			} else if( rename( Accounting_journal_DYN, taken ) == -1 ){
+				logerr( LOG_INFO, "Accounting_deliver: rename '%s' to '%s' failed",
+					Accounting_journal_DYN, taken );
+			}
+		}
+		close(fd);
+	}
+	if( stat( taken, &statb ) == 0 ){
+		if( stat( work, &statb ) < 0 ){
+			if( rename( taken, work ) == -1 ){
+				logerr( LOG_INFO, "Accounting_deliver: rename '%s' to '%s' failed",
+					taken, work );
+			}
+		} else if( (fd = Checkread( taken, &statb )) >= 0 ){
+			/* add the new records to the ones that are waiting */
+			if( (out = Checkwrite( work, &statb, 0, 1, 0 )) < 0 ){
+				logerr( LOG_INFO, "Accounting_deliver: cannot open '%s'", work );
+			} else {
+				while( (n = ok_read( fd, buffer, sizeof(buffer) )) > 0
+					&& Write_fd_len( out, buffer, n ) >= 0 );
+				if( n != 0 ){
+					logerr( LOG_INFO, "Accounting_deliver: copy of '%s' to '%s' failed",
+						taken, work );
+					/* it is copied again the next time */
+					if( ftruncate( out, statb.st_size ) == -1 ){
+						logerr( LOG_INFO, "Accounting_deliver: truncate '%s' failed", work );
+					}
+				} else {
+					unlink( taken );
+				}
+				close(out);
+			}
+			close(fd);
+		}
+	}
+	free( taken );
+	if( (fd = Checkread( work, &statb )) < 0 ) return;
+	Init_buf( &image, &max, &len );
+	while( (n = ok_read( fd, buffer, sizeof(buffer) )) > 0 ){
+		Put_buf_len( buffer, n, &image, &max, &len );
+	}
+	close(fd);
+
+	Init_line_list(&lines);
+	Init_line_list(&printers);
+	Init_line_list(&keep);
+	Split(&lines,image,"\n",0,0,0,0,0,0);
+	for( i = 0; i < lines.count; ++i ){
+		if( (s = safestrchr( lines.list[i], ' ' )) ){
+			*s = 0;
+			Add_line_list(&printers,lines.list[i],0,1,1);
+			*s = ' ';
+		}
+	}
+	DEBUG1("Accounting_deliver: %d records, %d printers", lines.count, printers.count );
+	for( i = 0; i < printers.count; ++i ){
+		n = safestrlen( printers.list[i] );
+		Init_buf( &records, &rmax, &rlen );
+		for( j = 0; j < lines.count; ++j ){
+			s = lines.list[j];
+			if( !strncmp( s, printers.list[i], n ) && s[n] == ' ' ){
+				Put_buf_str( s+n+1, &records, &rmax, &rlen );
+				Put_buf_str( "\n", &records, &rmax, &rlen );
+			}
+		}
+		if( Accounting_send( printers.list[i], records ) ){
+			for( j = 0; j < lines.count; ++j ){
+				s = lines.list[j];
+				if( !strncmp( s, printers.list[i], n ) && s[n] == ' ' ){
+					Add_line_list(&keep,s,0,0,0);
+				}
+			}
+		}
+	}
+	Set_DYN(&Printer_DYN,0);
+
+	if( keep.count == 0 ){
+		unlink( work );
+	} else {
+		/* keep the ones that were not sent for the next time */
+		tempfile = safestrdup2( work, ".tmp",__FILE__,__LINE__);
+		if( (fd = Checkwrite( tempfile, &statb, 0, 1, 0 )) < 0
+			|| ftruncate( fd, 0 ) == -1 ){
+			logerr( LOG_INFO, "Accounting_deliver: cannot open '%s'", tempfile );
+		} else {
+			for( j = 0; j < keep.count; ++j ){
+				if( Write_fd_str( fd, keep.list[j] ) < 0
+					|| Write_fd_str( fd, "\n" ) < 0 ){
+					logerr( LOG_INFO, "Accounting_deliver: write '%s' failed", tempfile );
+					break;
+				}
+			}
+			if( j == keep.count && rename( tempfile, work ) == -1 ){
+				logerr( LOG_INFO, "Accounting_deliver: rename '%s' failed", tempfile );
+			}
+		}
+		if( fd >= 0 ) close(fd);
+		free( tempfile );
+	}
+	Free_line_list(&lines);
+	Free_line_list(&printers);
+	Free_line_list(&keep);
+	if( image ) free( image );
+	if( records ) free( records );
+}
+
+/*
+ * Accounting process - started by lpd when accounting_journal is set.
+ */
+
+static void Accounting_flush( void )
+{
+	static char *work;
+
+	if( !work ){
+		work = safestrdup2( Accounting_journal_DYN, ".work",__FILE__,__LINE__);
+	}
+	Accounting_deliver( work );
+}
+
+pid_t Start_accounting( void )
+{
+	return( Start_periodic( "ACCOUNTING", Accounting_flush,
+		Accounting_journal_interval_DYN ) );
+}
@@ -0,0 +1,1378 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include <config.h>
+#include "portable.h"
+#include "banner.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Banner page layout and big letters
+ *  Used by the lpbanner filter and by lpd for the built in banner
+ *  (bp=builtin).  Only portable.h is used, so that lpbanner can be
+ *  linked without the rest of the LPRng library.
+ */
+
+#define GLYPHSIZE 15
+struct glyph{
+	int ch, x, y;	/* baseline location relative to x and y position */
+	char bits[GLYPHSIZE];
+};
+
+struct font{
+	int height;	/* height from top to bottom */
+	int width;	/* width in pixels */
+	int above;	/* max height above baseline */
+	const struct glyph *glyph;	/* glyphs */
+};
+
+/***************************************************************************
+Commentary
+Patrick Powell Wed Jun  7 19:42:01 PDT 1995
+
+The font information is provided as entries in a data structure.
+
+The struct font{} entry specifies the character heights and widths,
+as well as the number of lines needed to display the characters.
+The struct glyph{} array is the set of glyphs for each character.
+
+    
+	{ 
+	X__11___,
+	X__11___,
+	X__11___,
+	X__11___,
+	X__11___,
+	X_______,
+	X_______,
+	X__11___,
+	cX_11___},			/ * ! * /
+
+     ^ lower left corner, i.e. - on baseline - x = 0, y = 8
+
+	{
+	X_______,
+	X_______,
+	X_______,
+	X_111_1_,
+	X1___11_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	cX111_1_,
+	X_____1_,
+	X1____1_,
+	X_1111__},			/ * g * /
+
+     ^ lower left corner, i.e. - on baseline - x = 0, y = 8
+
+ ***************************************************************************/
+
+#define X_______ 0
+#define X______1 01
+#define X_____1_ 02
+#define X____1__ 04
+#define X____11_ 06
+#define X___1___ 010
+#define X___1__1 011
+#define X___1_1_ 012
+#define X___11__ 014
+#define X__1____ 020
+#define X__1__1_ 022
+#define X__1_1__ 024
+#define X__11___ 030
+#define X__111__ 034
+#define X__111_1 035
+#define X__1111_ 036
+#define X__11111 037
+#define X_1_____ 040
+#define X_1____1 041
+#define X_1___1_ 042
+#define X_1__1__ 044
+#define X_1_1___ 050
+#define X_1_1__1 051
+#define X_1_1_1_ 052
+#define X_11____ 060
+#define X_11_11_ 066
+#define X_111___ 070
+#define X_111__1 071
+#define X_111_1_ 072
+#define X_1111__ 074
+#define X_1111_1 075
+#define X_11111_ 076
+#define X_111111 077
+#define X1______ 0100
+#define X1_____1 0101
+#define X1____1_ 0102
+#define X1____11 0103
+#define X1___1__ 0104
+#define X1___1_1 0105
+#define X1___11_ 0106
+#define X1__1___ 0110
+#define X1__1__1 0111
+#define X1__11_1 0115
+#define X1__1111 0117
+#define X1_1____ 0120
+#define X1_1___1 0121
+#define X1_1_1_1 0125
+#define X1_1_11_ 0126
+#define X1_111__ 0134
+#define X1_1111_ 0136
+#define X11____1 0141
+#define X11___1_ 0142
+#define X11___11 0143
+#define X11_1___ 0150
+#define X11_1__1 0151
+#define X111_11_ 0166
+#define X1111___ 0170
+#define X11111__ 0174
+#define X111111_ 0176
+#define X1111111 0177
+
+static const struct glyph g9x8[] = {
+	{ ' ', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* */
+
+	{ '!', 0, 8, {
+	X__11___,
+	X__11___,
+	X__11___,
+	X__11___,
+	X__11___,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___}},			/* ! */
+
+	{ '"', 0, 8, {
+	X_1__1__,
+	X_1__1__,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* " */
+
+	{ '#', 0, 8, {
+	X_______,
+	X__1_1__,
+	X__1_1__,
+	X1111111,
+	X__1_1__,
+	X1111111,
+	X__1_1__,
+	X__1_1__,
+	X_______}},			/* # */
+
+	{ '$', 0, 8, {
+	X___1___,
+	X_11111_,
+	X1__1__1,
+	X1__1___,
+	X_11111_,
+	X___1__1,
+	X1__1__1,
+	X_11111_,
+	X___1___}},			/* $ */
+
+	{ '%', 0, 8, {
+	X_1_____,
+	X1_1___1,
+	X_1___1_,
+	X____1__,
+	X___1___,
+	X__1____,
+	X_1___1_,
+	X1___1_1,
+	X_____1_}},			/* % */
+
+	{ '&', 0, 8, {
+	X_11____,
+	X1__1___,
+	X1___1__,
+	X_1_1___,
+	X__1____,
+	X_1_1__1,
+	X1___11_,
+	X1___11_,
+	X_111__1}},			/* & */
+
+	{ '\'', 0, 8, {
+	X___11__,
+	X___11__,
+	X___1___,
+	X__1____,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* ' */
+
+	{ '(', 0, 8, {
+	X____1__,
+	X___1___,
+	X__1____,
+	X__1____,
+	X__1____,
+	X__1____,
+	X__1____,
+	X___1___,
+	X____1__}},			/* ( */
+
+	{ ')', 0, 8, {
+	X__1____,
+	X___1___,
+	X____1__,
+	X____1__,
+	X____1__,
+	X____1__,
+	X____1__,
+	X___1___,
+	X__1____}},			/* ) */
+
+	{ '*', 0, 8, {
+	X_______,
+	X___1___,
+	X1__1__1,
+	X_1_1_1_,
+	X__111__,
+	X_1_1_1_,
+	X1__1__1,
+	X___1___,
+	X_______}},			/* * */
+
+	{ '+', 0, 8, {
+	X_______,
+	X___1___,
+	X___1___,
+	X___1___,
+	X1111111,
+	X___1___,
+	X___1___,
+	X___1___,
+	X_______}},			/* + */
+
+	{ ',', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___,
+	X__1____,
+	X_1_____,
+	X_______}},			/* , */
+
+	{ '-', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X1111111,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* - */
+
+	{ '.', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___}},			/* . */
+
+	{ '/', 0, 8, {
+	X_______,
+	X______1,
+	X_____1_,
+	X____1__,
+	X___1___,
+	X__1____,
+	X_1_____,
+	X1______,
+	X_______}},			/* / */
+
+	{ '0', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X1____11,
+	X1___1_1,
+	X1__1__1,
+	X1_1___1,
+	X11____1,
+	X1_____1,
+	X_11111_}},			/* 0 */
+
+	{ '1', 0, 8, {
+	X___1___,
+	X__11___,
+	X_1_1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X_11111_}},			/* 1 */
+
+	{ '2', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X______1,
+	X_____1_,
+	X__111__,
+	X_1_____,
+	X1______,
+	X1______,
+	X1111111}},			/* 2 */
+
+	{ '3', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X______1,
+	X______1,
+	X__1111_,
+	X______1,
+	X______1,
+	X1_____1,
+	X_11111_}},			/* 3 */
+
+	{ '4', 0, 8, {
+	X_____1_,
+	X____11_,
+	X___1_1_,
+	X__1__1_,
+	X_1___1_,
+	X1____1_,
+	X1111111,
+	X_____1_,
+	X_____1_}},			/* 4 */
+
+	{ '5', 0, 8, {
+	X1111111,
+	X1______,
+	X1______,
+	X11111__,
+	X_____1_,
+	X______1,
+	X______1,
+	X1____1_,
+	X_1111__}},			/* 5 */
+
+	{ '6', 0, 8, {
+	X__1111_,
+	X_1_____,
+	X1______,
+	X1______,
+	X1_1111_,
+	X11____1,
+	X1_____1,
+	X1_____1,
+	X_11111_}},			/* 6 */
+
+	{ '7', 0, 8, {
+	X1111111,
+	X1_____1,
+	X_____1_,
+	X____1__,
+	X___1___,
+	X__1____,
+	X__1____,
+	X__1____,
+	X__1____}},			/* 7 */
+
+	{ '8', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_11111_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_11111_}},			/* 8 */
+
+	{ '9', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_111111,
+	X______1,
+	X______1,
+	X1_____1,
+	X_1111__}},			/* 9 */
+
+	{ ':', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___}},			/* : */
+
+
+	{ ';', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___,
+	X_______,
+	X_______,
+	X__11___,
+	X__11___,
+	X__1____,
+	X_1_____}},			/* ; */
+
+	{ '<', 0, 8, {
+	X____1__,
+	X___1___,
+	X__1____,
+	X_1_____,
+	X1______,
+	X_1_____,
+	X__1____,
+	X___1___,
+	X____1__}},			/* < */
+
+	{ '=', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1111111,
+	X_______,
+	X1111111,
+	X_______,
+	X_______,
+	X_______}},			/* = */
+
+	{ '>', 0, 8, {
+	X__1____,
+	X___1___,
+	X____1__,
+	X_____1_,
+	X______1,
+	X_____1_,
+	X____1__,
+	X___1___,
+	X__1____}},			/* > */
+
+	{ '?', 0, 8, {
+	X__1111_,
+	X_1____1,
+	X_1____1,
+	X______1,
+	X____11_,
+	X___1___,
+	X___1___,
+	X_______,
+	X___1___}},			/* ? */
+
+	{ '@', 0, 8, {
+	X__1111_,
+	X_1____1,
+	X1__11_1,
+	X1_1_1_1,
+	X1_1_1_1,
+	X1_1111_,
+	X1______,
+	X_1____1,
+	X__1111_}},			/* @ */
+
+	{ 'A', 0, 8, {
+	X__111__,
+	X_1___1_,
+	X1_____1,
+	X1_____1,
+	X1111111,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1}},			/* A */
+
+	{ 'B', 0, 8, {
+	X111111_,
+	X_1____1,
+	X_1____1,
+	X_1____1,
+	X_11111_,
+	X_1____1,
+	X_1____1,
+	X_1____1,
+	X111111_}},			/* B */
+
+	{ 'C', 0, 8, {
+	X__1111_,
+	X_1____1,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X_1____1,
+	X__1111_}},			/* C */
+
+	{ 'D', 0, 8, {
+	X11111__,
+	X_1___1_,
+	X_1____1,
+	X_1____1,
+	X_1____1,
+	X_1____1,
+	X_1____1,
+	X_1___1_,
+	X11111__}},			/* D */
+
+	{ 'E', 0, 8, {
+	X1111111,
+	X1______,
+	X1______,
+	X1______,
+	X111111_,
+	X1______,
+	X1______,
+	X1______,
+	X1111111}},			/* E */
+
+	{ 'F', 0, 8, {
+	X1111111,
+	X1______,
+	X1______,
+	X1______,
+	X111111_,
+	X1______,
+	X1______,
+	X1______,
+	X1______}},			/* F */
+
+	{ 'G', 0, 8, {
+	X__1111_,
+	X_1____1,
+	X1______,
+	X1______,
+	X1______,
+	X1__1111,
+	X1_____1,
+	X_1____1,
+	X__1111_}},			/* G */
+
+	{ 'H', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1111111,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1}},			/* H */
+
+	{ 'I', 0, 8, {
+	X_11111_,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X_11111_}},			/* I */
+
+	{ 'J', 0, 8, {
+	X__11111,
+	X____1__,
+	X____1__,
+	X____1__,
+	X____1__,
+	X____1__,
+	X____1__,
+	X1___1__,
+	X_111___}},			/* J */
+
+	{ 'K', 0, 8, {
+	X1_____1,
+	X1____1_,
+	X1___1__,
+	X1__1___,
+	X1_1____,
+	X11_1___,
+	X1___1__,
+	X1____1_,
+	X1_____1}},			/* K */
+
+	{ 'L', 0, 8, {
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1______,
+	X1111111}},			/* L */
+
+	{ 'M', 0, 8, {
+	X1_____1,
+	X11___11,
+	X1_1_1_1,
+	X1__1__1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1}},			/* M */
+
+	{ 'N', 0, 8, {
+	X1_____1,
+	X11____1,
+	X1_1___1,
+	X1__1__1,
+	X1___1_1,
+	X1____11,
+	X1_____1,
+	X1_____1,
+	X1_____1}},			/* N */
+
+	{ 'O', 0, 8, {
+	X__111__,
+	X_1___1_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_1___1_,
+	X__111__}},			/* O */
+
+	{ 'P', 0, 8, {
+	X111111_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X111111_,
+	X1______,
+	X1______,
+	X1______,
+	X1______}},			/* P */
+
+	{ 'Q', 0, 8, {
+	X__111__,
+	X_1___1_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1__1__1,
+	X1___1_1,
+	X_1___1_,
+	X__111_1}},			/* Q */
+
+	{ 'R', 0, 8, {
+	X111111_,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X111111_,
+	X1__1___,
+	X1___1__,
+	X1____1_,
+	X1_____1}},			/* R */
+
+	{ 'S', 0, 8, {
+	X_11111_,
+	X1_____1,
+	X1______,
+	X1______,
+	X_11111_,
+	X______1,
+	X______1,
+	X1_____1,
+	X_11111_}},			/* S */
+
+	{ 'T', 0, 8, {
+	X1111111,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___}},			/* T */
+
+	{ 'U', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_11111_}},			/* U */
+
+	{ 'V', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_1___1_,
+	X_1___1_,
+	X__1_1__,
+	X__1_1__,
+	X___1___,
+	X___1___}},			/* V */
+
+	{ 'W', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X1__1__1,
+	X1__1__1,
+	X1_1_1_1,
+	X11___11,
+	X1_____1}},			/* W */
+
+	{ 'X', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X_1___1_,
+	X__1_1__,
+	X___1___,
+	X__1_1__,
+	X_1___1_,
+	X1_____1,
+	X1_____1}},			/* X */
+
+	{ 'Y', 0, 8, {
+	X1_____1,
+	X1_____1,
+	X_1___1_,
+	X__1_1__,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___}},			/* Y */
+
+	{ 'Z', 0, 8, {
+	X1111111,
+	X______1,
+	X_____1_,
+	X____1__,
+	X___1___,
+	X__1____,
+	X_1_____,
+	X1______,
+	X1111111}},			/* Z */
+
+	{ '[', 0, 8, {
+	X_1111__,
+	X_1_____,
+	X_1_____,
+	X_1_____,
+	X_1_____,
+	X_1_____,
+	X_1_____,
+	X_1_____,
+	X_1111__}},			/* [ */
+
+	{ '\\', 0, 8, {
+	X_______,
+	X1______,
+	X_1_____,
+	X__1____,
+	X___1___,
+	X____1__,
+	X_____1_,
+	X______1,
+	X_______}},			/* \ */
+
+	{ ']', 0, 8, {
+	X__1111_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X__1111_}},			/* ] */
+
+	{ '^', 0, 8, {
+	X___1___,
+	X__1_1__,
+	X_1___1_,
+	X1_____1,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* ^ */
+
+	{ '_', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X1111111,
+	X_______}},			/* _ */
+
+	{ '`', 0, 8, {
+	X__11___,
+	X__11___,
+	X___1___,
+	X____1__,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* ` */
+
+	{ 'a', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_1111__,
+	X_____1_,
+	X_11111_,
+	X1_____1,
+	X1____11,
+	X_1111_1}},			/* a */
+
+	{ 'b', 0, 8, {
+	X1______,
+	X1______,
+	X1______,
+	X1_111__,
+	X11___1_,
+	X1_____1,
+	X1_____1,
+	X11___1_,
+	X1_111__}},			/* b */
+
+	{ 'c', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_1111__,
+	X1____1_,
+	X1______,
+	X1______,
+	X1____1_,
+	X_1111__}},			/* c */
+
+	{ 'd', 0, 8, {
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_111_1_,
+	X1___11_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	X_111_1_}},			/* d */
+
+	{ 'e', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_1111__,
+	X1____1_,
+	X111111_,
+	X1______,
+	X1____1_,
+	X_1111__}},			/* e */
+
+	{ 'f', 0, 8, {
+	X___11__,
+	X__1__1_,
+	X__1____,
+	X__1____,
+	X11111__,
+	X__1____,
+	X__1____,
+	X__1____,
+	X__1____}},			/* f */
+
+	{ 'g', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_111_1_,
+	X1___11_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	X_111_1_,
+	X_____1_,
+	X1____1_,
+	X_1111__}},			/* g */
+
+	{ 'h', 0, 8, {
+	X1______,
+	X1______,
+	X1______,
+	X1_111__,
+	X11___1_,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1____1_}},			/* h */
+
+	{ 'i', 0, 8, {
+	X_______,
+	X___1___,
+	X_______,
+	X__11___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X__111__}},			/* i */
+
+	{ 'j', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X____11_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_____1_,
+	X_1___1_,
+	X__111__}},			/* j */
+
+	{ 'k', 0, 8, {
+	X1______,
+	X1______,
+	X1______,
+	X1___1__,
+	X1__1___,
+	X1_1____,
+	X11_1___,
+	X1___1__,
+	X1____1_}},			/* k */
+
+	{ 'l', 0, 8, {
+	X__11___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X__111__}},			/* l */
+
+	{ 'm', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_1_11_,
+	X11_1__1,
+	X1__1__1,
+	X1__1__1,
+	X1__1__1,
+	X1__1__1}},			/* m */
+
+	{ 'n', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_111__,
+	X11___1_,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1____1_}},			/* n */
+
+	{ 'o', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_1111__,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X_1111__}},			/* o */
+
+
+	{ 'p', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_111__,
+	X11___1_,
+	X1____1_,
+	X1____1_,
+	X11___1_,
+	X1_111__,
+	X1______,
+	X1______,
+	X1______}},			/* p */
+
+	{ 'q', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_111_1_,
+	X1___11_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	X_111_1_,
+	X_____1_,
+	X_____1_,
+	X_____1_}},			/* q */
+
+	{ 'r', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_111__,
+	X11___1_,
+	X1______,
+	X1______,
+	X1______,
+	X1______}},			/* r */
+
+	{ 's', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X_1111__,
+	X1____1_,
+	X_11____,
+	X___11__,
+	X1____1_,
+	X_1111__}},			/* s */
+
+	{ 't', 0, 8, {
+	X_______,
+	X__1____,
+	X__1____,
+	X11111__,
+	X__1____,
+	X__1____,
+	X__1____,
+	X__1__1_,
+	X___11__}},			/* t */
+
+	{ 'u', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	X_111_1_}},			/* u */
+
+	{ 'v', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_____1,
+	X1_____1,
+	X1_____1,
+	X_1___1_,
+	X__1_1__,
+	X___1___}},			/* v */
+
+	{ 'w', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1_____1,
+	X1__1__1,
+	X1__1__1,
+	X1__1__1,
+	X1__1__1,
+	X_11_11_}},			/* w */
+
+	{ 'x', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1____1_,
+	X_1__1__,
+	X__11___,
+	X__11___,
+	X_1__1__,
+	X1____1_}},			/* x */
+
+	{ 'y', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1____1_,
+	X1___11_,
+	X_111_1_,
+	X_____1_,
+	X1____1_,
+	X_1111__}},			/* y */
+
+	{ 'z', 0, 8, {
+	X_______,
+	X_______,
+	X_______,
+	X111111_,
+	X____1__,
+	X___1___,
+	X__1____,
+	X_1_____,
+	X111111_}},			/* z */
+
+	{ '}', 0, 8, {
+	X___11__,
+	X__1____,
+	X__1____,
+	X__1____,
+	X_1_____,
+	X__1____,
+	X__1____,
+	X__1____,
+	X___11__}},			/* } */
+
+	{ '|', 0, 8, {
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___,
+	X___1___}},			/* | */
+
+	{ '}', 0, 8, {
+	X__11___,
+	X____1__,
+	X____1__,
+	X____1__,
+	X_____1_,
+	X____1__,
+	X____1__,
+	X____1__,
+	X__11___}},			/* } */
+
+	{ '~', 0, 8, {
+	X_11____,
+	X1__1__1,
+	X____11_,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______,
+	X_______}},			/* ~ */
+
+	{ 'X', 0, 8, {
+	X_1__1__,
+	X1__1__1,
+	X__1__1_,
+	X_1__1__,
+	X1__1__1,
+	X__1__1_,
+	X_1__1__,
+	X1__1__1,
+	X__1__1_}}			/* rub-out */
+};
+
+/*
+  9 by 8 font:
+  12 rows high, 8 cols wide, 9 lines above baseline
+ */
+static const struct font Font9x8 = {
+	12, 8, 9, g9x8 
+};
+
+/*
+ * The rows of each glyph are turned into 'X' and ' ' characters once,
+ *  and a line of big letters is then made by copying them.
+ */
+
+#define BANNER_CHARS 96		/* ' ' to rub-out */
+#define BANNER_HEIGHT 12
+#define BANNER_WIDTH 8
+#define BANNER_LINE 1024
+
+static char Rows[BANNER_CHARS][BANNER_HEIGHT][BANNER_WIDTH];
+static int Rows_done;
+
+static void Render_rows( const struct font *font )
+{
+	int c, line, chars, i, j, k;
+	const char *s;
+	char *str;
+
+	chars = (font->width+7)/8;	/* bytes in a row */
+	for( c = 0; c < BANNER_CHARS; ++c ){
+		for( line = 0; line < font->height; ++line ){
+			str = Rows[c][line];
+			memset( str, ' ', BANNER_WIDTH );
+			s = &font->glyph[c].bits[line*chars];	/* get start of row */
+			for( k = 0, i = 0; k < font->width && i < chars; ++i ){
+				for( j = 7; k < font->width && j >= 0; ++k, --j ){
+					if( *s & (1<<j) ) str[k] = 'X';
+				}
+				++s;
+			}
+		}
+	}
+	Rows_done = 1;
+}
+
+static void Out_line( char *line, int len, BANNER_OUT out, void *arg )
+{
+	line[len] = '\n';
+	out( line, len+1, arg );
+}
+
+static void Break_line( char *line, int width, int c, BANNER_OUT out, void *arg )
+{
+	int len = 0;
+
+	if( c ){
+		memset( line, c, width );
+		len = width;
+	}
+	Out_line( line, len, out, arg );
+}
+
+/*
+ * Big_line - print the string in big letters,  followed by a blank line
+ *  Characters outside the font are printed as blanks.
+ */
+
+static void Big_line( char *line, int width, const char *str,
+	BANNER_OUT out, void *arg )
+{
+	int i, j, k, c, n, len;
+
+	len = strlen( str );
+	for( i = 0; i < Font9x8.height; ++i ){
+		memset( line, ' ', width );
+		for( j = 0, k = 0; j < width && k < len; j += Font9x8.width, ++k ){
+			c = ((unsigned char *)str)[k];
+			c = (c >= ' ' && c - ' ' < BANNER_CHARS) ? c - ' ' : 0;
+			n = width - j;
+			if( n > Font9x8.width ) n = Font9x8.width;
+			memcpy( line+j, Rows[c][i], n );
+		}
+		Out_line( line, width, out, arg );
+	}
+	Out_line( line, 0, out, arg );
+}
+
+/*
+ * Banner_page - lay out the banner page
+ *
+ *  topbreak, top separator, the big strings, the info lines,
+ *  bottom separator, bottom break.  Empty big strings are skipped,
+ *  and the ones that do not fit on the page are dropped from the end.
+ *  The page is padded to length lines when there is room.
+ */
+
+void Banner_page( int width, int length, const char **big, int bigcount,
+	const char **info, int infocount, BANNER_OUT out, void *arg )
+{
+	char line[BANNER_LINE];
+	int len, i, n, shown, breaksize = 3,
+		top_break, top_sep = 0, bottom_sep = 0, bottom_break;
+
+	if( !Rows_done ) Render_rows( &Font9x8 );
+	if( width < 0 ) width = 0;
+	if( width > BANNER_LINE - 2 ) width = BANNER_LINE - 2;
+
+	/* now calculate the numbers of lines available */
+	len = length - infocount;
+	/* now we add a top break and bottom break */
+	if( len > 2*breaksize ){
+		top_break = breaksize;
+		bottom_break = breaksize;
+	}  else {
+		top_break = 1;
+		bottom_break = 1;
+	}
+	len -= (top_break + bottom_break);
+
+	/* see if we can do big letters */
+	shown = 0;
+	for( i = 0; i < bigcount; ++i ){
+		if( big[i] && *big[i] && len > Font9x8.height ){
+			len -= Font9x8.height+1;
+			++shown;
+		}
+	}
+
+	/* now we see how much space we have left */
+	while( length > 0 && len < 0 ){
+		len += length;
+	}
+	if( len > 0 ){
+		/* check to see if we make breaks a little larger */
+		if( len > 16 ){
+			top_break += 3;
+			bottom_break += 3;
+			len -= 6;
+		}
+		top_sep = len/2;
+		bottom_sep = len - top_sep;
+	}
+
+	for( i = 0; i < top_break; ++i ) Break_line( line, width, '*', out, arg );
+	for( i = 0; i < top_sep; ++i ) Break_line( line, width, 0, out, arg );
+	for( i = 0; shown > 0 && i < bigcount; ++i ){
+		if( big[i] && *big[i] ){
+			Big_line( line, width, big[i], out, arg );
+			--shown;
+		}
+	}
+	for( i = 0; i < infocount; ++i ){
+		n = info[i] ? strlen( info[i] ) : 0;
+		if( n > width ) n = width;
+		if( n ) memcpy( line, info[i], n );
+		Out_line( line, n, out, arg );
+	}
+	for( i = 0; i < bottom_sep; ++i ) Break_line( line, width, 0, out, arg );
+	for( i = 0; i < bottom_break; ++i ) Break_line( line, width, '*', out, arg );
+}
@@ -0,0 +1,620 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "child.h"
+#include "fileopen.h"
+#include "getopt.h"
+#include "getprinter.h"
+#include "getqueue.h"
+#include "gethostinfo.h"
+#include "globmatch.h"
+#include "initialize.h"
+#include "linelist.h"
+#include "lpd_status.h"
+#include "permission.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Spool queue benchmark
+ *  Generates a synthetic spool queue and printcap in a work directory
+ *  and times the queue handling routines that lpd uses on it.
+ *
+ *  bench [-k] [-d workdir] [-f filter] [-n jobs] [-p printcap entries]
+ *     [-r rounds] [-t kbytes]
+ *
+ *  One line is printed for each test, in the form
+ *   bench=NAME jobs=N printcap=P rounds=R ops=N usec=T usec_per_op=T
+ *  so the results can be compared between builds.
+ *  The work directory is removed at the end unless -k is given or it
+ *  was there before bench started.
+ *
+ *  With -f the text filter (given by its full pathname, usually the lpf
+ *  in the build directory) is also run on a generated text file of -t
+ *  Kbytes;  its ops are Kbytes, so usec_per_op is the time for each
+ *  Kbyte of text.
+ */
+
+static int Job_count = 1000;
+static int Printcap_count = 1000;
+static int Rounds = 5;
+static int Keep_workdir;
+static int Made_workdir;	/* we created it, so we can remove it */
+static char *Workdir;
+static char *Text_filter;
+static int Text_kbytes = 16384;
+static const char *Bench_printer = "bench";
+static const char *Bench_host = "bench.example.com";
+
+static struct job *Jobs;
+
+static void usage(void)
+{
+	FPRINTF( STDERR, "usage: %s [-k] [-d workdir] [-f filter] [-n jobs] [-p printcap] [-r rounds] [-t kbytes]\n", Name );
+	FPRINTF( STDERR, "  -k          keep the work directory\n" );
+	FPRINTF( STDERR, "  -d workdir  work directory (default /tmp/lpbench.PID)\n" );
+	FPRINTF( STDERR, "  -f filter   also time this text filter, full pathname\n" );
+	FPRINTF( STDERR, "  -n jobs     jobs in the spool queue (default %d)\n", Job_count );
+	FPRINTF( STDERR, "  -p entries  printcap entries (default %d)\n", Printcap_count );
+	FPRINTF( STDERR, "  -r rounds   times each test is repeated (default %d)\n", Rounds );
+	FPRINTF( STDERR, "  -t kbytes   size of the filter text file (default %d)\n", Text_kbytes );
+	exit(1);
+}
+
+static void Get_parms(int argc, char *argv[] )
+{
+	int option;
+
+	while( (option = Getopt( argc, argv, "D:d:f:kn:p:r:t:" )) != EOF ){
+		switch( option ){
+		case 'D': Parse_debug( Optarg, 1 ); break;
+		case 'd': Workdir = safestrdup( Optarg,__FILE__,__LINE__ ); break;
+		case 'f': Text_filter = safestrdup( Optarg,__FILE__,__LINE__ ); break;
+		case 'k': Keep_workdir = 1; break;
+		case 'n': Job_count = atoi( Optarg ); break;
+		case 'p': Printcap_count = atoi( Optarg ); break;
+		case 'r': Rounds = atoi( Optarg ); break;
+		case 't': Text_kbytes = atoi( Optarg ); break;
+		default: usage(); break;
+		}
+	}
+	if( Optind != argc || Job_count <= 0 || Printcap_count <= 0 || Rounds <= 0
+		|| Text_kbytes <= 0 || (Text_filter && Text_filter[0] != '/') ){
+		usage();
+	}
+}
+
+static double Now_usec( void )
+{
+	struct timeval tv;
+
+	if( gettimeofday( &tv, 0 ) ){
+		logerr_die(LOG_ERR, "Now_usec: gettimeofday failed");
+	}
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+static void Report( const char *name, int ops, double usec )
+{
+	FPRINTF( STDOUT,
+		"bench=%s jobs=%d printcap=%d rounds=%d ops=%d usec=%.0f usec_per_op=%.2f\n",
+		name, Job_count, Printcap_count, Rounds, ops, usec, ops ? usec/ops : 0.0 );
+}
+
+static void Write_file( const char *path, const char *str )
+{
+	struct stat statb;
+	int fd;
+
+	if( (fd = Checkwrite( path, &statb, O_RDWR, 1, 0 )) < 0
+		|| ftruncate( fd, 0 ) || Write_fd_str( fd, str ) < 0 ){
+		logerr_die(LOG_ERR, "Write_file: cannot write '%s'", path );
+	}
+	close( fd );
+}
+
+/*
+ * Make_config - lpd.conf, printcap and lpd.perms in the work directory.
+ *  The printcap has the bench queue, Printcap_count other queues with
+ *  aliases and a tc= include, and a wildcard entry.  The permissions
+ *  file has a rejection line per synthetic user in front of the usual
+ *  defaults so that Perms_check has to walk it.
+ */
+
+static char *Make_config( char *spooldir )
+{
+	char line[SMALLBUFFER];
+	char *s = 0, *path, *printcap, *perms;
+	int i;
+
+	printcap = Make_pathname( Workdir, "printcap" );
+	perms = Make_pathname( Workdir, "lpd.perms" );
+
+	s = safeextend2( s, ".common:lp=/dev/null:mx=0:sh\n",__FILE__,__LINE__ );
+	plp_snprintf( line, sizeof(line),
+		"%s:sd=%s:lp=/dev/null:longnumber:done_jobs=%d:lpq_status_cached=0:tc=.common\n",
+		Bench_printer, spooldir, 10*Job_count );
+	s = safeextend2( s, line,__FILE__,__LINE__ );
+	for( i = 0; i < Printcap_count; ++i ){
+		plp_snprintf( line, sizeof(line),
+			"pr%05d|alias%05d|Printer %d on floor %d\n"
+			"  :sd=%s/pr%05d:rm=host%03d:rp=raw\n"
+			"  :tc=.common\n",
+			i, i, i, i % 20, spooldir, i, i % 100 );
+		s = safeextend2( s, line,__FILE__,__LINE__ );
+	}
+	s = safeextend2( s, "wild*:lp=/dev/null:tc=.common\n",__FILE__,__LINE__ );
+	Write_file( printcap, s );
+	if( s ) free( s ); s = 0;
+
+	for( i = 0; i < 100; ++i ){
+		plp_snprintf( line, sizeof(line),
+			"REJECT SERVICE=Q,M REMOTEUSER=blocked%03d REMOTEHOST=*.blocked%02d.example.com\n",
+			i, i % 10 );
+		s = safeextend2( s, line,__FILE__,__LINE__ );
+	}
+	s = safeextend2( s,
+		"ACCEPT SERVICE=M SAMEHOST SAMEUSER\n"
+		"REJECT SERVICE=M\n"
+		"DEFAULT ACCEPT\n",__FILE__,__LINE__ );
+	Write_file( perms, s );
+	if( s ) free( s ); s = 0;
+
+	path = Make_pathname( Workdir, "lpd.conf" );
+	s = safestrdup5( "printcap_path=", printcap, "\nlpd_printcap_path=\nperms_path=",
+		perms, "\n",__FILE__,__LINE__ );
+	Write_file( path, s );
+	if( s ) free( s ); s = 0;
+	free( printcap );
+	free( perms );
+	return( path );
+}
+
+/*
+ * Make_job - create the job ticket and data files for job n.
+ *  Most of the jobs are printable; every tenth is held, one in ten has
+ *  an error and one in ten is done, as in a busy queue.
+ */
+
+static void Make_job( int n, time_t now )
+{
+	char cf[LARGEBUFFER], line[SMALLBUFFER], hf_name[SMALLBUFFER],
+		df_name[SMALLBUFFER], *number, *s;
+	struct line_list *lp;
+	struct stat statb;
+	struct job job;
+	double jobsize;
+	int i, fd, files, size, len;
+
+	Init_job( &job );
+	number = Fix_job_number( &job, n );
+	plp_snprintf( hf_name, sizeof(hf_name), "hfA%s", number );
+	plp_snprintf( cf, sizeof(cf),
+		"H%s\nPuser%03d\nJreport-%d.txt\nC%c\nLuser%03d\nMuser%03d\n",
+		Bench_host, n % 200, n, 'A' + n % 4, n % 200, n % 200 );
+	files = 1 + n % 3;
+	for( i = 0; i < files; ++i ){
+		len = safestrlen(cf);
+		plp_snprintf( cf+len, sizeof(cf)-len, "%cdf%c%s%s\nNreport-%d-%d.txt\n",
+			(n % 5) ? 'f' : 'l', 'A'+i, number, Bench_host, n, i );
+	}
+	Set_job_ticket_from_cf_info( &job, cf, 0 );
+
+	jobsize = 0;
+	for( i = 0; i < job.datafiles.count; ++i ){
+		lp = (void *)job.datafiles.list[i];
+		plp_snprintf( df_name, sizeof(df_name), "df%c%s%s", 'A'+i, number, Bench_host );
+		size = 512 + (n * 7919 + i * 104729) % (64*1024);
+		s = malloc_or_die( size+1,__FILE__,__LINE__ );
+		for( len = 0; len < size; len += safestrlen(line) ){
+			plp_snprintf( line, sizeof(line), "line %d of job %d file %d\n", len, n, i );
+			plp_snprintf( s+len, size+1-len, "%s", line );
+		}
+		Write_file( df_name, s );
+		free( s );
+		if( stat( df_name, &statb ) ){
+			logerr_die(LOG_ERR, "Make_job: cannot stat '%s'", df_name );
+		}
+		Set_str_value( lp, OPENNAME, df_name );
+		Set_str_value( lp, DFTRANSFERNAME, df_name );
+		Set_double_value( lp, SIZE, (double)statb.st_size );
+		jobsize += statb.st_size;
+	}
+	Set_str_value( &job.info, HF_NAME, hf_name );
+	Set_str_value( &job.info, FILE_HOSTNAME, Bench_host );
+	Set_double_value( &job.info, SIZE, jobsize );
+	Set_flag_value( &job.info, JOB_TIME, (int)(now - Job_count + n) );
+	Set_flag_value( &job.info, JOB_TIME_USEC, n % 1000000 );
+	Make_identifier( &job );
+	switch( n % 10 ){
+	case 1:
+		Set_flag_value( &job.info, HOLD_TIME, (int)now );
+		break;
+	case 2:
+		Set_str_value( &job.info, ERROR, "LP device write error" );
+		Set_flag_value( &job.info, ERROR_TIME, (int)(now - n) );
+		Set_flag_value( &job.info, REMOVE_TIME, (int)(now - n) );
+		break;
+	case 3:
+		Set_flag_value( &job.info, DONE_TIME, (int)(now - n) );
+		Set_flag_value( &job.info, REMOVE_TIME, (int)(now - n) );
+		break;
+	}
+	if( (fd = Checkwrite( hf_name, &statb, O_RDWR, 1, 0 )) < 0 ){
+		logerr_die(LOG_ERR, "Make_job: cannot create '%s'", hf_name );
+	}
+	Set_job_ticket_file( &job, 0, fd );
+	close( fd );
+	Free_job( &job );
+}
+
+static void Remove_dir( const char *dir )
+{
+	DIR *dp;
+	struct dirent *d;
+	char *path;
+
+	if( !(dp = opendir( dir )) ) return;
+	while( (d = readdir( dp )) ){
+		if( !strcmp( d->d_name, "." ) || !strcmp( d->d_name, ".." ) ) continue;
+		path = Make_pathname( dir, d->d_name );
+		if( unlink( path ) ) Remove_dir( path );
+		free( path );
+	}
+	closedir( dp );
+	rmdir( dir );
+}
+
+/*
+ * Set_perm_check - a local request from user000, as lpd sets up
+ *  Perm_check for a connection before it services it
+ */
+
+static void Set_perm_check( int service )
+{
+	memset( &Perm_check, 0, sizeof(Perm_check) );
+	Perm_check.printer = Bench_printer;
+	Perm_check.user = Perm_check.remoteuser = "user000";
+	Perm_check.host = &Host_IP;
+	Perm_check.remotehost = &Host_IP;
+	Perm_check.service = service;
+}
+
+static void Bench_scan_queue( void )
+{
+	double start;
+	int i;
+
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		Scan_queue( &Spool_control, &Sort_order, 0,0,0,0,0,0,0,0 );
+	}
+	Report( "scan_queue", Rounds, Now_usec() - start );
+}
+
+static void Bench_job_tickets( void )
+{
+	struct job job;
+	double start;
+	int i, j, ops = 0;
+
+	Init_job( &job );
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Sort_order.count; ++j ){
+			Free_job( &job );
+			Get_job_ticket_file( 0, &job, Sort_order.list[j] );
+			++ops;
+		}
+	}
+	Report( "get_job_ticket_file", ops, Now_usec() - start );
+	Free_job( &job );
+}
+
+static void Bench_queue_status( void )
+{
+	struct line_list tokens, done_list;
+	double start;
+	int i, fd;
+
+	Init_line_list( &tokens );
+	Init_line_list( &done_list );
+	if( (fd = open( "/dev/null", O_WRONLY )) < 0 ){
+		logerr_die(LOG_ERR, "Bench_queue_status: cannot open /dev/null" );
+	}
+	Set_perm_check( LONGSTAT );
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		Free_line_list( &done_list );
+		Set_DYN( &Printer_DYN, Bench_printer );
+		Get_queue_status( &tokens, &fd, REQ_DLONG, 0, &done_list,
+			Max_status_size_DYN, "bench" );
+	}
+	Report( "get_queue_status", Rounds, Now_usec() - start );
+	close( fd );
+	Free_line_list( &tokens );
+	Free_line_list( &done_list );
+}
+
+static void Bench_perms_check( void )
+{
+	double start;
+	int i, j, ops = 0;
+
+	Set_perm_check( REMOVEJOB );
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Job_count; ++j ){
+			Perm_check.user = Perm_check.remoteuser
+				= Find_str_value( &Jobs[j].info, LOGNAME );
+			Perms_check( &Perm_line_list, &Perm_check, &Jobs[j], 1 );
+			++ops;
+		}
+	}
+	Report( "perms_check", ops, Now_usec() - start );
+}
+
+static void Bench_printcap( void )
+{
+	struct line_list info, aliases;
+	char name[SMALLBUFFER];
+	double start;
+	int i, j, ops = 0;
+
+	Init_line_list( &info );
+	Init_line_list( &aliases );
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Printcap_count; ++j ){
+			/* alternate primary names, aliases and wildcard matches */
+			switch( j % 3 ){
+			case 0: plp_snprintf( name, sizeof(name), "pr%05d", j ); break;
+			case 1: plp_snprintf( name, sizeof(name), "alias%05d", j ); break;
+			case 2: plp_snprintf( name, sizeof(name), "wild%05d", j ); break;
+			}
+			Free_line_list( &info );
+			Free_line_list( &aliases );
+			Select_pc_info( name, &info, &aliases, &PC_names_line_list,
+				&PC_order_line_list, &PC_info_line_list, 0, 1 );
+			++ops;
+		}
+	}
+	Report( "select_pc_info", ops, Now_usec() - start );
+	Free_line_list( &info );
+	Free_line_list( &aliases );
+}
+
+static void Bench_escape_split( void )
+{
+	struct line_list l;
+	char **images, *s;
+	double start;
+	int i, j, ops;
+
+	Init_line_list( &l );
+	images = malloc_or_die( Job_count * sizeof(images[0]),__FILE__,__LINE__ );
+	for( j = 0; j < Job_count; ++j ){
+		images[j] = Make_job_ticket_image( &Jobs[j] );
+	}
+
+	ops = 0;
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Job_count; ++j ){
+			s = Escape( images[j], 1 );
+			if( s ) free( s );
+			++ops;
+		}
+	}
+	Report( "escape", ops, Now_usec() - start );
+
+	ops = 0;
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Job_count; ++j ){
+			Free_line_list( &l );
+			Split( &l, images[j], Line_ends, 1, Option_value_sep, 1, 1, 1, 0 );
+			++ops;
+		}
+	}
+	Report( "split", ops, Now_usec() - start );
+
+	Free_line_list( &l );
+	for( j = 0; j < Job_count; ++j ){
+		if( images[j] ) free( images[j] );
+	}
+	free( images );
+}
+
+/*
+ * Bench_globmatch - host and queue name patterns as in lpd.perms and
+ *  the printcap,  and one with many '*' that needs backtracking
+ */
+
+static void Bench_globmatch( void )
+{
+	static const char *patterns[] = {
+		"*.example.com", "pr0*", "wild[0-9]*", "[^x]*?.bench.*",
+		"*a*a*a*a*a*a*a*a*a*a*a*b", 0 };
+	char name[SMALLBUFFER];
+	double start;
+	int i, j, k, ops = 0, matched = 0;
+
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		for( j = 0; j < Printcap_count; ++j ){
+			for( k = 0; patterns[k]; ++k ){
+				if( k == 4 ){
+					memset( name, 'a', 40 );
+					name[40] = 0;
+				} else {
+					plp_snprintf( name, sizeof(name), "%s%05d.%s",
+						(j % 2) ? "wild" : "pr", j, Bench_host );
+				}
+				if( !Globmatch( patterns[k], name ) ) ++matched;
+				++ops;
+			}
+		}
+	}
+	Report( "globmatch", ops, Now_usec() - start );
+	DEBUG1("Bench_globmatch: %d matched", matched );
+}
+
+/*
+ * Bench_text_filter - run the text filter on a listing like text file,
+ *  with the odd form feed, CR-LF line end and suspend string character
+ *  so that the filter has to look at them.
+ */
+
+static void Bench_text_filter( void )
+{
+	char line[SMALLBUFFER], *path;
+	double start;
+	int i, n, fd, in, out;
+	pid_t pid, result;
+	plp_status_t status;
+	struct stat statb;
+
+	path = Make_pathname( Workdir, "text" );
+	if( (fd = Checkwrite( path, &statb, O_RDWR, 1, 0 )) < 0
+		|| ftruncate( fd, 0 ) ){
+		logerr_die(LOG_ERR, "Bench_text_filter: cannot write '%s'", path );
+	}
+	for( i = n = 0; n < Text_kbytes * 1024; ++i ){
+		plp_snprintf( line, sizeof(line),
+			"%s%06d  user%03d  pr%05d  %s  the quick brown fox jumps over the lazy dog%s",
+			(i % 66) ? "" : "\014", i, i % 100, i % Printcap_count,
+			(i % 1000) ? "ok" : "\031?", (i % 7) ? "\n" : "\r\n" );
+		if( Write_fd_str( fd, line ) < 0 ){
+			logerr_die(LOG_ERR, "Bench_text_filter: cannot write '%s'", path );
+		}
+		n += safestrlen( line );
+	}
+	close( fd );
+
+	start = Now_usec();
+	for( i = 0; i < Rounds; ++i ){
+		if( (in = open( path, O_RDONLY )) < 0 ){
+			logerr_die(LOG_ERR, "Bench_text_filter: cannot open '%s'", path );
+		}
+		if( (out = open( "/dev/null", O_WRONLY )) < 0 ){
+			logerr_die(LOG_ERR, "Bench_text_filter: cannot open /dev/null" );
+		}
+		if( (pid = dofork(0)) < 0 ){
+			logerr_die(LOG_ERR, "Bench_text_filter: fork failed" );
+		} else if( pid == 0 ){
+			dup2( in, 0 );
+			dup2( out, 1 );
+			/* the filter writes accounting to fd 3 if it is open */
+			for( fd = 3; fd < 64; ++fd ) close( fd );
+			execl( Text_filter, Text_filter, "-Ff", "-w80", "-l66",
+				"-Pbench", "-nuser000", "-hlocalhost", (char *)0 );
+			_exit( 127 );
+		}
+		close( in );
+		close( out );
+		while( (result = plp_waitpid( pid, &status, 0 )) == -1 && errno == EINTR );
+		if( result != pid || !WIFEXITED(status) || WEXITSTATUS(status) ){
+			fatal(LOG_ERR, "Bench_text_filter: '%s' failed", Text_filter );
+		}
+	}
+	Report( "text_filter", Rounds * (n / 1024), Now_usec() - start );
+	unlink( path );
+	free( path );
+}
+
+int main(int argc, char *argv[], char *envp[])
+{
+	struct line_list raw;
+	char *spooldir, *queuedir, *conf, error[SMALLBUFFER];
+	double start;
+	time_t now;
+	int i;
+
+	Init_line_list( &raw );
+	(void) signal (SIGPIPE, SIG_IGN);
+	(void) signal (SIGCHLD, SIG_DFL);
+
+	Initialize( argc, argv, envp, 'D' );
+	Get_parms( argc, argv );
+
+	if( !Workdir ){
+		char buffer[SMALLBUFFER];
+		plp_snprintf( buffer, sizeof(buffer), "/tmp/lpbench.%d", (int)getpid() );
+		Workdir = safestrdup( buffer,__FILE__,__LINE__ );
+	}
+	spooldir = Make_pathname( Workdir, "spool" );
+	queuedir = Make_pathname( spooldir, Bench_printer );
+	if( mkdir( Workdir, 0755 ) == 0 ){
+		Made_workdir = 1;
+	} else if( errno != EEXIST ){
+		logerr_die(LOG_ERR, "bench: cannot create '%s'", Workdir );
+	}
+	if( (mkdir( spooldir, 0755 ) && errno != EEXIST)
+		|| (mkdir( queuedir, 0755 ) && errno != EEXIST) ){
+		logerr_die(LOG_ERR, "bench: cannot create '%s'", queuedir );
+	}
+
+	/* the same configuration steps as Setup_configuration() for lpd */
+	conf = Make_config( spooldir );
+	Clear_config();
+	Get_config( 1, conf );
+	Getprintcap_pathlist( 1, &raw, &PC_filters_line_list, Printcap_path_DYN );
+	Build_printcap_info( &PC_names_line_list, &PC_order_line_list,
+		&PC_info_line_list, &raw, &Host_IP );
+	Free_line_list( &raw );
+	Getprintcap_pathlist( 1, &RawPerm_line_list, &Perm_filters_line_list,
+		Printer_perms_path_DYN );
+	Free_line_list( &Perm_line_list );
+	Merge_line_list( &Perm_line_list, &RawPerm_line_list, 0,0,0 );
+
+	Set_DYN( &Printer_DYN, Bench_printer );
+	if( Setup_printer( Printer_DYN, error, sizeof(error), 0 ) ){
+		fatal(LOG_ERR, "bench: cannot set up printer '%s' - %s",
+			Bench_printer, error );
+	}
+
+	now = time( (void *)0 );
+	start = Now_usec();
+	for( i = 0; i < Job_count; ++i ){
+		Make_job( i+1, now );
+	}
+	Report( "generate", Job_count, Now_usec() - start );
+
+	/* the jobs are kept in memory for the tests that do not read them */
+	Scan_queue( &Spool_control, &Sort_order, 0,0,0,0,0,0,0,0 );
+	Jobs = malloc_or_die( Job_count * sizeof(Jobs[0]),__FILE__,__LINE__ );
+	for( i = 0; i < Job_count; ++i ){
+		Init_job( &Jobs[i] );
+		if( i < Sort_order.count ){
+			Get_job_ticket_file( 0, &Jobs[i], Sort_order.list[i] );
+		}
+	}
+
+	Bench_scan_queue();
+	Bench_job_tickets();
+	Bench_queue_status();
+	Bench_perms_check();
+	Bench_printcap();
+	Bench_escape_split();
+	Bench_globmatch();
+	if( Text_filter ) Bench_text_filter();
+
+	for( i = 0; i < Job_count; ++i ){
+		Free_job( &Jobs[i] );
+	}
+	free( Jobs );
+	if( Made_workdir && !Keep_workdir ){
+		if( chdir( "/" ) == 0 ) Remove_dir( Workdir );
+	}
+	free( conf );
+	free( queuedir );
+	free( spooldir );
+	return( 0 );
+}
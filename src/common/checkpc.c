@@ -29,6 +29,10 @@ static int Noaccount;
 static int Nolog,  Nostatus,  Fix,  Age, Printcap;
 static int Truncate = -1;
 static int Remove;
+static int Workers = 1, Rate;
+static int Report_fd = -1;
+static int Throttle_count;
+static struct timeval Throttle_start;
 static char *User_specified_printer;
 static time_t Current_time;
 static int Check_path_list( char *plist, int allow_missing );
@@ -79,12 +83,27 @@ int main( int argc, char *argv[], char *envp[] )
 
 
     /* scan the argument list for a 'Debug' value */
-	while( (c = Getopt( argc, argv, "aflprst:A:CD:P:T:V" ) ) != EOF ){
+	while( (c = Getopt( argc, argv, "aflj:o:prst:A:CD:P:R:T:V" ) ) != EOF ){
 		switch( c ){
 			default: usage();
 			case 'a': Noaccount = 1; break;
 			case 'f': Fix = 1; break;
 			case 'l': Nolog = 1; break;
+			case 'j':
+				if( Optarg && (Workers = atoi( Optarg )) > 0 ){
+					break;
+				}
+				usage();
+				break;
+			case 'o':
+				if( Optarg == 0 ) usage();
+				if( (Report_fd = open( Optarg, O_WRONLY|O_CREAT|O_TRUNC|O_APPEND,
+					0644 )) < 0 ){
+					FPRINTF( STDERR, "cannot open report file '%s' - %s\n",
+						Optarg, Errormsg(errno) );
+					exit(1);
+				}
+				break;
 			case 'r': Remove = 1; break;
 			case 's': Nostatus = 1; break;
 			case 't':
@@ -105,6 +124,12 @@ int main( int argc, char *argv[], char *envp[] )
 			case 'V': ++Verbose; break;
 			case 'p': ++Printcap; break;
 			case 'P': User_specified_printer = Optarg; break;
+			case 'R':
+				if( Optarg && (Rate = atoi( Optarg )) > 0 ){
+					break;
+				}
+				usage();
+				break;
 			case 'T':
 				initsetproctitle( argc, argv, envp );
 				Test_port( getuid(), geteuid(), Optarg );
@@ -223,10 +248,7 @@ int main( int argc, char *argv[], char *envp[] )
 		}
 	} else {
 		if( DEBUGL1 ) Dump_line_list("checkpc: all", &All_line_list );
-		for( i = 0; i < All_line_list.count; ++i ){
-			Set_DYN(&Printer_DYN,All_line_list.list[i]);
-			Scan_printer(&spooldirs);
-		}
+		Check_all_printers(&spooldirs);
 	}
 
     if(DEBUGL3){
@@ -268,6 +290,89 @@ void mkdir_path( char *path )
 	}
 }
 
+/***************************************************************************
+ * Check_all_printers()
+ *  check each of the printers in All_line_list
+ *  With -j workers For_all_printers() splits the printers into that many
+ *  blocks,  each checked by its own process with its output going to
+ *  temp files,  and copies the output to STDOUT and STDERR in order.
+ *  The spool directories are found first,  so that two printers
+ *  sharing a spool directory are caught even if different workers
+ *  check them.
+ ***************************************************************************/
+
+static void Check_work( int *sock UNUSED, void *arg )
+{
+	Scan_printer( (struct line_list *)arg );
+}
+
+void Check_all_printers( struct line_list *spooldirs )
+{
+	int i, out = 1;
+	char name[SMALLBUFFER];
+
+	if( Workers > All_line_list.count ) Workers = All_line_list.count;
+	if( Workers <= 1 ) Workers = 1;
+	for( i = 0; Workers > 1 && i < All_line_list.count; ++i ){
+		safestrncpy( name, All_line_list.list[i] );
+		if( strchr( name, '*' ) || Is_clean_name( name ) ) continue;
+		lowercase( name );
+		Set_DYN(&Printer_DYN,name);
+		Fix_Rm_Rp_info(0,0);
+		if( Spool_dir_DYN
+			&& !Find_exists_value( spooldirs, Spool_dir_DYN, Hash_value_sep ) ){
+			Set_str_value( spooldirs, Spool_dir_DYN, Printer_DYN );
+		}
+	}
+	For_all_printers( Workers, &out, 1, Check_work, spooldirs );
+}
+
+/***************************************************************************
+ * Throttle()
+ *  called before we look at each file in a spool directory;
+ *  with -R rate we sleep as needed to keep all the workers together
+ *  to about rate files a second.
+ ***************************************************************************/
+
+void Throttle( void )
+{
+	struct timeval now;
+	double elapsed, due;
+
+	if( Rate <= 0 ) return;
+	if( Throttle_count++ == 0 ){
+		gettimeofday( &Throttle_start, 0 );
+		return;
+	}
+	gettimeofday( &now, 0 );
+	elapsed = (now.tv_sec - Throttle_start.tv_sec)
+		+ (now.tv_usec - Throttle_start.tv_usec)/1000000.0;
+	due = (double)(Throttle_count-1) * Workers / Rate;
+	if( due > elapsed ){
+		plp_usleep( (int)((due - elapsed) * 1000000) );
+	}
+}
+
+/***************************************************************************
+ * Report_fix()
+ *  record a change we made in the -o report file,  one line per change:
+ *    printer TAB action TAB path TAB detail
+ *  The line is written with a single write() on an O_APPEND file so
+ *  the lines from the workers are not mixed up.
+ ***************************************************************************/
+
+void Report_fix( const char *action, const char *path, const char *detail )
+{
+	char line[LARGEBUFFER];
+
+	if( Report_fd < 0 ) return;
+	plp_snprintf( line, sizeof(line), "%s\t%s\t%s\t%s\n",
+		Printer_DYN?Printer_DYN:"-", action, path, detail?detail:"" );
+	if( Write_fd_str( Report_fd, line ) < 0 ){
+		WARNMSG( "cannot write report file - %s", Errormsg(errno) );
+	}
+}
+
 /***************************************************************************
  * Scan_printer()
  * process the printer spool queue
@@ -358,7 +463,8 @@ void Scan_printer(struct line_list *spooldirs)
 			Printer_DYN);
 		return;
 	}
-	if( (s =  Find_str_value(spooldirs,Spool_dir_DYN)) ){
+	if( (s =  Find_str_value(spooldirs,Spool_dir_DYN))
+		&& safestrcmp( s, Printer_DYN ) ){
 		WARNMSG("%s: CATASTROPHIC ERROR! queue '%s' also has spool directory '%s'",
 			Printer_DYN, s, Spool_dir_DYN);
 		return;
@@ -388,10 +494,11 @@ void Scan_printer(struct line_list *spooldirs)
 		if( safestrcmp( cf_name, "." ) == 0
 			|| safestrcmp( cf_name, ".." ) == 0 ) continue;
 		DEBUG2("Scan_printer: file '%s'", cf_name );
+		Throttle();
 		if( fifo_header_len &&
 			!safestrncmp( cf_name,Fifo_lock_file_DYN, fifo_header_len) ){
 			DEBUG2("Scan_printer: fifo file '%s'", cf_name );
-			unlink( cf_name );
+			if( unlink( cf_name ) == 0 ) Report_fix( "remove", cf_name, "fifo lock" );
 			continue;
 		}
 		if( stat(cf_name,&statb) == -1 ){
@@ -403,6 +510,11 @@ void Scan_printer(struct line_list *spooldirs)
 		if( S_ISLNK( statb.st_mode ) ){
 			continue;
 		}
+		/* this used to be a chown -R and chgrp -R of the spool directory */
+		if( Fix && S_ISDIR( statb.st_mode ) ){
+			Fix_tree_owner( cf_name, &statb );
+			continue;
+		}
 		delta = Current_time - statb.st_mtime;
 
 		/*
@@ -434,22 +546,25 @@ void Scan_printer(struct line_list *spooldirs)
             if( (statb.st_size == 0) ){
 				if( Remove || Verbose)MESSAGE( " %s:  file '%s', zero length file > %3.2f %s old%s",
 					Printer_DYN, cf_name, n, range, remove );
-				if( Remove ){
-					unlink(cf_name);
+				if( Remove && unlink(cf_name) == 0 ){
+					Report_fix( "remove", cf_name, "zero length" );
 				}
 				continue;
 			} else {
 				if( Remove || Verbose)MESSAGE( " %s:  file '%s', age %3.2f %s > %3.2f %s maximum%s",
 					Printer_DYN, cf_name, n, range, a, range, remove );
-				if( Remove ){
-					unlink(cf_name);
+				if( Remove && unlink(cf_name) == 0 ){
+					Report_fix( "remove", cf_name, "too old" );
 				}
 				continue;
 			}
 		}
 		/* we update all real files in this directory */
 		if( jobfile ){
-			Check_file( cf_name, Fix, 0, 0 );
+			Check_file_stat( cf_name, &statb, Fix, 0, 0 );
+		} else if( Fix && S_ISREG( statb.st_mode )
+			&& (statb.st_uid != DaemonUID || statb.st_gid != DaemonGID) ){
+			Fix_owner( cf_name );
 		}
 	}
 	closedir(dir);
@@ -617,6 +732,8 @@ void Make_write_file( char *file, char *printer )
 			To_euid(euid);
 			if( fd < 0 ){
 				WARNMSG( " ** cannot create '%s' - '%s'", s, Errormsg(errno) );
+			} else {
+				Report_fix( "create", s, 0 );
 			}
 			Fix_owner( s );
 		}
@@ -632,11 +749,14 @@ static void usage(void)
 {
 	FPRINTF( STDERR,
 "checkpc [-aflprsV] [-A age] [-D debuglevel] [-P printer] [-t size]\n"
+"   [-j workers] [-o reportfile] [-R rate]\n"
 "   Check printcap for printer information and fix files where possible\n"
 " Option:\n"
 " -a             do not create accounting info (:af) file\n"
 " -f             fix missing files and inconsistent file permissions\n"
+" -j workers     check the printers with this many processes\n"
 " -l             do not create logging info (:lf) file\n"
+" -o reportfile  write a line for each change made to reportfile\n"
 " -p             verbose printcap information\n"
 " -r             remove job files older than -A age seconds\n"
 " -s             do not create filter status (:ps) info file\n"
@@ -645,6 +765,7 @@ static void usage(void)
 "                age, D days (default), H hours, M minutes, S seconds\n"
 " -D debuglevel  set debug level\n"
 " -P printer     check or fix only this printer entry\n"
+" -R rate        look at no more than rate spool files a second\n"
 " -V             really verbose information\n"
 " -T line        portability diagnostic, use serial line device for stty test\n");
 	Parse_debug("=",-1);
@@ -704,17 +825,27 @@ int getk( char *age )
 int Check_file( char  *path, int fix, int age, int rmflag )
 {
 	struct stat statb;
-	int old;
-	int err = 0;
 
 	DEBUG4("Check_file: '%s', fix %d, time 0x%lx, age %d",
 		path, fix, (long)Current_time, age );
 
 	if( stat( path, &statb ) ){
 		WARNMSG( "  %s: cannot stat file '%s', %s", Printer_DYN?Printer_DYN:"", path, Errormsg(errno) );
-		err = 1;
-		return( err );
+		return( 1 );
 	}
+	return( Check_file_stat( path, &statb, fix, age, rmflag ) );
+}
+
+/*
+ * Check_file_stat - Check_file() for a file we have already done stat() on
+ */
+
+int Check_file_stat( char *path, struct stat *statp, int fix, int age, int rmflag )
+{
+	struct stat statb = *statp;
+	int old;
+	int err = 0;
+
 	if( S_ISDIR( statb.st_mode ) ){
 		WARNMSG("  %s: '%s' is a directory, not a file", Printer_DYN?Printer_DYN:"",path );
 		return(2);
@@ -748,6 +879,8 @@ int Check_file( char  *path, int fix, int age, int rmflag )
 				if( unlink( path ) == -1 ){
 					WARNMSG( "cannot remove '%s', %s", path,
 						Errormsg(errno) );
+				} else {
+					Report_fix( "remove", path, "too old" );
 				}
 			}
 		}
@@ -822,6 +955,7 @@ int Fix_create_dir( char  *path, struct stat *statb )
 			WARNMSG( "mkdir '%s' failed, %s", path, Errormsg(errno) );
 			err = 1;
 		} else {
+			Report_fix( "mkdir", path, 0 );
 			err = Fix_owner( path );
 		}
 		To_euid(euid);
@@ -844,6 +978,11 @@ int Fix_owner( char *path )
 		err = errno;
 		if( status ){
 			WARNMSG( "chown '%s' failed, %s", path, Errormsg(err) );
+		} else {
+			char owner[SMALLBUFFER];
+			plp_snprintf( owner, sizeof(owner), "%ld/%ld",
+				(long)DaemonUID, (long)DaemonGID );
+			Report_fix( "chown", path, owner );
 		}
 		errno = err;
 	}
@@ -865,6 +1004,10 @@ int Fix_perms( char *path, int perms )
 	if( status ){
 		WARNMSG( "chmod '%s' to 0%o failed, %s", path, perms,
 			 Errormsg(err) );
+	} else {
+		char mode[SMALLBUFFER];
+		plp_snprintf( mode, sizeof(mode), "0%o", perms );
+		Report_fix( "chmod", path, mode );
 	}
 	errno = err;
 	return( status != 0 );
@@ -931,18 +1074,7 @@ int Check_spool_dir( char *path )
 	}
 	if(pathname) free(pathname); pathname = 0;
 	Free_line_list(&parts);
-	/* now we do chown if necessary */
-	if( Fix ){
-		char cmd[SMALLBUFFER];
-		int euid = geteuid();
-
-		To_euid_root();
-		plp_snprintf( cmd, sizeof(cmd), "%s -R %ld %s", CHOWN, (long)DaemonUID, path );
-		system( cmd );
-		plp_snprintf( cmd, sizeof(cmd), "%s -R %ld %s", CHGRP, (long)DaemonGID, path );
-		system( cmd );
-		To_euid(euid);
-	}
+	/* the files in the directory get their owner fixed by Scan_printer() */
 	if( stat( path, &statb ) ){
 		WARNMSG( "stat of '%s' failed - %s", path, Errormsg(errno) );
 		err = 1;
@@ -968,6 +1100,43 @@ int Check_spool_dir( char *path )
 	return(err);
 }
 
+/***************************************************************************
+ * Fix_tree_owner()
+ *  set the owner of a directory in the spool directory and everything
+ *  below it to the daemon,  leaving alone the files that are already
+ *  right.  We used to run 'chown -R' and 'chgrp -R' on the spool
+ *  directory,  which changed every file on each run.
+ ***************************************************************************/
+
+void Fix_tree_owner( char *path, struct stat *statp )
+{
+	DIR *dir;
+	struct dirent *d;
+	struct stat statb;
+	char *name;
+
+	if( statp->st_uid != DaemonUID || statp->st_gid != DaemonGID ){
+		Fix_owner( path );
+	}
+	if( !S_ISDIR( statp->st_mode ) ) return;
+	if( !(dir = opendir( path )) ){
+		WARNMSG( "  cannot scan directory '%s' - '%s'", path, Errormsg(errno) );
+		return;
+	}
+	while( (d = readdir(dir)) ){
+		if( safestrcmp( d->d_name, "." ) == 0
+			|| safestrcmp( d->d_name, ".." ) == 0 ) continue;
+		Throttle();
+		name = safestrdup3( path, "/", d->d_name, __FILE__,__LINE__ );
+		/* do not touch symbolic links */
+		if( lstat( name, &statb ) == 0 && !S_ISLNK( statb.st_mode ) ){
+			Fix_tree_owner( name, &statb );
+		}
+		free( name );
+	}
+	closedir(dir);
+}
+
 /***************************************************************************
  * We have put a slew of portatbility tests in here.
  * 1. setuid
@@ -1461,19 +1630,24 @@ void Test_port(int ruid, int euid, char *serial_line )
 void Fix_clean( char *s, int no )
 {
 	struct stat statb;
-	int fd;
 	if( s ){
 		if(!no){
 			Make_write_file( s, 0 );
 			if( Truncate >= 0 ){
 				MESSAGE(" trimming '%s'", s );
-				fd = Trim_status_file( -1, s, Truncate, Truncate );
-				close(fd);
+				if( Truncate_status_file( s, Truncate ) > 0 ){
+					Report_fix( "truncate", s, 0 );
+				}
 			}
 		} else {
 			if( stat(s,&statb) == 0 && Fix ){
 				MESSAGE(" removing '%s'", s );
-				unlink(s);
+				if( unlink(s) == 0 ) Report_fix( "remove", s, "not used" );
+			}
+			if( Fix ){
+				char *t = safestrdup2( s, STATUS_SEGMENT_SUFFIX, __FILE__,__LINE__ );
+				unlink(t);
+				free(t);
 			}
 		}
 	}
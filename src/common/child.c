@@ -14,6 +14,7 @@
 #include "proctitle.h"
 #include "linksupport.h"
 #include "child.h"
+#include "stats.h"
 /**** ENDINCLUDE ****/
 
 /*
@@ -234,9 +235,117 @@ pid_t dofork( int new_process_group )
 	} else if( pid != -1 ){
 		Check_max(&Process_list,1);
 		Process_list.list[Process_list.count++] = Cast_int_to_voidstar(pid);
+		Stats_fork();
 	}
 	return( pid );
 }
+/***************************************************************************
+ * For_all_printers - do work( sock, arg ) with Printer_DYN set to each
+ *  of the printers in All_line_list
+ *  The printers are split into up to workers blocks of printers next
+ *  to each other in the list,  each done by a process that writes to
+ *  its own temp file;  with redirect set its STDOUT goes there too,
+ *  and its STDERR to a second temp file unless STDERR is the same file
+ *  as STDOUT.  We copy the temp files to *sock and STDERR in order and
+ *  remove them,  so the output is the same as doing the printers one
+ *  after another.
+ ***************************************************************************/
+
+static void Copy_tempfile( int fd, char *path, int to )
+{
+	char buffer[LARGEBUFFER];
+	int n;
+
+	if( lseek( fd, 0, SEEK_SET ) == -1 ){
+		logerr_die(LOG_INFO, "For_all_printers: lseek failed" );
+	}
+	while( (n = ok_read( fd, buffer, sizeof(buffer) )) > 0 ){
+		if( Write_fd_len( to, buffer, n ) < 0 ) cleanup(0);
+	}
+	close(fd);
+	unlink(path);
+}
+
+void For_all_printers( int workers, int *sock, int redirect,
+	void (*work)( int *sock, void *arg ), void *arg )
+{
+	int i, n, fd, errfd, first, last, started, split_stderr = 0;
+	char *tempfile, *errfile;
+	struct line_list pids, fds, errfds, files, errfiles;
+	struct stat out, err;
+	plp_status_t status;
+	pid_t pid;
+
+	Init_line_list(&pids);
+	Init_line_list(&fds);
+	Init_line_list(&errfds);
+	Init_line_list(&files);
+	Init_line_list(&errfiles);
+	if( workers > All_line_list.count ) workers = All_line_list.count;
+	if( redirect && !( fstat( 1, &out ) == 0 && fstat( 2, &err ) == 0
+		&& out.st_dev == err.st_dev && out.st_ino == err.st_ino ) ){
+		split_stderr = 1;
+	}
+	DEBUG1("For_all_printers: %d workers for %d printers, split_stderr %d",
+		workers, All_line_list.count, split_stderr );
+	for( started = 0; workers > 1 && started < workers; ++started ){
+		first = All_line_list.count * started / workers;
+		last = All_line_list.count * (started+1) / workers;
+		fd = Make_temp_fd_in_dir( &tempfile, Server_tmp_dir_DYN );
+		errfd = -1; errfile = 0;
+		if( split_stderr ){
+			errfd = Make_temp_fd_in_dir( &errfile, Server_tmp_dir_DYN );
+		}
+		if( (pid = dofork(0)) < 0 ){
+			logerr(LOG_INFO, _("For_all_printers: fork failed") );
+			close(fd);
+			if( errfd >= 0 ) close(errfd);
+			break;
+		} else if( pid == 0 ){
+			/* the temp files are removed by the parent */
+			if( redirect ){
+				dup2( fd, 1 );
+				dup2( split_stderr ? errfd : fd, 2 );
+				if( errfd >= 0 ) close( errfd );
+			}
+			for( i = first; i < last; ++i ){
+				Set_DYN(&Printer_DYN, All_line_list.list[i]);
+				(*work)( &fd, arg );
+			}
+			Errorcode = 0;
+			cleanup(0);
+		}
+		Check_max(&pids,1);
+		pids.list[pids.count++] = Cast_int_to_voidstar(pid);
+		Check_max(&fds,1);
+		fds.list[fds.count++] = Cast_int_to_voidstar(fd);
+		Check_max(&errfds,1);
+		errfds.list[errfds.count++] = Cast_int_to_voidstar(errfd);
+		Add_line_list(&files,tempfile,0,0,0);
+		Add_line_list(&errfiles,errfile?errfile:"",0,0,0);
+	}
+	for( n = 0; n < pids.count; ++n ){
+		pid = Cast_ptr_to_int(pids.list[n]);
+		while( plp_waitpid( pid, &status, 0 ) < 0 && errno == EINTR );
+		Copy_tempfile( Cast_ptr_to_int(fds.list[n]), files.list[n], *sock );
+		if( (errfd = Cast_ptr_to_int(errfds.list[n])) >= 0 ){
+			Copy_tempfile( errfd, errfiles.list[n], 2 );
+		}
+		pids.list[n] = fds.list[n] = errfds.list[n] = 0;
+	}
+	/* do the printers we could not start a worker for */
+	first = workers > 1 ? All_line_list.count * started / workers : 0;
+	for( i = first; i < All_line_list.count; ++i ){
+		Set_DYN(&Printer_DYN, All_line_list.list[i]);
+		(*work)( sock, arg );
+	}
+	Free_line_list(&errfiles);
+	Free_line_list(&files);
+	Free_line_list(&errfds);
+	Free_line_list(&fds);
+	Free_line_list(&pids);
+}
+
 /*
  * routines to call on exit
  */
@@ -46,6 +46,7 @@
 { "FLUSH", N_("FLUSH"), OP_FLUSH, 0, 0, 0, 0},
 { "LANG", N_("LANG"), OP_LANG, 0, 0, 0, 0},
 { "PPD", N_("PPD"), OP_PPD, 0, 0, 0, 0},
+{ "STATS", N_("STATS"), OP_STATS, 0, 0, 0, 0},
 
 {0,0,0,0,0,0,0}
 };
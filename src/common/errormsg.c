@@ -729,6 +729,35 @@ const char *Server_status( int d )
 	return(s);
 }
 
+/*
+ * Status_needs_trim - check if the status fd needs to be trimmed or
+ *  reopened.  Another process may have retired the segment we are
+ *  writing to, so the file is checked, but only once a second.
+ */
+static int Status_needs_trim( void )
+{
+	static time_t last_check;
+	static int last_fd = -1;
+	struct stat statb, fstatb;
+	time_t now;
+
+	if( Status_fd <= 0 ) return( 1 );
+	if( Max_status_size_DYN <= 0 ) return( 0 );
+	now = time( (void *)0 );
+	if( Status_fd == last_fd && now == last_check ) return( 0 );
+	last_fd = Status_fd;
+	last_check = now;
+	if( fstat( Status_fd, &fstatb ) == -1 ) return( 1 );
+	if( fstatb.st_size/1024 > Status_segment_size( Max_status_size_DYN,
+		Min_status_size_DYN ) ) return( 1 );
+	if( !ISNULL(Queue_status_file_DYN)
+		&& stat( Queue_status_file_DYN, &statb ) == 0
+		&& (statb.st_ino != fstatb.st_ino || statb.st_dev != fstatb.st_dev) ){
+		return( 1 );
+	}
+	return( 0 );
+}
+
 /*
  * Error status on STDERR
  */
@@ -745,7 +774,6 @@ const char *Server_status( int d )
 #endif
 	char msg_b[SMALLBUFFER];
 	static int insetstatus;
-	struct stat statb;
     VA_LOCAL_DECL
 
     VA_START (fmt);
@@ -765,9 +793,7 @@ const char *Server_status( int d )
 			Add_line_list(&Status_lines,msg_b,0,0,0);
 		}
 	} else {
-		if( Status_fd <= 0 
-			|| ( Max_status_size_DYN > 0 && fstat( Status_fd, &statb ) != -1
-			&& (statb.st_size / 1024 ) > Max_status_size_DYN ) ){
+		if( Status_needs_trim() ){
 			Status_fd = Trim_status_file( Status_fd, Queue_status_file_DYN,
 				Max_status_size_DYN, Min_status_size_DYN );
 		}
@@ -119,6 +119,21 @@ char *Find_fqdn( struct host_information *info, const char *shorthost )
 	return( Fixup_fqdn( shorthost, info, host_ent) );
 }
 
+/*
+ * Find_fqdn_again - as Find_fqdn(),  but if info already holds the
+ *  entry for this host name we keep it.  Used when checking the jobs of
+ *  a queue one after another;  they mostly come from a few hosts.
+ */
+
+char *Find_fqdn_again( struct host_information *info, const char *shorthost )
+{
+	if( info->fqdn && shorthost && !safestrcasecmp( info->fqdn, shorthost ) ){
+		DEBUG3( "Find_fqdn_again: host '%s' already found", shorthost );
+		return( info->fqdn );
+	}
+	return( Find_fqdn( info, shorthost ) );
+}
+
 static char *Fixup_fqdn( const char *shorthost, struct host_information *info,
 	struct hostent *host_ent )
 {
@@ -34,6 +34,7 @@
 #include "permission.h"
 #include "lockfile.h"
 #include "merge.h"
+#include "summary.h"
 
 #if defined(USER_INCLUDE)
 # include USER_INCLUDE
@@ -702,6 +703,7 @@ int Set_job_ticket_file( struct job *job, struct line_list *perm_check, int open
 	if( Lpq_status_file_DYN ){
 		unlink(Lpq_status_file_DYN );
 	}
+	Summary_changed( Printer_DYN );
 
 	/* we do this when we have a logger */
 	if( status == 0 && Logger_fd > 0 ){
@@ -776,6 +778,46 @@ void Get_job_ticket_file( int *lock_fd, struct job *job, char *job_ticket_name )
 	if(DEBUGL2)Dump_job("Get_job_ticket_file",job);
 }
 
+/*
+ * Lookahead_file - name of the file with the filter output for data file
+ *  count of the job made while the job before it was printing
+ *  (see filter_lookahead).  It is the job ticket name with 'pf' in
+ *  place of 'hf' and '.count' added, in a static buffer.
+ */
+
+char *Lookahead_file( struct job *job, int count )
+{
+	static char name[SMALLBUFFER];
+	char *hf_name, *s;
+	int len;
+
+	hf_name = Find_str_value(&job->info,HF_NAME);
+	if( ISNULL(hf_name) ) return( 0 );
+	if( (s = safestrchr(hf_name, '=')) ) hf_name = s+1;
+	plp_snprintf( name, sizeof(name), "%s.%d", hf_name, count );
+	if( (s = safestrrchr( name, '/' )) ) ++s; else s = name;
+	len = safestrlen( hf_name );
+	if( s[0] != 'h' || (int)safestrlen(name) <= len ) return( 0 );
+	s[0] = 'p';
+	return( name );
+}
+
+/*
+ * Remove_lookahead_files - remove the saved filter output for the job
+ */
+
+void Remove_lookahead_files( struct job *job )
+{
+	char *s;
+	int i;
+
+	for( i = 0; i < job->datafiles.count; ++i ){
+		if( (s = Lookahead_file( job, i )) && unlink( s ) == 0 ){
+			DEBUG1("Remove_lookahead_files: removed '%s'", s );
+		}
+	}
+}
+
 /*
  * Get Spool Control Information
  *  - simply read the file
@@ -826,6 +868,7 @@ void Set_spool_control( struct line_list *perm_check, const char *file,
 		/* do not check to see if this works */
 		unlink(Lpq_status_file_DYN);
 	}
+	Summary_changed( Printer_DYN );
 
 	if( Logger_fd ){
 		/* log the spool control file changes */
@@ -1101,6 +1144,10 @@ int Write_pid( int fd, int pid, char *str )
  *    check to see that the token value matches one of the following
  *    in the control file:
  *  token is INTEGER: then matches the job number
+ *  token is INTEGER-INTEGER: then matches the job numbers in the range
+ *  token is user=pattern, host=pattern, class=pattern:  glob matches
+ *    the user name, originating host or class of the job
+ *  token is age=seconds: matches jobs submitted at least that long ago
  *  token is string: then matches either the user name or host name
  *    then try glob matching job ID
  *  return:
@@ -1111,8 +1158,10 @@ int Write_pid( int fd, int pid, char *str )
 int Patselect( struct line_list *token, struct line_list *cf, int starting )
 {
 	int match = 1;
-	int i, n, val;
-	char *key, *s, *end;
+	int i, n, val, last;
+	char *key, *s, *end, *value;
+	const char *field;
+	time_t job_time;
 	
 	if(DEBUGL3)Dump_line_list("Patselect- tokens", token );
 	if(DEBUGL3)Dump_line_list("Patselect- info", cf );
@@ -1125,12 +1174,39 @@ int Patselect( struct line_list *token, struct line_list *cf, int starting )
 		}
 		end = key;
 		val = strtol( key, &end, 10 );
+		field = 0;
+		if( (value = safestrchr( key, '=' )) ){
+			n = value - key;
+			if( n == 4 && !safestrncasecmp( key, "user", n ) ){
+				field = LOGNAME;
+			} else if( n == 4 && !safestrncasecmp( key, "host", n ) ){
+				field = FROMHOST;
+			} else if( n == 5 && !safestrncasecmp( key, "class", n ) ){
+				field = CLASS;
+			}
+		}
 		if( *end == 0 ){
 			n = Find_decimal_value(cf,NUMBER);
 			/* we check job number */
 			DEBUG3("Patselect: job number check '%d' to job %d",
 				val, n );
 			match = (val != n);
+		} else if( end != key && *end == '-' && isdigit(cval(end+1))
+			&& (last = strtol( end+1, &end, 10 ), *end == 0) ){
+			n = Find_decimal_value(cf,NUMBER);
+			DEBUG3("Patselect: job number range %d-%d to job %d",
+				val, last, n );
+			match = !(val <= n && n <= last);
+		} else if( value && value - key == 3
+			&& !safestrncasecmp( key, "age", 3 ) ){
+			job_time = Find_flag_value(cf,JOB_TIME);
+			DEBUG3("Patselect: age %s, job time %ld", value+1, (long)job_time );
+			match = !(job_time
+				&& time( (void *)0 ) - job_time >= strtol( value+1, 0, 10 ));
+		} else if( field ){
+			s = Find_str_value(cf,field);
+			DEBUG3("Patselect: '%s' to '%s'", key, s );
+			match = !s || Globmatch( value+1, s );
 		} else {
 			/* now we check to see if we have a name match */
 			if( (s = Find_str_value(cf,LOGNAME))
@@ -1653,69 +1729,192 @@ int Get_destination_by_name( struct job *job, char *name )
 }
 
 /*
- * Trim_status_file - trim a status file to an acceptible length
+ * Status_segment_size - size in K at which the current segment of
+ *  a status file is retired.  Half of max keeps the current and the
+ *  retired segment within max K; a smaller min gives finer segments.
  */
 
-int Trim_status_file( int status_fd, char *file, int max, int min )
+int Status_segment_size( int max, int min )
+{
+	int seg;
+
+	if( max <= 0 ) return( 0 );
+	seg = max/2;
+	if( min > 0 && min < seg ) seg = min;
+	if( seg == 0 ) seg = 1;
+	return( seg );
+}
+
+/*
+ * Copy_status_tail - put the lines in the last size K of fd into file,
+ *  writing file.new and renaming it so readers never see a partial file
+ *  Returns: 0 on success
+ */
+
+static int Copy_status_tail( int fd, char *file, int size, int mode )
 {
-	int tempfd, status;
 	char buffer[LARGEBUFFER];
 	struct stat statb;
-	char *tempfile, *s;
-	int count;
+	char *newfile, *s;
+	int newfd, count, status = -1;
+
+	newfile = safestrdup2( file, ".new", __FILE__,__LINE__ );
+	if( (newfd = Checkwrite( newfile, &statb, O_RDWR, 1, 0 )) >= 0
+		&& ftruncate( newfd, 0 ) == 0 ){
+		fchmod( newfd, mode & 07777 );
+		status = 0;
+		if( lseek( fd, -(off_t)size*1024, SEEK_END ) > 0 ){
+			/* start at a whole line */
+			while( (count = ok_read( fd, buffer, sizeof(buffer) - 1 )) > 0 ){
+				buffer[count] = 0;
+				if( (s = safestrchr( buffer, '\n' )) ){
+					if( Write_fd_len( newfd, s+1, count - (s+1-buffer) ) < 0 ) status = -1;
+					break;
+				}
+			}
+		} else {
+			lseek( fd, 0, SEEK_SET );
+		}
+		while( status == 0 && (count = ok_read( fd, buffer, sizeof(buffer) )) > 0 ){
+			if( Write_fd_len( newfd, buffer, count ) < 0 ) status = -1;
+		}
+		if( status == 0 && rename( newfile, file ) == -1 ) status = -1;
+	}
+	if( status ){
+		logerr(LOG_INFO, "Copy_status_tail: cannot copy to '%s'", file );
+		unlink( newfile );
+	}
+	if( newfd >= 0 ) close( newfd );
+	free( newfile );
+	return( status );
+}
 
-	tempfd = status = -1;
+/*
+ * Trim_status_file - trim a status file to an acceptible length
+ *
+ *  The file is kept as two segments: FILE, which writers append to,
+ *  and FILE.0 holding the previous segment.  When FILE grows past the
+ *  segment size it is linked to FILE.0 and a new empty file is renamed
+ *  into place, so nothing is copied and readers never see a truncated
+ *  file.  Only the process that gets the lock on FILE does the rotate;
+ *  everybody else just reopens.  If FILE is more than two segments,
+ *  as when the limit was lowered,  only its last segment is copied to
+ *  FILE.0 so the size limit still holds.
+ *  Returns: fd open for appending to the current segment
+ */
+
+int Trim_status_file( int status_fd, char *file, int max, int min )
+{
+	int fd, newfd, oldfd, seg;
+	struct stat statb, fstatb;
+	char *oldfile, *newfile;
 
 	DEBUG1("Trim_status_file: file '%s' max %d, min %d", file, max, min);
 
 	/* if the file does not exist, do not create it */
 	if( ISNULL(file) ) return( status_fd );
 	if( stat( file, &statb ) == 0 ){
-		DEBUG1("Trim_status_file: '%s' max %d, min %d, size %ld", file, max, min, 
+		seg = Status_segment_size( max, min );
+		DEBUG1("Trim_status_file: '%s' segment %d, size %ld", file, seg, 
 			(long)(statb.st_size) );
-		if( max > 0 && statb.st_size/1024 > max ){
-			status = Checkwrite( file, &statb,O_RDWR,0,0);
-			tempfd = Make_temp_fd(&tempfile);
-			if( min > max || min == 0 ){
-				min = max/4;
-			}
-			if( min == 0 ) min = 1;
-			DEBUG1("Trim_status_file: trimming to %d K", min);
-			lseek( status, 0, SEEK_SET );
-			lseek( status, -min*1024, SEEK_END );
-			while( (count = ok_read( status, buffer, sizeof(buffer) - 1 ) ) > 0 ){
-				buffer[count] = 0;
-				if( (s = safestrchr(buffer,'\n')) ){
-					*s++ = 0;
-					Write_fd_str( tempfd, s );
-					break;
-				}
-			}
-			while( (count = ok_read( status, buffer, sizeof(buffer) ) ) > 0 ){
-				if( write( tempfd, buffer, count) < 0 ){
-					Errorcode = JABORT;
-					logerr_die(LOG_ERR, "Trim_status_file: cannot write tempfile" );
-				}
-			}
-			lseek( tempfd, 0, SEEK_SET );
-			lseek( status, 0, SEEK_SET );
-			ftruncate( status, 0 );
-			while( (count = ok_read( tempfd, buffer, sizeof(buffer) ) ) > 0 ){
-				if( write( status, buffer, count) < 0 ){
-					Errorcode = JABORT;
-					logerr_die(LOG_ERR, "Trim_status_file: cannot write tempfile" );
+		if( seg > 0 && statb.st_size/1024 > seg
+			&& (fd = Checkwrite( file, &fstatb, 0, 0, 0 )) >= 0 ){
+			if( Do_lock( fd, 0 ) == 0 && stat( file, &statb ) == 0
+				&& statb.st_ino == fstatb.st_ino
+				&& statb.st_dev == fstatb.st_dev
+				&& statb.st_size/1024 > seg ){
+				oldfile = safestrdup2( file, STATUS_SEGMENT_SUFFIX, __FILE__,__LINE__ );
+				newfile = safestrdup2( file, ".new", __FILE__,__LINE__ );
+				DEBUG1("Trim_status_file: retiring '%s' to '%s'", file, oldfile);
+				if( (newfd = Checkwrite( newfile, &fstatb, O_RDWR, 1, 0 )) >= 0 ){
+					ftruncate( newfd, 0 );
+					fchmod( newfd, statb.st_mode & 07777 );
+					unlink( oldfile );
+					if( statb.st_size/1024 > 2*seg
+						&& (oldfd = Checkread( file, &fstatb )) >= 0 ){
+						Copy_status_tail( oldfd, oldfile, seg, statb.st_mode );
+						close( oldfd );
+					} else if( link( file, oldfile ) == -1 && rename( file, oldfile ) == -1 ){
+						logerr(LOG_INFO, "Trim_status_file: cannot retire '%s'", file );
+					}
+					if( rename( newfile, file ) == -1 ){
+						logerr(LOG_INFO, "Trim_status_file: rename '%s' to '%s' failed",
+							newfile, file );
+						unlink( newfile );
+					}
+					close( newfd );
 				}
+				if( oldfile ) free( oldfile ); oldfile = 0;
+				if( newfile ) free( newfile ); newfile = 0;
 			}
-			unlink(tempfile);
-			close(status);
+			close( fd );
 		}
-		close( tempfd );
 		if( status_fd > 0 ) close( status_fd );
 		status_fd = Checkwrite( file, &statb,0,0,0);
 	}
 	return( status_fd );
 }
 
+/*
+ * Truncate_status_file - keep only the last size K of a status file,
+ *  and remove the retired segment.  Used by checkpc -t.
+ *  Returns: 1 if the file was changed, 0 if not, -1 on error
+ */
+
+int Truncate_status_file( char *file, int size )
+{
+	struct stat statb;
+	char *oldfile;
+	int fd, status = 0;
+
+	DEBUG1("Truncate_status_file: file '%s' size %d", file, size);
+	if( ISNULL(file) || size <= 0 ) return( 0 );
+	oldfile = safestrdup2( file, STATUS_SEGMENT_SUFFIX, __FILE__,__LINE__ );
+	if( unlink( oldfile ) == 0 ) status = 1;
+	free( oldfile );
+	if( stat( file, &statb ) == 0 && statb.st_size/1024 >= size ){
+		if( (fd = Checkread( file, &statb )) < 0 ) return( -1 );
+		if( Copy_status_tail( fd, file, size, statb.st_mode ) == 0 ){
+			status = 1;
+		} else {
+			status = -1;
+		}
+		close( fd );
+	}
+	return( status );
+}
+
+/*
+ * Get_status_file_image - image of the last maxsize K of a status file,
+ *  taking the start from the retired segment if the current one is short
+ */
+
+char *Get_status_file_image( const char *file, off_t maxsize )
+{
+	char *s, *old, *oldfile;
+	off_t len;
+
+	if( file == 0 ) return(0);
+	s = Get_file_image( file, maxsize );
+	len = safestrlen(s);
+	if( maxsize == 0 || len < maxsize*1024 ){
+		oldfile = safestrdup2( file, STATUS_SEGMENT_SUFFIX, __FILE__,__LINE__ );
+		if( maxsize ) maxsize -= len/1024;
+		if( (old = Get_file_image( oldfile, maxsize )) ){
+			if( s ){
+				char *t = safestrdup2( old, s, __FILE__,__LINE__ );
+				free( s );
+				free( old );
+				s = t;
+			} else {
+				s = old;
+			}
+		}
+		free( oldfile );
+	}
+	return( s );
+}
+
 /********************************************************************
  * BSD and LPRng order
  * We use these values to determine the order of jobs in the file
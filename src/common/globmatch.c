@@ -12,95 +12,240 @@
 
 /**** ENDINCLUDE ****/
 
-static int glob_pattern( const char *pattern, const char *str )
+/*
+ * Glob patterns
+ *
+ *  The patterns are used for the permissions, printcap wildcards and
+ *  job selection, and the old matcher backtracked on each '*', which
+ *  could take exponential time.  A pattern is now compiled into a list
+ *  of elements that each match one character, with a flag for each gap
+ *  between the elements that has a '*' in it.
+ *
+ *   xxx   - each character matches itself, ignoring case
+ *   ?     - matches any character
+ *   [...] - matches the characters or N-M ranges in the brackets,
+ *           or with [^...] the ones not in them.  Case is not ignored.
+ *   *     - matches any string
+ *  A pattern with a '[' and no ']' matches nothing.
+ *
+ *  The string is then matched a character at a time with the bit
+ *  parallel (shift-and) method: bit k of the state is set when the
+ *  first k elements have matched, so the time is linear in the string.
+ *
+ *  The compiled patterns are kept in a hash table keyed by the whole
+ *  pattern,  so a permissions file or printcap list is compiled once.
+ *  When the table is full a new pattern is compiled for each use.
+ */
+
+#define GLOB_BITS ((int)(8*sizeof(unsigned long)))
+#define GLOB_HASH 1024	/* hash chains */
+#define GLOB_CACHE 4096	/* most patterns kept */
+#define GLOB_STATE 8	/* state words on the stack */
+
+struct glob {
+	struct glob *next;		/* hash chain */
+	char *pattern;
+	int nomatch;			/* unterminated '[' */
+	int words;				/* words in a state */
+	int final;				/* number of elements, the bit for a match */
+	unsigned long *star;	/* gaps with a '*' */
+	unsigned long *accept;	/* for each char, the elements that accept it */
+};
+
+static struct glob *Glob_cache[GLOB_HASH];
+static int Glob_count;
+
+/* the characters that match c ignoring case, as a ring through Glob_same */
+static unsigned char Glob_same[256];
+static int Glob_folded;
+
+#define GLOB_SET(v,n) ((v)[(n)/GLOB_BITS] |= (1UL << ((n)%GLOB_BITS)))
+#define GLOB_ISSET(v,n) ((v)[(n)/GLOB_BITS] & (1UL << ((n)%GLOB_BITS)))
+
+static void Glob_fold_init( void )
 {
-	int result = 1;
-	int len, c, invert;
-	char *glob;
-
-	/* DEBUG4("glob_pattern: pattern '%s' to '%s'", pattern, str ); */
-	if( (glob = safestrpbrk( pattern, "*?[" )) ){
-		/* check the characters up to the glob length for a match */
-		len = glob - pattern;
-		c = *glob;
-	 	/* DEBUG4("glob_pattern: meta '%c', len %d", c, len ); */
-		if( (len == 0 || !safestrncasecmp( pattern, str, len )) ){
-			/* matched: pattern xxxx*  to xxxx
-			 * now we have to do the remainder. We simply check for rest
-			 */
-			pattern += len+1;
-			str += len;
-			/* DEBUG4("glob_pattern: rest of pattern '%s', str '%s'", pattern, str ); */
-			/* check for trailing glob */
-			if( c == '?' ){
-				if( *str ){
-					result = glob_pattern( pattern, str+1 ); 
-				} else {
-					result = 1;
-				}
-			} else if( c == '[' ){
-				/* now we check for the characters in the pattern
-				 * this can have the format N or N-M
-				 */
-				glob = safestrchr( pattern, ']' );
-				if( glob == 0 ){
-					return( 1 );
-				}
-				len = glob - pattern;
-				invert = c = 0;
-				/* DEBUG4("globmatch: now case '%s', len %d", pattern, len ); */
-				if( len > 0 && (invert = (*pattern == '^')) ){
-					--len; ++pattern;
-				}
-				while( result && len > 0 ){
-					/* DEBUG4("globmatch: c '0x%x', pat '%c', str '%c'",
-						c, *pattern, *str ); */
-					if( c && *pattern == '-' && len > 1 ){
-						/* we have preceeding, get end */
-						pattern++; --len;
-						while( result && c <= *pattern ){
-					/* DEBUG4("globmatch: range c '%c', pat '%c', str '%c'",
-								c, *pattern, *str ); */
-							result = (*str != c++);
-						}
-						pattern++; --len;
-						c = 0;
-					} else {
-						c = *pattern++; --len;
-						result = (*str != c);
-					}
-				}
-				if( invert ) result = !result;
-				/* DEBUG4("globmatch: after pattern result %d", result); */
-				if( result == 0 ){
-					pattern += len+1;
-					++str;
-					/* at this point pattern is past */
-					result = glob_pattern( pattern, str );
-				}
-			} else if( pattern[0] ){
-				while( *str && (result = glob_pattern( pattern, str )) ){
-					++str;
+	int c, d, fold[256];
+
+	Glob_folded = 1;
+	for( c = 0; c < 256; ++c ){
+		fold[c] = isupper(c) ? tolower(c) : c;
+		Glob_same[c] = c;
+	}
+	for( c = 1; c < 256; ++c ){
+		for( d = c+1; d < 256 && fold[d] != fold[c]; ++d );
+		if( d < 256 ){
+			/* put d in the ring of c */
+			Glob_same[d] = Glob_same[c];
+			Glob_same[c] = d;
+		}
+	}
+}
+
+static void Free_glob( struct glob *g )
+{
+	if( g ){
+		if( g->pattern ) free( g->pattern );
+		if( g->star ) free( g->star );
+		if( g->accept ) free( g->accept );
+		free( g );
+	}
+}
+
+static struct glob *Compile_glob( const char *pattern )
+{
+	struct glob *g;
+	const unsigned char *s, *end;
+	char in_class[256];
+	int n, c, first, last, invert, len;
+
+	g = malloc_or_die( sizeof(g[0]),__FILE__,__LINE__ );
+	memset( g, 0, sizeof(g[0]) );
+	g->pattern = safestrdup( pattern,__FILE__,__LINE__ );
+
+	/* each character makes at most one element */
+	g->words = (safestrlen( pattern ) + GLOB_BITS) / GLOB_BITS;
+	len = g->words * sizeof(g->star[0]);
+	g->star = malloc_or_die( len,__FILE__,__LINE__ );
+	memset( g->star, 0, len );
+	len = 256 * g->words * sizeof(g->accept[0]);
+	g->accept = malloc_or_die( len,__FILE__,__LINE__ );
+	memset( g->accept, 0, len );
+
+	for( n = 0, s = (const unsigned char *)pattern; *s; ++n ){
+		if( *s == '*' ){
+			GLOB_SET( g->star, n );
+			++s;
+			--n;
+			continue;
+		}
+		memset( in_class, 0, sizeof(in_class) );
+		invert = 0;
+		if( *s == '?' ){
+			invert = 1;
+			++s;
+		} else if( *s == '[' ){
+			++s;
+			if( !(end = (const unsigned char *)safestrchr( (const char *)s, ']' )) ){
+				g->nomatch = 1;
+				break;
+			}
+			if( s < end && *s == '^' ){
+				invert = 1;
+				++s;
+			}
+			/* N or N-M, and a '-' at the start or end is itself;
+			 * N is in the class even if M is before it */
+			for( ; s < end; ++s ){
+				first = last = *s;
+				if( s+2 < end && s[1] == '-' ){
+					last = s[2];
+					s += 2;
 				}
-			} else {
-				result = 0;
+				in_class[first] = 1;
+				for( c = first; c <= last; ++c ) in_class[c] = 1;
 			}
+			++s;
+		} else {
+			first = c = *s++;
+			do{
+				GLOB_SET( g->accept + c*g->words, n );
+			} while( (c = Glob_same[c]) != first );
+			continue;
 		}
-	} else {
-		result = safestrcasecmp( pattern, str );
+		for( c = 1; c < 256; ++c ){
+			if( in_class[c] != invert ){
+				GLOB_SET( g->accept + c*g->words, n );
+			}
+		}
+	}
+	g->final = n;
+	DEBUG4("Compile_glob: '%s' elements %d, words %d, nomatch %d",
+		pattern, g->final, g->words, g->nomatch );
+	return( g );
+}
+
+/*
+ * Find_glob - get the compiled pattern from the cache,
+ *  compiling it and adding it if it is not there.
+ *  *cached is set to 0 if the caller has to free it.
+ */
+
+static struct glob *Find_glob( const char *pattern, int *cached )
+{
+	unsigned int h = 2166136261U;
+	const char *s;
+	struct glob *g;
+
+	for( s = pattern; *s; ++s ) h = (h ^ (unsigned char)*s) * 16777619U;
+	h %= GLOB_HASH;
+	for( g = Glob_cache[h]; g; g = g->next ){
+		if( !strcmp( g->pattern, pattern ) ) break;
 	}
+	*cached = 1;
+	if( g == 0 ){
+		if( !Glob_folded ) Glob_fold_init();
+		g = Compile_glob( pattern );
+		if( Glob_count < GLOB_CACHE ){
+			g->next = Glob_cache[h];
+			Glob_cache[h] = g;
+			++Glob_count;
+		} else {
+			*cached = 0;
+		}
+	}
+	return( g );
+}
+
+/*
+ * Match_glob - returns 0 if the string matches
+ */
+
+static int Match_glob( struct glob *g, const char *str )
+{
+	unsigned long state_buf[GLOB_STATE], *state = state_buf, *accept,
+		carry, next, any;
+	const unsigned char *s;
+	int i, result;
+
+	if( g->nomatch ) return( 1 );
+	if( g->words > GLOB_STATE ){
+		state = malloc_or_die( g->words * sizeof(state[0]),__FILE__,__LINE__ );
+	}
+	memset( state, 0, g->words * sizeof(state[0]) );
+	state[0] = 1;
+	for( s = (const unsigned char *)str; *s; ++s ){
+		accept = g->accept + (*s)*g->words;
+		any = carry = 0;
+		for( i = 0; i < g->words; ++i ){
+			/* advance over an accepting element, or stay in a '*' gap */
+			next = state[i] & accept[i];
+			state[i] = (next << 1) | carry | (state[i] & g->star[i]);
+			carry = next >> (GLOB_BITS - 1);
+			any |= state[i];
+		}
+		if( !any ) break;
+	}
+	result = !GLOB_ISSET( state, g->final );
+	if( state != state_buf ) free( state );
 	return( result );
 }
 
 int Globmatch( const char *pattern, const char *str )
 {
-	int result;
+	struct glob *g;
+	int result, cached;
 
 	/* try simple test first: string compare */
 	/* DEBUG4("Globmatch: pattern '%s' to '%s'", pattern, str ); */
 	if( pattern == 0 ) pattern = "";
 	if( str == 0 ) str = "";
-	result = glob_pattern( pattern, str );
+	if( !safestrpbrk( pattern, "*?[" ) ){
+		result = safestrcasecmp( pattern, str );
+	} else {
+		g = Find_glob( pattern, &cached );
+		result = Match_glob( g, str );
+		if( !cached ) Free_glob( g );
+	}
 	DEBUG4("Globmatch: '%s' to '%s' result %d", pattern, str, result );
 	return( result );
 }
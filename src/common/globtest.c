@@ -0,0 +1,116 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "globmatch.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Glob pattern tests
+ *  Checks Globmatch() against a table of patterns and strings,  the
+ *  same as the old backtracking matcher gave.  Each pattern is tried
+ *  twice so the cached compiled pattern is checked as well.
+ *  Exits 0 if all of them pass.
+ *
+ *  globtest [-v]
+ */
+
+static struct glob_test {
+	const char *pattern, *str;
+	int match;
+} Glob_tests[] = {
+	/* plain strings ignore case */
+	{ "", "", 1 },
+	{ "", "a", 0 },
+	{ "abc", "abc", 1 },
+	{ "abc", "ABC", 1 },
+	{ "abc", "abcd", 0 },
+	/* * and ? */
+	{ "*", "", 1 },
+	{ "*", "anything", 1 },
+	{ "a*", "a", 1 },
+	{ "a*", "ABCDEF", 1 },
+	{ "a*", "ba", 0 },
+	{ "*c", "abc", 1 },
+	{ "*c", "abcd", 0 },
+	{ "a*c", "ac", 1 },
+	{ "a*c", "abbbc", 1 },
+	{ "a*c", "abbbd", 0 },
+	{ "**a", "a", 1 },
+	{ "a**b", "ab", 1 },
+	{ "?", "", 0 },
+	{ "?", "x", 1 },
+	{ "?", "xy", 0 },
+	{ "a?c", "abc", 1 },
+	{ "a?c", "ac", 0 },
+	{ "*?", "", 0 },
+	{ "*?", "z", 1 },
+	{ "?*?", "z", 0 },
+	{ "?*?", "zz", 1 },
+	/* host and job names */
+	{ "*.example.com", "host.example.com", 1 },
+	{ "*.example.com", "HOST.Example.COM", 1 },
+	{ "*.example.com", "example.com", 0 },
+	{ "host*.example.com", "host12.example.com", 1 },
+	{ "host*.example.com", "host12.example.org", 0 },
+	{ "*a*b*c*", "xxaxxbxxcxx", 1 },
+	{ "*a*b*c*", "xxcxxbxxaxx", 0 },
+	{ "*a*a*a*a*a*a*a*b", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", 0 },
+	{ "*a*a*a*a*a*a*a*b", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab", 1 },
+	/* classes do not ignore case */
+	{ "[abc]", "b", 1 },
+	{ "[abc]", "B", 0 },
+	{ "[abc]", "d", 0 },
+	{ "[a-c]x", "bx", 1 },
+	{ "[a-c]x", "dx", 0 },
+	{ "[^a-z]", "A", 1 },
+	{ "[^a-z]", "q", 0 },
+	{ "[^a-z]*", "1abc", 1 },
+	{ "pr[0-9][0-9]", "pr42", 1 },
+	{ "pr[0-9][0-9]", "pr4x", 0 },
+	{ "[-a]", "-", 1 },
+	{ "[a-]", "-", 1 },
+	{ "[z-a]", "z", 1 },
+	{ "[z-a]", "m", 0 },
+	{ "[]", "x", 0 },
+	{ "a[", "a", 0 },
+	{ "a[", "a[", 0 },
+	{ "*[0-9]", "lp7", 1 },
+	{ "*[0-9]", "lp", 0 },
+	/* a pattern longer than one state word */
+	{ "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*0*1*2*3*4*5*6*7*8*9",
+		"abcdefghijklmnopqrstuvwxyz0123456789", 1 },
+	{ "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*0*1*2*3*4*5*6*7*8*9",
+		"abcdefghijklmnopqrstuvwxyz012345678", 0 },
+	{ 0, 0, 0 }
+};
+
+int main( int argc, char *argv[] )
+{
+	struct glob_test *t;
+	int pass, result, failed = 0, count = 0, verbose;
+
+	verbose = ( argc > 1 && !strcmp( argv[1], "-v" ) );
+	for( pass = 0; pass < 2; ++pass ){
+		for( t = Glob_tests; t->pattern; ++t ){
+			++count;
+			result = !Globmatch( t->pattern, t->str );
+			if( result != t->match ){
+				++failed;
+				FPRINTF( STDERR, "globtest: '%s' to '%s' gave %d, expected %d\n",
+					t->pattern, t->str, result, t->match );
+			} else if( verbose ){
+				FPRINTF( STDOUT, "globtest: '%s' to '%s' %d\n",
+					t->pattern, t->str, result );
+			}
+		}
+	}
+	FPRINTF( STDOUT, "globtest: %d tests, %d failed\n", count, failed );
+	return( failed != 0 );
+}
@@ -2482,6 +2482,407 @@ void Split_cmd_line( struct line_list *l, char *line )
 	if(DEBUGL1){ Dump_line_list("Split_cmd_line", l ); }
 }
 
+/***************************************************************************
+ * void Fix_dollars( struct line_list *l, struct job *job,
+ *   int nosplit, char *flags )
+ * Note: see the code for the keys!
+ * replace
+ *  \x with x except for \r,\n,\t, -> space
+ *  \nnn with nnn
+ *  $*   with flag string, and then evaluate options
+ *  $X   with -X<value>
+ *  $0X  with -X <value>
+ *  $-X  with  <value>
+ *  $0-X with  <value> (same as $-X)
+ *  ${s}   with value of control file parameter s (must be upper case)
+ *  ${ss}  with value of printcap option ss
+ *  $'{ss} with quoted value of printcap option ss
+ *
+ *  nosplit - do not split the option value over two entries
+ *  flags -   flags to use for $*
+ *
+ * The strings are first compiled into a template: a list of words,
+ *  each made of literal text and the $X and ${ss} values to put in.
+ *  The escapes and $* are done when compiling,  so expanding the
+ *  template only looks up the values and copies them into the words.
+ *  Make_passthrough() keeps the templates for the filter command lines,
+ *  so a filter command line is only parsed once by a process.
+ ***************************************************************************/
+
+#define DOLLAR_WORD 0	/* start of a word */
+#define DOLLAR_TEXT 1	/* literal text */
+#define DOLLAR_KEY 2	/* $X */
+#define DOLLAR_NAME 3	/* ${ss} */
+#define DOLLAR_STARS 100	/* $* in the flags for $* ... */
+
+struct dollar_op {
+	int type;
+	int key;			/* X in $X */
+	int notag, space;	/* $-X and $0X */
+	int len;			/* of text */
+	char *text;			/* literal text or ss in ${ss} */
+};
+
+struct dollar_template {
+	char *line, *flags, *shell;	/* Make_passthrough() cache key */
+	int root;					/* 'root' in the filter command */
+	int nosplit;
+	int count, max;
+	struct dollar_op *op;
+};
+
+static void Free_dollar_template( struct dollar_template *t )
+{
+	int i;
+	if( t ){
+		for( i = 0; i < t->count; ++i ){
+			if( t->op[i].text ) free( t->op[i].text );
+		}
+		if( t->op ) free( t->op );
+		if( t->line ) free( t->line );
+		if( t->flags ) free( t->flags );
+		if( t->shell ) free( t->shell );
+		free( t );
+	}
+}
+
+static struct dollar_op *Add_dollar_op( struct dollar_template *t, int type,
+	const char *text, int len )
+{
+	struct dollar_op *op;
+
+	/* literal text is joined to the text before it */
+	if( type == DOLLAR_TEXT && t->count
+		&& (op = &t->op[t->count-1])->type == DOLLAR_TEXT ){
+		op->text = realloc_or_die( op->text, op->len+len+1,__FILE__,__LINE__);
+		memcpy( op->text+op->len, text, len );
+		op->len += len;
+		op->text[op->len] = 0;
+		return( op );
+	}
+	if( t->count >= t->max ){
+		t->max = 2*t->max + 16;
+		t->op = realloc_or_die( t->op, t->max*sizeof(t->op[0]),__FILE__,__LINE__);
+	}
+	op = &t->op[t->count++];
+	memset( op, 0, sizeof(op[0]) );
+	op->type = type;
+	if( text ){
+		op->text = malloc_or_die( len+1,__FILE__,__LINE__);
+		memcpy( op->text, text, len );
+		op->text[len] = 0;
+		op->len = len;
+	}
+	return( op );
+}
+
+static void Compile_dollar_word( struct dollar_template *t, const char *word,
+	const char *flags )
+{
+	const char *s, *p;
+	char *expanded = 0, *v;
+	char tag[4];
+	int c, space, notag, stars = 0;
+	struct dollar_op *op;
+
+	for( s = word; (p = safestrpbrk( s, "$\\" )); ){
+		if( p > s ) Add_dollar_op( t, DOLLAR_TEXT, s, p - s );
+		s = p+1;
+		if( *p == '\\' ){
+			c = cval(s);
+			/* check for end of string */
+			if( c == 0 ){ s = 0; break; }
+			++s;
+			if( c == 'r' || c == 'n' || c == 't' ){
+				c = ' ';
+			} else if( isdigit( c ) ){
+				tag[0] = c;
+				if( (tag[1] = *s) ) ++s;
+				if( (tag[2] = *s) ) ++s;
+				tag[3] = 0;
+				c = strtol( tag, 0, 8 );
+			}
+			if( !isprint(c) || isspace(c) ) c = ' ';
+			tag[0] = c;
+			Add_dollar_op( t, DOLLAR_TEXT, tag, 1 );
+			continue;
+		}
+		/* now we handle the $ */
+		space = notag = 0;
+		while( (c = cval(s)) && safestrchr( " 0-'", c) ){
+			switch( c ){
+			case '0': case ' ': space = 1; break;
+			case '-':           notag = 1; break;
+			default: break;
+			}
+			++s;
+		}
+		if( c == 0 ){ s = 0; break; }
+		if( c == '*' ){
+			/* the flags are put in and then scanned,
+			 * without flags the rest of the word is dropped */
+			if( ISNULL(flags) || ++stars > DOLLAR_STARS ){ s = 0; break; }
+			v = safestrdup2( flags, s+1,__FILE__,__LINE__);
+			if( expanded ) free( expanded );
+			s = expanded = v;
+			continue;
+		} else if( c == '{' ){
+			++s;
+			if( !(p = safestrchr( s, '}' )) ){ s = 0; break; }
+			Add_dollar_op( t, DOLLAR_NAME, s, p - s );
+			s = p+1;
+			continue;
+		}
+		op = Add_dollar_op( t, DOLLAR_KEY, 0, 0 );
+		op->key = c;
+		if( c == 'c' ) notag = 1;
+		op->notag = notag;
+		op->space = notag?0:space;
+		++s;
+	}
+	if( s && *s ) Add_dollar_op( t, DOLLAR_TEXT, s, safestrlen(s) );
+	if( expanded ) free( expanded );
+}
+
+static struct dollar_template *Compile_dollars( struct line_list *l, int nosplit,
+	const char *flags )
+{
+	struct dollar_template *t;
+	int i;
+
+	t = malloc_or_die( sizeof(t[0]),__FILE__,__LINE__);
+	memset( t, 0, sizeof(t[0]) );
+	t->nosplit = nosplit;
+	for( i = 0; i < l->count; ++i ){
+		Add_dollar_op( t, DOLLAR_WORD, 0, 0 );
+		Compile_dollar_word( t, l->list[i], flags );
+	}
+	DEBUG4("Compile_dollars: %d words, %d ops", l->count, t->count );
+	return( t );
+}
+
+/*
+ * the value for $X, 0 if none
+ */
+
+static const char *Dollar_value( int c, struct job *job, char *buffer, int len )
+{
+	const char *str = 0;
+	char *t;
+
+	switch( c ){
+	case 'a': 
+		str = Accounting_file_DYN;
+		if( str && cval(str) == '|' ) str = 0;
+		break;
+	case 'b': str = job?Find_str_value(&job->info,SIZE):0; break;
+	case 'c':
+		t = job?Find_str_value(&job->info,FORMAT):0;
+		if( t && *t == 'l'){
+			str="-c";
+		}
+		break;
+	case 'd': str = Spool_dir_DYN; break;
+	case 'e':
+		str = job?Find_str_value(&job->info, DF_NAME):0;
+		break;
+	case 'f':
+		str = job?Find_str_value(&job->info,"N"):0;
+		break;
+	case 'h':
+		str = job?Find_str_value(&job->info,FROMHOST):0;
+		break;
+	case 'i':
+		str = job?Find_str_value(&job->info,"I"):0;
+		break;
+	case 'j':
+		str = job?Find_str_value(&job->info,NUMBER):0;
+		break;
+	case 'k':
+		str = job?Find_str_value(&job->info,XXCFTRANSFERNAME):0;
+		break;
+	case 'l':
+		plp_snprintf(buffer,len, "%d", Page_length_DYN ); str = buffer; break;
+	case 'n':
+		str = job?Find_str_value(&job->info,LOGNAME):0;
+		break;
+	case 'p': str = RemotePrinter_DYN; break;
+	case 'r': str = RemoteHost_DYN; break;
+	case 's': str = Status_file_DYN; break;
+	case 't':
+		str = Time_str( 0, time( (void *)0 ) ); break;
+	case 'w': plp_snprintf(buffer,len, "%d", Page_width_DYN ); str = buffer; break;
+	case 'x': plp_snprintf(buffer,len, "%d", Page_x_DYN ); str = buffer; break;
+	case 'y': plp_snprintf(buffer,len, "%d", Page_y_DYN ); str = buffer; break;
+	case 'F':
+		str = job?Find_str_value(&job->info,FORMAT):0;
+		break;
+	case 'P': str = Printer_DYN; break;
+	case 'S': str = Comment_tag_DYN; break;
+	/* case '_': str = esc_Auth_client_id_DYN; break; */
+	default:
+		if( isupper(c) ){
+			buffer[1] = 0; buffer[0] = c;
+			str = job?Find_str_value( &job->info,buffer):0;
+		}
+		break;
+	}
+	return( str );
+}
+
+/*
+ * Expand_dollars - put the words of the template,  with the values
+ *  filled in,  on the end of l.  Empty words are left out.
+ */
+
+static void Expand_dollars( struct dollar_template *t, struct job *job,
+	struct line_list *l )
+{
+	struct dollar_op *op, *end;
+	const char *str;
+	char *word = 0;
+	char buffer[SMALLBUFFER], tag[4];
+	int len = 0, max = 0;
+
+	Init_buf( &word, &max, &len );
+	for( op = t->op, end = op + t->count; op < end; ++op ){
+		switch( op->type ){
+		case DOLLAR_WORD:
+			if( len ) Add_line_list( l, word, 0, 0, 0 );
+			len = 0; word[0] = 0;
+			continue;
+		case DOLLAR_TEXT:
+			Put_buf_len( op->text, op->len, &word, &max, &len );
+			continue;
+		case DOLLAR_NAME:
+			str = op->text;
+			if( !cval(str+1) && isupper(cval(str)) ){
+				str = job?Find_str_value( &job->info,str):0;
+			} else {
+				str = Find_value( &PC_entry_line_list, str );
+			}
+			Put_buf_str( str, &word, &max, &len );
+			continue;
+		}
+		str = Dollar_value( op->key, job, buffer, sizeof(buffer) );
+		if( ISNULL(str) ) continue;
+		tag[0] = '-'; tag[1] = op->key; tag[2] = 0;
+		if( op->notag ){
+			Put_buf_str( str, &word, &max, &len );
+		} else if( op->space ){
+			Put_buf_str( tag, &word, &max, &len );
+			if( t->nosplit ){
+				Put_buf_str( " '", &word, &max, &len );
+				Put_buf_str( str, &word, &max, &len );
+				Put_buf_str( "'", &word, &max, &len );
+			} else {
+				/* the value starts a new word */
+				Add_line_list( l, word, 0, 0, 0 );
+				len = 0; word[0] = 0;
+				Put_buf_str( str, &word, &max, &len );
+			}
+		} else {
+			if( t->nosplit ) Put_buf_str( "'", &word, &max, &len );
+			Put_buf_str( tag, &word, &max, &len );
+			Put_buf_str( str, &word, &max, &len );
+			if( t->nosplit ) Put_buf_str( "'", &word, &max, &len );
+		}
+	}
+	if( len ) Add_line_list( l, word, 0, 0, 0 );
+	free( word );
+}
+
+void Fix_dollars( struct line_list *l, struct job *job, int nosplit, const char *flags )
+{
+	struct dollar_template *t;
+
+	if(DEBUGL4)Dump_line_list("Fix_dollars- before", l );
+	t = Compile_dollars( l, nosplit, flags );
+	Free_line_list( l );
+	Expand_dollars( t, job, l );
+	Free_dollar_template( t );
+	if(DEBUGL4)Dump_line_list("Fix_dollars- after", l );
+}
+
+/*
+ * Find_passthrough - the template for a filter command line
+ *  The templates are kept in a small cache keyed by the command line,
+ *  the flags and the shell,  so that a filter started for each job
+ *  is not parsed again.
+ */
+
+#define PASSTHROUGH_CACHE 16
+static struct dollar_template *Passthrough_cache[PASSTHROUGH_CACHE];
+
+static struct dollar_template *Find_passthrough( char *line, const char *flags )
+{
+	struct dollar_template **t;
+	struct line_list cmd;
+	const char *p, *shell = Shell_DYN;
+	char *s, *v;
+	unsigned int h = 0;
+	int c, noopts, root;
+
+	if( flags == 0 ) flags = "";
+	if( shell == 0 ) shell = "";
+	for( p = line; p && *p; ++p ) h = h * 31 + (unsigned char)*p;
+	for( p = flags; *p; ++p ) h = h * 31 + (unsigned char)*p;
+	t = &Passthrough_cache[h % PASSTHROUGH_CACHE];
+	if( *t && !safestrcmp( (*t)->line, line ) && !strcmp( (*t)->flags, flags )
+		&& !strcmp( (*t)->shell, shell ) ){
+		DEBUG4("Find_passthrough: cached '%s'", line );
+		return( *t );
+	}
+	Free_dollar_template( *t );
+	*t = 0;
+
+	Init_line_list(&cmd);
+	s = line;
+	while( isspace(cval(s)) ) ++s;
+	if( cval(s) == '|' ) ++s;
+	noopts = root = 0;
+	while( cval(s) ){
+		while( isspace(cval(s)) ) ++s;
+		if( !safestrncmp(s,"$-", 2)
+			||	!safestrncmp(s,"-$", 2) ){
+			noopts = 1;
+			s += 2;
+		} else if( !safestrncasecmp(s,"root", 4) ){
+			/* only set to root if it is the LPD server */
+			root = 1;
+			s += 4;
+		} else {
+			break;
+		}
+	}
+
+	c = cval(s);
+	if( strpbrk(s, "<>|;") || c == '(' ){
+		Add_line_list( &cmd, shell, 0, 0, 0 );
+		Add_line_list( &cmd, "-c", 0, 0, 0 );
+		if( c != '(' ){
+			v = safestrdup3("( ",s," )",__FILE__,__LINE__);
+			Add_line_list( &cmd, v, 0, 0, 0 );
+			free( v );
+		} else {
+			Add_line_list( &cmd, s, 0, 0, 0 );
+		}
+		*t = Compile_dollars( &cmd, 1, flags );
+	} else {
+		Split_cmd_line(&cmd, s);
+		if( !noopts ){
+			Split(&cmd, flags, Whitespace, 0,0, 0, 0, 0,0);
+		}
+		*t = Compile_dollars( &cmd, 0, flags );
+	}
+	Free_line_list(&cmd);
+	(*t)->line = safestrdup( line,__FILE__,__LINE__);
+	(*t)->flags = safestrdup( flags,__FILE__,__LINE__);
+	(*t)->shell = safestrdup( shell,__FILE__,__LINE__);
+	(*t)->root = root;
+	return( *t );
+}
+
 /***************************************************************************
  * Make_passthrough
  *   
@@ -2496,11 +2897,12 @@ void Split_cmd_line( struct line_list *l, char *line )
 int Make_passthrough( char *line, const char *flags, struct line_list *passfd,
 	struct job *job, struct line_list *env_init )
 {
-	int c, i, pid = -1, noopts, root, newfd, fd;
+	int c, i, pid = -1, root, newfd, fd;
 	struct line_list cmd;
 	struct line_list env;
 	char error[SMALLBUFFER];
 	char *s;
+	struct dollar_template *t;
 
 	DEBUG1("Make_passthrough: cmd '%s', flags '%s'", line, flags );
 	if( job ){
@@ -2515,43 +2917,9 @@ int Make_passthrough( char *line, const char *flags, struct line_list *passfd,
 	}
 	Init_line_list(&cmd);
 
-	while( isspace(cval(line)) ) ++line;
-	if( cval(line) == '|' ) ++line;
-	noopts = root = 0;
-	while( cval(line) ){
-		while( isspace(cval(line)) ) ++line;
-		if( !safestrncmp(line,"$-", 2)
-			||	!safestrncmp(line,"-$", 2) ){
-			noopts = 1;
-			line += 2;
-		} else if( !safestrncasecmp(line,"root", 4) ){
-			/* only set to root if it is the LPD server */
-			root = Is_server;
-			line += 4;
-		} else {
-			break;
-		}
-	}
-
-	c = cval(line);
-	if( strpbrk(line, "<>|;") || c == '(' ){
-		Add_line_list( &cmd, Shell_DYN, 0, 0, 0 );
-		Add_line_list( &cmd, "-c", 0, 0, 0 );
-		Add_line_list( &cmd, line, 0, 0, 0 );
-		if( c != '(' ){
-			s = cmd.list[cmd.count-1];
-			s = safestrdup3("( ",s," )",__FILE__,__LINE__);
-			if( cmd.list[cmd.count-1] ) free( cmd.list[cmd.count-1] );
-			cmd.list[cmd.count-1] = s;
-		}
-		Fix_dollars(&cmd, job, 1, flags);
-	} else {
-		Split_cmd_line(&cmd, line);
-		if( !noopts ){
-			Split(&cmd, flags, Whitespace, 0,0, 0, 0, 0,0);
-		}
-		Fix_dollars(&cmd, job, 0, flags);
-	}
+	t = Find_passthrough( line, flags );
+	Expand_dollars( t, job, &cmd );
+	root = t->root?Is_server:0;
 
 	Check_max(&cmd,1);
 	cmd.list[cmd.count] = 0;
@@ -3029,224 +3397,6 @@ void Fix_Z_opts( struct job *job )
 	Free_line_list(&l);
 }
 
-
-/***************************************************************************
- * void Fix_dollars( struct line_list *l, struct job *job,
- *   int nosplit, char *flags )
- * Note: see the code for the keys!
- * replace
- *  \x with x except for \r,\n,\t, -> space
- *  \nnn with nnn
- *  $*   with flag string, and then evaluate options
- *  $X   with -X<value>
- *  $0X  with -X <value>
- *  $-X  with  <value>
- *  $0-X with  <value> (same as $-X)
- *  ${s}   with value of control file parameter s (must be upper case)
- *  ${ss}  with value of printcap option ss
- *  $'{ss} with quoted value of printcap option ss
- *
- *  nosplit - do not split the option value over two entries
- *  flags -   flags to use for $*
- ***************************************************************************/
-
-void Fix_dollars( struct line_list *l, struct job *job, int nosplit, const char *flags )
-{
-	int i, j, count, space, notag, kind, n, c, position, quote;
-	const char *str;
-	char *strv, *s, *t, *rest;
-	char buffer[SMALLBUFFER], tag[32];
-
-	if(DEBUGL4)Dump_line_list("Fix_dollars- before", l );
-	for( count = 0; count < l->count; ++count ){
-		position = 0;
-		for( strv = l->list[count]; (s = safestrpbrk(strv+position,"$\\")); ){
-			DEBUG4("Fix_dollars: expanding [%d]='%s'", count, strv );
-			position = s - strv;
-			c = cval(s);
-			*s++ = 0;
-			if( c == '\\' ){
-				c = *s++;
-				/* check for end of string */
-				if( c == 0 ) break;
-				if( c == 'r' || c == 'n' || c == 't' ){
-					c = ' ';
-				} else if( isdigit( c ) ){
-					tag[0] = c;
-					if( (tag[1] = *s) ) ++s;
-					if( (tag[2] = *s) ) ++s;
-					tag[3] = 0;
-					c = strtol( tag, 0, 8 );
-				}
-				if( !isprint(c) || isspace(c) ) c = ' ';
-				strv[position] = c;
-				++position;
-				memmove(strv+position,s,safestrlen(s)+1);
-				continue;
-			}
-			/* now we handle the $ */
-			str = 0;
-			rest = 0;
-			n = space = notag = quote = 0;
-			kind = STRING_K;
-			while( (c = cval(s)) && safestrchr( " 0-'", c) ){
-				switch( c ){
-				case '0': case ' ': space = 1; break;
-				case '-':           notag = 1; break;
-				case '\'':          quote = 1; break;
-				default: break;
-				}
-				++s;
-			}
-			rest = s+1;
-			if( c == '*' ){
-				if( flags && *flags ){
-					rest = safestrdup(rest,__FILE__,__LINE__);
-					position = safestrlen(strv);
-					l->list[count] = strv
-						 = safeextend3(strv,flags,rest,__FILE__,__LINE__);
-					if( rest ) free(rest); rest = 0;
-				}
-				continue;
-			} else if( c == '{' ){
-				++s;
-				if( !(rest = safestrchr(rest,'}')) ){
-					break;
-				}
-				*rest++ = 0;
-				if( !cval(s+1) && isupper(cval(s)) ){
-					str = job?Find_str_value( &job->info,s):0;
-				} else {
-					str = Find_value( &PC_entry_line_list, s );
-				}
-				notag = 1;
-				space = 0;
-			} else {
-				quote = 0;
-				switch( c ){
-				case 'a': 
-					str = Accounting_file_DYN;
-					if( str && cval(str) == '|' ) str = 0;
-					break;
-				case 'b': str = job?Find_str_value(&job->info,SIZE):0; break;
-				case 'c':
-					notag = 1; space=0;
-					t = job?Find_str_value(&job->info,FORMAT):0;
-					if( t && *t == 'l'){
-						str="-c";
-					}
-					break;
-				case 'd': str = Spool_dir_DYN; break;
-				case 'e':
-					str = job?Find_str_value(&job->info, DF_NAME):0;
-					break;
-				case 'f':
-					str = job?Find_str_value(&job->info,"N"):0;
-					break;
-				case 'h':
-					str = job?Find_str_value(&job->info,FROMHOST):0;
-					break;
-				case 'i':
-					str = job?Find_str_value(&job->info,"I"):0;
-					break;
-				case 'j':
-					str = job?Find_str_value(&job->info,NUMBER):0;
-					break;
-				case 'k':
-					str = job?Find_str_value(&job->info,XXCFTRANSFERNAME):0;
-					break;
-				case 'l':
-					kind = INTEGER_K; n = Page_length_DYN; break;
-				case 'n':
-					str = job?Find_str_value(&job->info,LOGNAME):0;
-					break;
-				case 'p': str = RemotePrinter_DYN; break;
-				case 'r': str = RemoteHost_DYN; break;
-				case 's': str = Status_file_DYN; break;
-				case 't':
-					str = Time_str( 0, time( (void *)0 ) ); break;
-				case 'w': kind = INTEGER_K; n = Page_width_DYN; break;
-				case 'x': kind = INTEGER_K; n = Page_x_DYN; break;
-				case 'y': kind = INTEGER_K; n = Page_y_DYN; break;
-				case 'F':
-					str = job?Find_str_value(&job->info,FORMAT):0;
-					break;
-				case 'P': str = Printer_DYN; break;
-				case 'S': str = Comment_tag_DYN; break;
-				/* case '_': str = esc_Auth_client_id_DYN; break; */
-				default:
-					if( isupper(c) ){
-						buffer[1] = 0; buffer[0] = c;
-						str = job?Find_str_value( &job->info,buffer):0;
-					}
-					break;
-				}
-			}
-			buffer[0] = 0;
-			tag[0] = 0;
-			switch( kind ){
-			case INTEGER_K:
-				plp_snprintf(buffer,sizeof(buffer), "%d", n );
-				str = buffer;
-				break;
-			}
-			DEBUG4(
-				"Fix_dollars: strv '%s', found '%s', rest '%s', notag %d, space %d",
-				strv, str, rest, notag, space );
-			tag[0] = 0;
-			if( str && !cval(str) ) str = 0;
-			if( quote && !str ) str = "";
-			if( str ){
-				rest = safestrdup(rest,__FILE__,__LINE__);
-				if( notag ){
-					space = 0;
-				} else {
-					i = 0;
-					if( (quote || nosplit) && !space ) tag[i++] = '\'';
-					tag[i++] = '-'; tag[i++] = c; tag[i++] = 0;
-					l->list[count] = strv = safeextend2( strv, tag, __FILE__,__LINE__ );
-					if( !(quote || nosplit) ) tag[0] = 0;
-					tag[1] = 0;
-				}
-				if( space ){
-					DEBUG4("Fix_dollars: space [%d]='%s'", count, l->list[count] );
-					if( quote || nosplit ){
-						position = safestrlen(strv) + safestrlen(str) + 2;
-						l->list[count] =
-							strv = safeextend5( strv," '",str,"'",rest,__FILE__,__LINE__);
-					} else {
-						Check_max(l,2);
-						for( i = l->count; i >= count; --i ){
-							l->list[i+1] = l->list[i];
-						}
-						++l->count;
-						++count;
-						l->list[count] = strv = safestrdup2(str,rest,__FILE__,__LINE__);
-						position = safestrlen(str);
-					}
-				} else {
-					position = safestrlen(strv) + safestrlen(str)+safestrlen(tag);
-					l->list[count] = strv
-						 = safeextend4(strv,str,tag,rest,__FILE__,__LINE__);
-				}
-				if( rest ) free(rest); rest = 0;
-			} else {
-				memmove(strv+position,rest,safestrlen(rest)+1);
-			}
-			DEBUG4("Fix_dollars: [%d]='%s'", count, strv );
-		}
-	}
-	for( i = j = 0; i < l->count; ++i ){
-		if( (s = l->list[i]) && *s == 0 ){
-			free(s); s = 0;
-		}
-		l->list[j] = s;
-		if( s ) ++j;
-	}
-	l->count = j;
-	if(DEBUGL4)Dump_line_list("Fix_dollars- after", l );
-}
-
 /*
  * char *Make_pathname( char *dir, char *file )
  *  - makes a full pathname from the dir and file part
@@ -737,7 +737,7 @@ int Unix_link_listen( char *unix_socket_path )
 	 * Get the destination host address and remote port number to connect to.
 	 */
 	DEBUGF(DNW1)("Unix_link_listen: using unix socket");
-	safestrncpy( sunaddr.sun_path, Unix_socket_path_DYN );
+	safestrncpy( sunaddr.sun_path, unix_socket_path );
 #ifdef AF_LOCAL
 	sunaddr.sun_family = AF_LOCAL;
 #else
@@ -762,7 +762,7 @@ int Unix_link_listen( char *unix_socket_path )
 	umask(omask);
 	if( status ){
 		DEBUGF(DNW4)("Unix_link_listen: bind to unix port %s failed '%s'",
-			Unix_socket_path_DYN, Errormsg(err));
+			unix_socket_path, Errormsg(err));
 		if( sock >= 0 ){
 			(void)close( sock );
 			sock = -1;
@@ -10,6 +10,7 @@
 #include <config.h>
 #include "portable.h"
 #include "plp_snprintf.h"
+#include "banner.h"
 
 /***************************************************************************
  *  Filter template and frontend.
@@ -96,19 +97,6 @@ static char *bnrname, *comment;
 static int special;
 static char *queuename, *errorfile;
 
-#define GLYPHSIZE 15
-struct glyph{
-	int ch, x, y;	/* baseline location relative to x and y position */
-	char bits[GLYPHSIZE];
-};
-
-struct font{
-	int height;	/* height from top to bottom */
-	int width;	/* width in pixels */
-	int above;	/* max height above baseline */
-	const struct glyph *glyph;	/* glyphs */
-};
-
 static void banner( void );
 static void getargs( int argc, char *argv[], char *envp[] );
 /* VARARGS2 */
@@ -232,1262 +220,37 @@ static void getargs( int argc, char *argv[], char *envp[] )
 		FPRINTF(STDERR, "RUID: %d, EUID: %d\n", (int)getuid(), (int)geteuid() );
 	}
 }
-/***************************************************************************
-Commentary
-Patrick Powell Wed Jun  7 19:42:01 PDT 1995
-
-The font information is provided as entries in a data structure.
-
-The struct font{} entry specifies the character heights and widths,
-as well as the number of lines needed to display the characters.
-The struct glyph{} array is the set of glyphs for each character.
-
-    
-	{ 
-	X__11___,
-	X__11___,
-	X__11___,
-	X__11___,
-	X__11___,
-	X_______,
-	X_______,
-	X__11___,
-	cX_11___},			/ * ! * /
-
-     ^ lower left corner, i.e. - on baseline - x = 0, y = 8
-
-	{
-	X_______,
-	X_______,
-	X_______,
-	X_111_1_,
-	X1___11_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	cX111_1_,
-	X_____1_,
-	X1____1_,
-	X_1111__},			/ * g * /
-
-     ^ lower left corner, i.e. - on baseline - x = 0, y = 8
-
- ***************************************************************************/
-
-#define X_______ 0
-#define X______1 01
-#define X_____1_ 02
-#define X____1__ 04
-#define X____11_ 06
-#define X___1___ 010
-#define X___1__1 011
-#define X___1_1_ 012
-#define X___11__ 014
-#define X__1____ 020
-#define X__1__1_ 022
-#define X__1_1__ 024
-#define X__11___ 030
-#define X__111__ 034
-#define X__111_1 035
-#define X__1111_ 036
-#define X__11111 037
-#define X_1_____ 040
-#define X_1____1 041
-#define X_1___1_ 042
-#define X_1__1__ 044
-#define X_1_1___ 050
-#define X_1_1__1 051
-#define X_1_1_1_ 052
-#define X_11____ 060
-#define X_11_11_ 066
-#define X_111___ 070
-#define X_111__1 071
-#define X_111_1_ 072
-#define X_1111__ 074
-#define X_1111_1 075
-#define X_11111_ 076
-#define X_111111 077
-#define X1______ 0100
-#define X1_____1 0101
-#define X1____1_ 0102
-#define X1____11 0103
-#define X1___1__ 0104
-#define X1___1_1 0105
-#define X1___11_ 0106
-#define X1__1___ 0110
-#define X1__1__1 0111
-#define X1__11_1 0115
-#define X1__1111 0117
-#define X1_1____ 0120
-#define X1_1___1 0121
-#define X1_1_1_1 0125
-#define X1_1_11_ 0126
-#define X1_111__ 0134
-#define X1_1111_ 0136
-#define X11____1 0141
-#define X11___1_ 0142
-#define X11___11 0143
-#define X11_1___ 0150
-#define X11_1__1 0151
-#define X111_11_ 0166
-#define X1111___ 0170
-#define X11111__ 0174
-#define X111111_ 0176
-#define X1111111 0177
-
-static const struct glyph g9x8[] = {
-	{ ' ', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* */
-
-	{ '!', 0, 8, {
-	X__11___,
-	X__11___,
-	X__11___,
-	X__11___,
-	X__11___,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___}},			/* ! */
-
-	{ '"', 0, 8, {
-	X_1__1__,
-	X_1__1__,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* " */
-
-	{ '#', 0, 8, {
-	X_______,
-	X__1_1__,
-	X__1_1__,
-	X1111111,
-	X__1_1__,
-	X1111111,
-	X__1_1__,
-	X__1_1__,
-	X_______}},			/* # */
-
-	{ '$', 0, 8, {
-	X___1___,
-	X_11111_,
-	X1__1__1,
-	X1__1___,
-	X_11111_,
-	X___1__1,
-	X1__1__1,
-	X_11111_,
-	X___1___}},			/* $ */
-
-	{ '%', 0, 8, {
-	X_1_____,
-	X1_1___1,
-	X_1___1_,
-	X____1__,
-	X___1___,
-	X__1____,
-	X_1___1_,
-	X1___1_1,
-	X_____1_}},			/* % */
-
-	{ '&', 0, 8, {
-	X_11____,
-	X1__1___,
-	X1___1__,
-	X_1_1___,
-	X__1____,
-	X_1_1__1,
-	X1___11_,
-	X1___11_,
-	X_111__1}},			/* & */
-
-	{ '\'', 0, 8, {
-	X___11__,
-	X___11__,
-	X___1___,
-	X__1____,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* ' */
-
-	{ '(', 0, 8, {
-	X____1__,
-	X___1___,
-	X__1____,
-	X__1____,
-	X__1____,
-	X__1____,
-	X__1____,
-	X___1___,
-	X____1__}},			/* ( */
-
-	{ ')', 0, 8, {
-	X__1____,
-	X___1___,
-	X____1__,
-	X____1__,
-	X____1__,
-	X____1__,
-	X____1__,
-	X___1___,
-	X__1____}},			/* ) */
-
-	{ '*', 0, 8, {
-	X_______,
-	X___1___,
-	X1__1__1,
-	X_1_1_1_,
-	X__111__,
-	X_1_1_1_,
-	X1__1__1,
-	X___1___,
-	X_______}},			/* * */
-
-	{ '+', 0, 8, {
-	X_______,
-	X___1___,
-	X___1___,
-	X___1___,
-	X1111111,
-	X___1___,
-	X___1___,
-	X___1___,
-	X_______}},			/* + */
-
-	{ ',', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___,
-	X__1____,
-	X_1_____,
-	X_______}},			/* , */
-
-	{ '-', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X1111111,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* - */
-
-	{ '.', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___}},			/* . */
-
-	{ '/', 0, 8, {
-	X_______,
-	X______1,
-	X_____1_,
-	X____1__,
-	X___1___,
-	X__1____,
-	X_1_____,
-	X1______,
-	X_______}},			/* / */
-
-	{ '0', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X1____11,
-	X1___1_1,
-	X1__1__1,
-	X1_1___1,
-	X11____1,
-	X1_____1,
-	X_11111_}},			/* 0 */
-
-	{ '1', 0, 8, {
-	X___1___,
-	X__11___,
-	X_1_1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X_11111_}},			/* 1 */
-
-	{ '2', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X______1,
-	X_____1_,
-	X__111__,
-	X_1_____,
-	X1______,
-	X1______,
-	X1111111}},			/* 2 */
-
-	{ '3', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X______1,
-	X______1,
-	X__1111_,
-	X______1,
-	X______1,
-	X1_____1,
-	X_11111_}},			/* 3 */
-
-	{ '4', 0, 8, {
-	X_____1_,
-	X____11_,
-	X___1_1_,
-	X__1__1_,
-	X_1___1_,
-	X1____1_,
-	X1111111,
-	X_____1_,
-	X_____1_}},			/* 4 */
-
-	{ '5', 0, 8, {
-	X1111111,
-	X1______,
-	X1______,
-	X11111__,
-	X_____1_,
-	X______1,
-	X______1,
-	X1____1_,
-	X_1111__}},			/* 5 */
-
-	{ '6', 0, 8, {
-	X__1111_,
-	X_1_____,
-	X1______,
-	X1______,
-	X1_1111_,
-	X11____1,
-	X1_____1,
-	X1_____1,
-	X_11111_}},			/* 6 */
-
-	{ '7', 0, 8, {
-	X1111111,
-	X1_____1,
-	X_____1_,
-	X____1__,
-	X___1___,
-	X__1____,
-	X__1____,
-	X__1____,
-	X__1____}},			/* 7 */
-
-	{ '8', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_11111_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_11111_}},			/* 8 */
-
-	{ '9', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_111111,
-	X______1,
-	X______1,
-	X1_____1,
-	X_1111__}},			/* 9 */
-
-	{ ':', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___}},			/* : */
-
-
-	{ ';', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___,
-	X_______,
-	X_______,
-	X__11___,
-	X__11___,
-	X__1____,
-	X_1_____}},			/* ; */
-
-	{ '<', 0, 8, {
-	X____1__,
-	X___1___,
-	X__1____,
-	X_1_____,
-	X1______,
-	X_1_____,
-	X__1____,
-	X___1___,
-	X____1__}},			/* < */
-
-	{ '=', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1111111,
-	X_______,
-	X1111111,
-	X_______,
-	X_______,
-	X_______}},			/* = */
-
-	{ '>', 0, 8, {
-	X__1____,
-	X___1___,
-	X____1__,
-	X_____1_,
-	X______1,
-	X_____1_,
-	X____1__,
-	X___1___,
-	X__1____}},			/* > */
-
-	{ '?', 0, 8, {
-	X__1111_,
-	X_1____1,
-	X_1____1,
-	X______1,
-	X____11_,
-	X___1___,
-	X___1___,
-	X_______,
-	X___1___}},			/* ? */
-
-	{ '@', 0, 8, {
-	X__1111_,
-	X_1____1,
-	X1__11_1,
-	X1_1_1_1,
-	X1_1_1_1,
-	X1_1111_,
-	X1______,
-	X_1____1,
-	X__1111_}},			/* @ */
-
-	{ 'A', 0, 8, {
-	X__111__,
-	X_1___1_,
-	X1_____1,
-	X1_____1,
-	X1111111,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1}},			/* A */
-
-	{ 'B', 0, 8, {
-	X111111_,
-	X_1____1,
-	X_1____1,
-	X_1____1,
-	X_11111_,
-	X_1____1,
-	X_1____1,
-	X_1____1,
-	X111111_}},			/* B */
-
-	{ 'C', 0, 8, {
-	X__1111_,
-	X_1____1,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X_1____1,
-	X__1111_}},			/* C */
-
-	{ 'D', 0, 8, {
-	X11111__,
-	X_1___1_,
-	X_1____1,
-	X_1____1,
-	X_1____1,
-	X_1____1,
-	X_1____1,
-	X_1___1_,
-	X11111__}},			/* D */
-
-	{ 'E', 0, 8, {
-	X1111111,
-	X1______,
-	X1______,
-	X1______,
-	X111111_,
-	X1______,
-	X1______,
-	X1______,
-	X1111111}},			/* E */
-
-	{ 'F', 0, 8, {
-	X1111111,
-	X1______,
-	X1______,
-	X1______,
-	X111111_,
-	X1______,
-	X1______,
-	X1______,
-	X1______}},			/* F */
-
-	{ 'G', 0, 8, {
-	X__1111_,
-	X_1____1,
-	X1______,
-	X1______,
-	X1______,
-	X1__1111,
-	X1_____1,
-	X_1____1,
-	X__1111_}},			/* G */
-
-	{ 'H', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1111111,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1}},			/* H */
-
-	{ 'I', 0, 8, {
-	X_11111_,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X_11111_}},			/* I */
-
-	{ 'J', 0, 8, {
-	X__11111,
-	X____1__,
-	X____1__,
-	X____1__,
-	X____1__,
-	X____1__,
-	X____1__,
-	X1___1__,
-	X_111___}},			/* J */
-
-	{ 'K', 0, 8, {
-	X1_____1,
-	X1____1_,
-	X1___1__,
-	X1__1___,
-	X1_1____,
-	X11_1___,
-	X1___1__,
-	X1____1_,
-	X1_____1}},			/* K */
-
-	{ 'L', 0, 8, {
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1______,
-	X1111111}},			/* L */
-
-	{ 'M', 0, 8, {
-	X1_____1,
-	X11___11,
-	X1_1_1_1,
-	X1__1__1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1}},			/* M */
-
-	{ 'N', 0, 8, {
-	X1_____1,
-	X11____1,
-	X1_1___1,
-	X1__1__1,
-	X1___1_1,
-	X1____11,
-	X1_____1,
-	X1_____1,
-	X1_____1}},			/* N */
-
-	{ 'O', 0, 8, {
-	X__111__,
-	X_1___1_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_1___1_,
-	X__111__}},			/* O */
-
-	{ 'P', 0, 8, {
-	X111111_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X111111_,
-	X1______,
-	X1______,
-	X1______,
-	X1______}},			/* P */
-
-	{ 'Q', 0, 8, {
-	X__111__,
-	X_1___1_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1__1__1,
-	X1___1_1,
-	X_1___1_,
-	X__111_1}},			/* Q */
-
-	{ 'R', 0, 8, {
-	X111111_,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X111111_,
-	X1__1___,
-	X1___1__,
-	X1____1_,
-	X1_____1}},			/* R */
-
-	{ 'S', 0, 8, {
-	X_11111_,
-	X1_____1,
-	X1______,
-	X1______,
-	X_11111_,
-	X______1,
-	X______1,
-	X1_____1,
-	X_11111_}},			/* S */
-
-	{ 'T', 0, 8, {
-	X1111111,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___}},			/* T */
-
-	{ 'U', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_11111_}},			/* U */
-
-	{ 'V', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_1___1_,
-	X_1___1_,
-	X__1_1__,
-	X__1_1__,
-	X___1___,
-	X___1___}},			/* V */
-
-	{ 'W', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X1__1__1,
-	X1__1__1,
-	X1_1_1_1,
-	X11___11,
-	X1_____1}},			/* W */
-
-	{ 'X', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X_1___1_,
-	X__1_1__,
-	X___1___,
-	X__1_1__,
-	X_1___1_,
-	X1_____1,
-	X1_____1}},			/* X */
-
-	{ 'Y', 0, 8, {
-	X1_____1,
-	X1_____1,
-	X_1___1_,
-	X__1_1__,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___}},			/* Y */
-
-	{ 'Z', 0, 8, {
-	X1111111,
-	X______1,
-	X_____1_,
-	X____1__,
-	X___1___,
-	X__1____,
-	X_1_____,
-	X1______,
-	X1111111}},			/* Z */
-
-	{ '[', 0, 8, {
-	X_1111__,
-	X_1_____,
-	X_1_____,
-	X_1_____,
-	X_1_____,
-	X_1_____,
-	X_1_____,
-	X_1_____,
-	X_1111__}},			/* [ */
-
-	{ '\\', 0, 8, {
-	X_______,
-	X1______,
-	X_1_____,
-	X__1____,
-	X___1___,
-	X____1__,
-	X_____1_,
-	X______1,
-	X_______}},			/* \ */
-
-	{ ']', 0, 8, {
-	X__1111_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X__1111_}},			/* ] */
-
-	{ '^', 0, 8, {
-	X___1___,
-	X__1_1__,
-	X_1___1_,
-	X1_____1,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* ^ */
-
-	{ '_', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X1111111,
-	X_______}},			/* _ */
-
-	{ '`', 0, 8, {
-	X__11___,
-	X__11___,
-	X___1___,
-	X____1__,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* ` */
-
-	{ 'a', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_1111__,
-	X_____1_,
-	X_11111_,
-	X1_____1,
-	X1____11,
-	X_1111_1}},			/* a */
-
-	{ 'b', 0, 8, {
-	X1______,
-	X1______,
-	X1______,
-	X1_111__,
-	X11___1_,
-	X1_____1,
-	X1_____1,
-	X11___1_,
-	X1_111__}},			/* b */
-
-	{ 'c', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_1111__,
-	X1____1_,
-	X1______,
-	X1______,
-	X1____1_,
-	X_1111__}},			/* c */
-
-	{ 'd', 0, 8, {
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_111_1_,
-	X1___11_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	X_111_1_}},			/* d */
-
-	{ 'e', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_1111__,
-	X1____1_,
-	X111111_,
-	X1______,
-	X1____1_,
-	X_1111__}},			/* e */
-
-	{ 'f', 0, 8, {
-	X___11__,
-	X__1__1_,
-	X__1____,
-	X__1____,
-	X11111__,
-	X__1____,
-	X__1____,
-	X__1____,
-	X__1____}},			/* f */
-
-	{ 'g', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_111_1_,
-	X1___11_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	X_111_1_,
-	X_____1_,
-	X1____1_,
-	X_1111__}},			/* g */
-
-	{ 'h', 0, 8, {
-	X1______,
-	X1______,
-	X1______,
-	X1_111__,
-	X11___1_,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1____1_}},			/* h */
-
-	{ 'i', 0, 8, {
-	X_______,
-	X___1___,
-	X_______,
-	X__11___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X__111__}},			/* i */
-
-	{ 'j', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X____11_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_____1_,
-	X_1___1_,
-	X__111__}},			/* j */
-
-	{ 'k', 0, 8, {
-	X1______,
-	X1______,
-	X1______,
-	X1___1__,
-	X1__1___,
-	X1_1____,
-	X11_1___,
-	X1___1__,
-	X1____1_}},			/* k */
-
-	{ 'l', 0, 8, {
-	X__11___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X__111__}},			/* l */
-
-	{ 'm', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_1_11_,
-	X11_1__1,
-	X1__1__1,
-	X1__1__1,
-	X1__1__1,
-	X1__1__1}},			/* m */
-
-	{ 'n', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_111__,
-	X11___1_,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1____1_}},			/* n */
-
-	{ 'o', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_1111__,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X_1111__}},			/* o */
-
-
-	{ 'p', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_111__,
-	X11___1_,
-	X1____1_,
-	X1____1_,
-	X11___1_,
-	X1_111__,
-	X1______,
-	X1______,
-	X1______}},			/* p */
-
-	{ 'q', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_111_1_,
-	X1___11_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	X_111_1_,
-	X_____1_,
-	X_____1_,
-	X_____1_}},			/* q */
-
-	{ 'r', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_111__,
-	X11___1_,
-	X1______,
-	X1______,
-	X1______,
-	X1______}},			/* r */
-
-	{ 's', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X_1111__,
-	X1____1_,
-	X_11____,
-	X___11__,
-	X1____1_,
-	X_1111__}},			/* s */
-
-	{ 't', 0, 8, {
-	X_______,
-	X__1____,
-	X__1____,
-	X11111__,
-	X__1____,
-	X__1____,
-	X__1____,
-	X__1__1_,
-	X___11__}},			/* t */
-
-	{ 'u', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	X_111_1_}},			/* u */
-
-	{ 'v', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_____1,
-	X1_____1,
-	X1_____1,
-	X_1___1_,
-	X__1_1__,
-	X___1___}},			/* v */
-
-	{ 'w', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1_____1,
-	X1__1__1,
-	X1__1__1,
-	X1__1__1,
-	X1__1__1,
-	X_11_11_}},			/* w */
-
-	{ 'x', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1____1_,
-	X_1__1__,
-	X__11___,
-	X__11___,
-	X_1__1__,
-	X1____1_}},			/* x */
-
-	{ 'y', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1____1_,
-	X1___11_,
-	X_111_1_,
-	X_____1_,
-	X1____1_,
-	X_1111__}},			/* y */
-
-	{ 'z', 0, 8, {
-	X_______,
-	X_______,
-	X_______,
-	X111111_,
-	X____1__,
-	X___1___,
-	X__1____,
-	X_1_____,
-	X111111_}},			/* z */
-
-	{ '}', 0, 8, {
-	X___11__,
-	X__1____,
-	X__1____,
-	X__1____,
-	X_1_____,
-	X__1____,
-	X__1____,
-	X__1____,
-	X___11__}},			/* } */
-
-	{ '|', 0, 8, {
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___,
-	X___1___}},			/* | */
-
-	{ '}', 0, 8, {
-	X__11___,
-	X____1__,
-	X____1__,
-	X____1__,
-	X_____1_,
-	X____1__,
-	X____1__,
-	X____1__,
-	X__11___}},			/* } */
-
-	{ '~', 0, 8, {
-	X_11____,
-	X1__1__1,
-	X____11_,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______,
-	X_______}},			/* ~ */
-
-	{ 'X', 0, 8, {
-	X_1__1__,
-	X1__1__1,
-	X__1__1_,
-	X_1__1__,
-	X1__1__1,
-	X__1__1_,
-	X_1__1__,
-	X1__1__1,
-	X__1__1_}}			/* rub-out */
-};
-
-/*
-  9 by 8 font:
-  12 rows high, 8 cols wide, 9 lines above baseline
- */
-static const struct font Font9x8 = {
-	12, 8, 9, g9x8 
-};
-
-static void Out_line( void );
-static void breakline( int c );
-static void bigprint( const struct font *font, const char *line );
-static void do_char( const struct font *font, const struct glyph *glyph,
-	char *str, int line, int wid );
 /*
  * Print a banner
  * 
  * banner(): print the banner
- * 1. Allocate a buffer for output string
- * 2. Calculate the various proportions
- *     - topblast 
- *     - topbreak 
- *     - big letters  
- *     - info -          6 lines
- *     - <filler>
- *     - bottombreak
- *     - bottomblast
+ *  The page layout and the big letters are done by Banner_page(),
+ *  which lpd also uses for the built in banner.  The lines are
+ *  collected in outbuf and written out in large pieces.
  */
 
-static char bline[1024];
-static int bigjobnumber, biglogname, bigfromhost, bigjobname;
-static int top_break,	/* break lines at top of page */
-	top_sep,	/* separator from info at top of page */
-	bottom_sep,	/* separator from info at bottom of page */
-	bottom_break;	/* break lines at bottom of page */
-static int breaksize = 3;	/* numbers of rows in break */
+static char outbuf[8*1024];
+static int outlen;
 
-/*
- * userinfo: just p rintf the information
- */
- static void userinfo( void )
+static void Out_flush( void )
 {
-	time_t tmp;
-	time(&tmp);
-	(void) plp_snprintf( bline, sizeof(bline), "User:  %s@%s (%s)", login, host, bnrname);
-	Out_line();
-	strftime(bline,sizeof(bline),"Date: %b %d %H:%M:%S", localtime(&tmp));
-	Out_line();
-	(void) plp_snprintf( bline, sizeof(bline), "Job:   %s", job );
-	Out_line();
-	(void) plp_snprintf( bline, sizeof(bline), "Class: %s", class );
-	Out_line();
-}
+	int i, l;
+	const char *str;
 
-/*
- * seebig: calcuate if the big letters can be seen
- * i.e.- printed on the page
- */
+	for( str = outbuf, i = outlen;
+		i > 0 && (l = write( 1, str, i)) > 0;
+		i -= l, str += l );
+	outlen = 0;
+}
 
-static void seebig( int *len, int bigletter_height, int *big )
+static void Out_line( const char *line, int len, void *arg UNUSED )
 {
-	*big = 0;
-	if( *len > bigletter_height ){
-		*big = bigletter_height+1;
-		*len -= *big;
-	}
+	if( outlen + len > (int)sizeof(outbuf) ) Out_flush();
+	if( len > (int)sizeof(outbuf) ) len = sizeof(outbuf);
+	memcpy( outbuf+outlen, line, len );
+	outlen += len;
 }
 
-/*
- * banner: does all the actual work
- */
-
 static const char *isnull( const char *s )
 {
 	if( s == 0 ) s = "";
@@ -1496,195 +259,40 @@ static const char *isnull( const char *s )
 
 static void banner(void)
 {
-	int len;					/* length of page */
-	int i;                      /* ACME integers, INC */
-	char jobnumber[1024];
-
-	jobnumber[0] = 0;
-#if 0
-	/* read from the STDIN */
-	(void)fgets( jobnumber, sizeof(jobnumber), stdin );
-	if(debug)FPRINTF(STDOUT, "BANNER CMD '%s'\n", jobnumber );
-#endif
-	bigjobnumber = biglogname = bigfromhost = bigjobname = 0;
+	char jobnumber[1024], info[4][1024];
+	const char *big[4], *lines[4];
+	time_t tmp;
+	int i;
 
-	/* now calculate the numbers of lines available */
 	if(debug)FPRINTF(STDERR, "BANNER: length %d\n", length );
-	len = length;
-	len -= 4;	/* user information */
-	/* now we add a top break and bottom break */
-	if( len > 2*breaksize ){
-		top_break = breaksize;
-		bottom_break = breaksize;
-	}  else {
-		top_break = 1;
-		bottom_break = 1;
-	}
-	len -= (top_break + bottom_break);
-
 	if( bnrname == 0 ){
 		bnrname = login;
 	}
 
-	/* see if we can do big letters */
+	/* the job number, user, host and job name are in big letters */
 	jobnumber[0] = 0;
 	if( controlfile ){
 		strncpy( jobnumber, controlfile+3, 3 );
 		jobnumber[3] = 0;
 	}
-	if( *jobnumber ) seebig( &len, Font9x8.height, &bigjobnumber );
-	if(bnrname && *bnrname) seebig( &len, Font9x8.height, &biglogname );
-	if(host && *host ) seebig( &len, Font9x8.height, &bigfromhost );
-	if(job && *job) seebig( &len, Font9x8.height, &bigjobname );
-
-	/* now we see how much space we have left */
-	while( length > 0 && len < 0 ){
-		len += length;
-	}
-
-	/*
-	 * we add padding
-	 * Note that we can optionally produce a banner page
-     * exactly PL-1 lines long
-	 * This allows a form feed to be added onto the end.
-	 */
-	if( len > 0 ){
-		/* adjust the total page length */
-		/* len = len -1; */
-		/* check to see if we make breaks a little larger */
-		if( len > 16 ){
-			top_break += 3;
-			bottom_break += 3;
-			len -= 6;
-		}
-		top_sep = len/2;
-		bottom_sep = len - top_sep;
-	}
-	if(debug)FPRINTF(STDERR, "BANNER: length %d, top_break %d, top_sep %d\n",
-		length, top_break, top_sep  );
-	if(debug)FPRINTF(STDERR, "BANNER: bigjobnumber %d, jobnumber '%s'\n", bigjobnumber,
-		isnull(jobnumber) );
-	if(debug)FPRINTF(STDERR, "BANNER: biglogname %d, bnrname '%s'\n", biglogname,
-		isnull(bnrname) );
-	if(debug)FPRINTF(STDERR, "BANNER: bigfromhost %d, host '%s'\n", bigfromhost,
-		isnull(host) );
-	if(debug)FPRINTF(STDERR, "BANNER: bigjobname %d, jobname '%s'\n", bigjobname,
-		isnull(job) );
-	if(debug)FPRINTF(STDERR, "BANNER: userinfo %d\n", 4 );
-	if(debug)FPRINTF(STDERR, "BANNER: bottom_sep %d, bottom_break %d\n",
-		bottom_sep, bottom_break  );
-
-	for( i = 0; i < top_break; ++i ){
-		breakline( '*');
-	}
-	for( i = 0; i < top_sep; ++i ){
-		breakline( 0 );
-	}
-
-	/*
-	 * print the Name, Host and Jobname in BIG letters
-	 * allow some of them to be dropped if there isn't enough
-	 * room.
-	 */
-
-	if( bigjobnumber ) bigprint( &Font9x8, jobnumber );
-	if( biglogname ) bigprint( &Font9x8, bnrname );
-	if( bigfromhost ) bigprint( &Font9x8, host);
-	if( bigjobname ) bigprint( &Font9x8, job );
-	userinfo();
-
-	for( i = 0; i < bottom_sep; ++i ){
-		breakline( 0 );
-	}
-	for( i = 0; i < bottom_break; ++i ){
-		breakline( '*');
-	}
-}
-
-static void breakline( int c )
-{
-	int i;
-
-	if( c ){
-		for( i = 0; i < width; i++) bline[i] = c;
-		bline[i] = '\0';
-	} else {
-		bline[0] = '\0';
-	}
-	Out_line();
-}
-
-/***************************************************************************
- * bigprint( struct font *font, char * line)
- * print the line in big characters
- * for i = topline to bottomline do
- *  for each character in the line do
- *    get the scan line representation for the character
- *    foreach bit in the string do
- *       if the bit is set, print X, else print ' ';
- *        endfor
- *  endfor
- * endfor
- *
- ***************************************************************************/
+	big[0] = jobnumber;
+	big[1] = isnull(bnrname);
+	big[2] = isnull(host);
+	big[3] = isnull(job);
+	if(debug)FPRINTF(STDERR, "BANNER: jobnumber '%s', bnrname '%s', host '%s', jobname '%s'\n",
+		big[0], big[1], big[2], big[3] );
 
-static void bigprint( const struct font *font, const char *line )
-{
-	int i, j, k, len;                   /* ACME Integers, Inc. */
-
-	bline[width] = 0;
-	len = strlen(line);
-	if(debug)FPRINTF(STDERR,"bigprint: '%s'\n", line );
-	for( i = 0; i < font->height; ++i ){
-		for( j = 0; j < width; ++j ){
-			bline[j] = ' ';
-		}
-		for( j = 0, k = 0; j < width && k < len; j += font->width, ++k ){
-			do_char( font, &font->glyph[line[k]-32], &bline[j], i, width - j );
-		}
-		Out_line();
-	}
-	bline[0] = 0;
-	Out_line();
-}
-
-/***************************************************************************
- * write the buffer out to the file descriptor.
- * don't do if fail is invalid.
- ***************************************************************************/
-
-static void Out_line( void )
-{
-	int i, l;
-	const char *str;
-	bline[sizeof(bline)-1] = 0;
-	if( width < (int)sizeof(bline) ) bline[width] = 0;
-	for( str = bline, i = strlen(str);
-		i > 0 && (l = write( 1, str, i)) > 0;
-		i -= l, str += l );
-	for( str = "\n", i = strlen(str);
-		i > 0 && (l = write( 1, str, i)) > 0;
-		i -= l, str += l );
+	time(&tmp);
+	(void) plp_snprintf( info[0], sizeof(info[0]), "User:  %s@%s (%s)", login, host, bnrname);
+	strftime(info[1],sizeof(info[1]),"Date: %b %d %H:%M:%S", localtime(&tmp));
+	(void) plp_snprintf( info[2], sizeof(info[2]), "Job:   %s", job );
+	(void) plp_snprintf( info[3], sizeof(info[3]), "Class: %s", class );
+	for( i = 0; i < 4; ++i ) lines[i] = info[i];
+
+	Banner_page( width, length, big, 4, lines, 4, Out_line, 0 );
+	Out_flush();
 }
 
-static void do_char( const struct font *font, const struct glyph *glyph,
-	char *str, int line, int wid )
-{
-	int chars, i, j, k;
-	const char *s;
-
-	/* if(debug)FPRINTF(STDERR,"do_char: '%c', wid %d\n", glyph->ch, wid ); */
-	chars = (font->width+7)/8;	/* calculate the row */
-	s = &glyph->bits[line*chars];	/* get start of row */
-	for( k = 0, i = 0; k < wid && i < chars; ++i ){	/* for each byte in row */
-		for( j = 7; k < wid && j >= 0; ++k, --j ){	/* from most to least sig bit */
-			if( *s & (1<<j) ){		/* get bit value */
-				str[k] = 'X';
-			}
-		}
-		++s;
-	}
-}
 
 /* VARARGS2 */
 #ifdef HAVE_STDARGS
@@ -31,6 +31,7 @@
  *   lprm printer [ user [@host]  | host | jobnumber ] *
  *   lpq printer [ user [@host]  | host | jobnumber ] *
  *   lpd [pr | pr@host]   - PID of LPD server
+ *   stats [pr | all]     - LPD job and request statistics
  *   active [pr |pr@host] - check to see if server accepting connections
  *   client [all | pr ]     - show client configuration and printcap info 
  *   server [all |pr ]     - show server configuration and printcap info 
@@ -483,6 +484,7 @@ _("usage: %s [-a][-Ddebuglevel][-Pprinter][-Shost][-Uusername][-V] [command]\n"
 " release   (printer[@host] | all) (name[@host] | job | all)*   - release jobs\n"
 " reread                            - LPD reread database information\n"
 " start     (printer[@host] | all)  - start printing\n"
+" stats     (printer[@host] | all)  - LPD job and request statistics\n"
 " status    (printer[@host] | all)  - status of printers\n"
 " stop      (printer[@host] | all)  - stop  printing\n"
 " topq      (printer[@host] | all) (name[@host] | job | all)*   - reorder jobs\n"
@@ -8,6 +8,7 @@
  ***************************************************************************/
 
 #include "lp.h"
+#include "accounting.h"
 #include "child.h"
 #include "fileopen.h"
 #include "errorcodes.h"
@@ -22,6 +23,10 @@
 #include "lpd_jobs.h"
 #include "lpd_dispatch.h"
 #include "user_auth.h"
+#include "lpd_watch.h"
+#include "sendmail.h"
+#include "stats.h"
+#include "summary.h"
 
 /* force local definitions */
 #undef EXTERN
@@ -41,6 +46,9 @@
  char* Lpd_port_arg;	/* command line port value */
  char* Lpd_socket_arg; /* command line unix socket value */
 
+ /* partial lines read from the status pipes, by fd */
+ static struct line_list Partial_line_list;
+
 #if HAVE_TCPD_H
 #include <tcpd.h>
  int allow_severity = LOG_INFO;
@@ -79,12 +87,14 @@ int main(int argc, char *argv[], char *envp[])
 	plp_status_t status;
 	int max_servers;
 	int start_fd = 0;
-	pid_t start_pid = 0, logger_process_pid = 0;
+	pid_t start_pid = 0, logger_process_pid = 0, accounting_pid = 0, mail_pid = 0;
 	int request_pipe[2], status_pipe[2];
 	pid_t last_fork_pid_value;
 	struct line_list args;
 	int first_scan = 1;
 	int unix_sock = 0;
+	int stats_sock = 0;
+	int watch_fd = -1;
 #ifdef IPP_STUBS
 	int ipp_sock = 0;
 #endif /* not IPP_STUBS */
@@ -245,6 +255,17 @@ int main(int argc, char *argv[], char *envp[])
 			}
 			if( unix_sock >= max_socks ) max_socks = unix_sock;
 		}
+		s = Stats_socket_DYN;
+		if( !ISNULL(s) && safestrcasecmp( s,"off") ){
+			stats_sock = Unix_link_listen(s);
+			DEBUG1("lpd: stats socket fd %d, path '%s'",stats_sock, s);
+			if( stats_sock < 0 ){
+				Errorcode = 1;
+				DIEMSG("Cannot bind to UNIX socket '%s'", s );
+			}
+			Set_nonblock_io(stats_sock);
+			if( stats_sock >= max_socks ) max_socks = stats_sock;
+		}
 	}
 
 	/* setting nonblocking on the listening fd
@@ -283,6 +304,13 @@ int main(int argc, char *argv[], char *envp[])
 
 	Setup_log( Logfile_LPD );
 
+	/* the statistics and queue summary segments are shared with all
+	   the processes we fork */
+	Stats_init( PC_order_line_list.count );
+	Summary_init();
+	Accounting_init();
+	Init_server_security();
+
 	Name = "Waiting";
 	setproctitle( "lpd %s", Name  );
 
@@ -331,6 +359,24 @@ int main(int argc, char *argv[], char *envp[])
 		}
 	}
 
+	/* the accounting process sends the journal records */
+	accounting_pid = -1;
+	if( cval(Accounting_journal_DYN) == '/' ){
+		accounting_pid = Start_accounting();
+		if( accounting_pid < 0 ){
+			logerr_die(LOG_ERR, _("lpd: cannot start accounting process") );
+		}
+	}
+
+	/* the mail process sends the queued mail */
+	mail_pid = -1;
+	if( cval(Mail_queue_dir_DYN) == '/' ){
+		mail_pid = Start_mail();
+		if( mail_pid < 0 ){
+			logerr_die(LOG_ERR, _("lpd: cannot start mail process") );
+		}
+	}
+
 	/* open a connection to logger */
 	setmessage(0,LPD,"Starting");
 
@@ -341,10 +387,15 @@ int main(int argc, char *argv[], char *envp[])
 	FD_ZERO( &defreadfds );
 	if( sock > 0 ) FD_SET( sock, &defreadfds );
 	if( unix_sock > 0 ) FD_SET( unix_sock, &defreadfds );
+	if( stats_sock > 0 ) FD_SET( stats_sock, &defreadfds );
 #ifdef IPP_STUBS
 	if( ipp_sock > 0 ) FD_SET( ipp_sock, &defreadfds );
 #endif /* not IPP_STUBS */
 	FD_SET( request_pipe[0], &defreadfds );
+	if( (watch_fd = Watch_init()) > 0 ){
+		FD_SET( watch_fd, &defreadfds );
+		if( watch_fd >= max_socks ) max_socks = watch_fd+1;
+	}
 
 	/*
 	 * start waiting for connections from processes
@@ -377,6 +428,7 @@ int main(int argc, char *argv[], char *envp[])
 		struct timeval timeval, *timeout;
 		time_t this_time = time( (void *)0 );
 		int elapsed_time;
+		int poll_time = Poll_time_DYN;
 
 #ifdef DMALLOC
 		/* check for memory leaks */
@@ -419,6 +471,12 @@ int main(int argc, char *argv[], char *envp[])
 				/* ARGH! the logger process died */
 				logger_process_pid = -1;
 			}
+			if( pid == accounting_pid ){
+				accounting_pid = -1;
+			}
+			if( pid == mail_pid ){
+				mail_pid = -1;
+			}
 			if( pid == start_pid ){
 				start_pid = -1;
 			}
@@ -435,6 +493,18 @@ int main(int argc, char *argv[], char *envp[])
 			Fork_error( last_fork_pid_value );
 			DEBUG1("lpd: logger_process_pid %d", logger_process_pid );
 		}
+		if( last_fork_pid_value >= 0 && accounting_pid <= 0
+			&& cval(Accounting_journal_DYN) == '/' ){
+			DEBUG1( "lpd: restarting accounting process");
+			last_fork_pid_value = accounting_pid = Start_accounting();
+			Fork_error( last_fork_pid_value );
+		}
+		if( last_fork_pid_value >= 0 && mail_pid <= 0
+			&& cval(Mail_queue_dir_DYN) == '/' ){
+			DEBUG1( "lpd: restarting mail process");
+			last_fork_pid_value = mail_pid = Start_mail();
+			Fork_error( last_fork_pid_value );
+		}
 
 		/* you really do not want to start up more proceses until you can
 		 */
@@ -450,11 +520,15 @@ int main(int argc, char *argv[], char *envp[])
 		 */
 
 		elapsed_time = (this_time - last_time);
-		if( Poll_time_DYN > 0 && start_pid <= 0 ){
+		/* when we watch the queues polling is only a safety net */
+		if( Watch_active() && poll_time > 0 && Watch_poll_time_DYN > poll_time ){
+			poll_time = Watch_poll_time_DYN;
+		}
+		if( poll_time > 0 && start_pid <= 0 ){
 			int doit, scanned_queue_count;
-			DEBUG1("lpd: checking for scan, start_fd %d, start_pid %ld, Poll_time_DYN %d, elapsed_time %d, Started_server %d, Force_poll %d",
-				start_fd, (long)start_pid, Poll_time_DYN, elapsed_time, Started_server, Force_poll_DYN );
-			if( elapsed_time >= Poll_time_DYN ){
+			DEBUG1("lpd: checking for scan, start_fd %d, start_pid %ld, poll_time %d, elapsed_time %d, Started_server %d, Force_poll %d",
+				start_fd, (long)start_pid, poll_time, elapsed_time, Started_server, Force_poll_DYN );
+			if( elapsed_time >= poll_time ){
 				for( scanned_queue_count = doit = 0;
 					scanned_queue_count == 0 && doit < Servers_line_list.count; ++doit ){
 					char *s = Servers_line_list.list[doit];
@@ -478,7 +552,7 @@ int main(int argc, char *argv[], char *envp[])
 			} else {
 				/* oops... need to wait longer */
 				timeout = &timeval;
-				timeval.tv_sec = Poll_time_DYN - elapsed_time;
+				timeval.tv_sec = poll_time - elapsed_time;
 			}
 		}
 
@@ -671,10 +745,21 @@ int main(int argc, char *argv[], char *envp[])
 			/* we need to force the LPD logger to use new printcap information */
 			if( Reread_config ){
 				if( logger_process_pid > 0 ) kill( logger_process_pid, SIGINT );
+				if( accounting_pid > 0 ) kill( accounting_pid, SIGINT );
+				if( mail_pid > 0 ) kill( mail_pid, SIGINT );
 				setmessage(0,LPD,"Restart");
 				Reread_config = 0;
+				Summary_reset();
+				if( Watch_active() ){
+					/* scan now to watch the queues we have now */
+					Watch_reset();
+					Started_server = 1;
+					last_time = 0;
+				}
 			}
 			Setup_configuration();
+			Init_server_security();
+			Stats_check_size( PC_order_line_list.count );
 		}
 		/* mark this as a timeout */
 		if( fd_available < 0 ){
@@ -698,6 +783,10 @@ int main(int argc, char *argv[], char *envp[])
 			DEBUG1("lpd: accept on UNIX socket");
 			Accept_connection( unix_sock );
 		}
+		if( stats_sock > 0 && FD_ISSET( stats_sock, &readfds ) ){
+			DEBUG1("lpd: accept on stats socket");
+			Send_stats( stats_sock );
+		}
 #ifdef IPP_STUBS
 		if( ipp_sock > 0 && FD_ISSET( ipp_sock, &readfds ) ){
 			DEBUG1("lpd: accept on IPP socket");
@@ -712,6 +801,20 @@ int main(int argc, char *argv[], char *envp[])
 		if( start_fd > 0 && FD_ISSET( start_fd, &readfds ) ){
 			start_fd = Read_server_status( start_fd );
 		}
+		if( watch_fd > 0 && FD_ISSET( watch_fd, &readfds ) ){
+			struct line_list changed;
+			int i;
+			Init_line_list(&changed);
+			if( Watch_changes( &changed ) < 0 ){
+				/* we lost track, do a full scan */
+				last_time = 0;
+				Started_server = 1;
+			}
+			for( i = 0; i < changed.count; ++i ){
+				Add_server( changed.list[i] );
+			}
+			Free_line_list(&changed);
+		}
 	}while( 1 );
 	Free_line_list(&args);
 	cleanup(0);
@@ -823,12 +926,12 @@ int Lock_lpd_pid(void)
 
 int Read_server_status( int fd )
 {
-	int status, count, found, n;
-	char buffer[LINEBUFFER];
-	char *name;
+	int status, count, n;
+	char buffer[LARGEBUFFER], key[32];
+	char *name, *line, *s;
 	fd_set readfds;	/* for select() */
 	struct timeval timeval;
-	struct line_list l;
+	struct line_list l, w;
 
 	buffer[0] = 0;
 	errno = 0;
@@ -836,6 +939,8 @@ int Read_server_status( int fd )
 	DEBUG1( "Read_server_status: starting" );
 
 	Init_line_list(&l);
+	Init_line_list(&w);
+	plp_snprintf( key, sizeof(key), "%d", fd );
 	while(1){
 		FD_ZERO( &readfds );
 		FD_SET( fd, &readfds );
@@ -855,26 +960,44 @@ int Read_server_status( int fd )
 		if( status <= 0 ){
 			close(fd);
 			fd = -1;
-			break;
+			buffer[0] = 0;
+		} else {
+			buffer[status] = 0;
 		}
-		buffer[status] = 0;
 		DEBUG1( "Read_server_status: read status %d '%s'", status, buffer );
+		/* we only use complete lines, and keep the rest for the next read */
+		line = safestrdup2( Find_str_value(&Partial_line_list,key),
+			status > 0 ? buffer : "", __FILE__,__LINE__ );
+		Set_str_value(&Partial_line_list,key,0);
+		if( status > 0 ){
+			if( (s = safestrrchr( line, '\n' )) ){
+				Set_str_value(&Partial_line_list,key,s+1);
+				s[1] = 0;
+			} else {
+				Set_str_value(&Partial_line_list,key,line);
+				*line = 0;
+			}
+		}
 		/* we split up read line and record information */
-		Split(&l,buffer,Whitespace,0,0,0,0,0,0);
+		Split(&l,line,Line_ends,0,0,0,0,0,0);
+		if( line ) free(line); line = 0;
 		if(DEBUGL1)Dump_line_list("Read_server_status - input", &l );
 		for( count = 0; count < l.count; ++count ){ 
 			name = l.list[count];
 			if( ISNULL(name) ) continue;
-			found = 0;
-			for( n = 0;!found && n < Servers_line_list.count; ++n ){
-				found = !safestrcasecmp( Servers_line_list.list[n], name);
-			}
-			if( !found ){
-				Add_line_list(&Servers_line_list,name,0,0,0);
+			Split(&w,name,Whitespace,0,0,0,0,0,0);
+			if( cval(name) == '=' ){
+				/* =printer spool_dir lock_file control_file */
+				if( w.count == 4 ){
+					Watch_queue( w.list[0]+1, w.list[1], w.list[2], w.list[3] );
+				}
+			} else for( n = 0; n < w.count; ++n ){
+				Add_server( w.list[n] );
 			}
-			Started_server = 1;
+			Free_line_list(&w);
 		}
 		Free_line_list(&l);
+		if( status <= 0 ) break;
 	}
 	Free_line_list(&l);
 
@@ -900,6 +1023,23 @@ int Read_server_status( int fd )
 	return(fd);
 }
 
+/*
+ * Add_server - put a queue on the list of queues needing service
+ */
+
+static void Add_server( const char *name )
+{
+	int found, n;
+
+	for( found = n = 0; !found && n < Servers_line_list.count; ++n ){
+		found = !safestrcasecmp( Servers_line_list.list[n], name);
+	}
+	if( !found ){
+		Add_line_list(&Servers_line_list,name,0,0,0);
+	}
+	Started_server = 1;
+}
+
 /***************************************************************************
  * void Get_parms(int argc, char *argv[])
  * 1. Scan the argument list and get the flags
@@ -1013,6 +1153,26 @@ static void Accept_connection( int sock )
 	}
 }
 
+/*
+ * Send_stats
+ *   - accept a connection on the stats socket and write the statistics
+ *     in Prometheus text format.  This is done by the main lpd process,
+ *     so we never wait on the reader:  if the socket buffer fills the
+ *     report is cut short.
+ */
+static void Send_stats( int sock )
+{
+	int newsock;
+
+	if( (newsock = accept( sock, 0, 0 )) < 0 ){
+		DEBUG1("Send_stats: accept failed - %s", Errormsg(errno) );
+		return;
+	}
+	Set_nonblock_io( newsock );
+	Stats_report( newsock, 0, 1 );
+	close( newsock );
+}
+
 /*
  * int Start_all( int first_scan, int *start_fd )
  * returns the pid of the process doing the scanning
@@ -19,6 +19,7 @@
 #include "permission.h"
 #include "gethostinfo.h"
 #include "lpd_control.h"
+#include "stats.h"
 
 /**** ENDINCLUDE ****/
 
@@ -42,7 +43,9 @@ static void Do_printer_work( char *user, int action, int *sock,
 static void Do_queue_control( char *user, int action, int *sock,
 	struct line_list *tokens, char *error, int errorlen );
 static int Do_job_ticket_file( int action, int *sock,
-	struct line_list *tokens, char *error, int errorlen, char *option );
+	struct line_list *tokens, char *error, int errorlen, char *option,
+	int *selected );
+static void Flush_line_list( int *sock, struct line_list *outbuf );
 static int Do_control_lpq( char *user, int action,
 	struct line_list *tokens );
 static int Do_control_status( int *sock,
@@ -156,6 +159,11 @@ int Job_control( int *sock, char *input )
 			if( permission == P_REJECT ){ goto noperm; }
 			Do_control_defaultq( sock );
 			goto done;
+		case OP_STATS:
+			/* no printer given means all of them */
+			if( permission == P_REJECT ){ goto noperm; }
+			Stats_report( *sock, tokencount > 3 ? Printer_DYN : 0, 0 );
+			goto done;
 		case OP_STATUS:
 			/* we put out a space at the start to make PCNFSD happy */
 			if( permission == P_REJECT ){ goto noperm; }
@@ -216,10 +224,28 @@ int Job_control( int *sock, char *input )
 	return(0);
 }
 
+struct control_work {
+	char *user;
+	int action;
+	struct line_list *tokens;
+	char *error;
+	int errorlen;
+};
+
+static void Control_work( int *sock, void *arg )
+{
+	struct control_work *w = arg;
+
+	Name = "Do_printer_work";
+	DEBUGF(DCTRL4)("Do_printer_work: printer '%s'", Printer_DYN );
+	Do_queue_control( w->user, w->action, sock,
+		w->tokens, w->error, w->errorlen);
+}
+
 static void Do_printer_work( char *user, int action, int *sock,
 	struct line_list *tokens, char *error, int errorlen )
 {
-	int i;
+	struct control_work w;
 
 	DEBUGF(DCTRL3)("Do_printer_work: printer '%s', action '%s'",
 		Printer_DYN, Get_controlstr(action) );
@@ -231,16 +257,14 @@ static void Do_printer_work( char *user, int action, int *sock,
 	} else {
 		/* we work our way down the printcap list, checking for
 			ones that have a spool queue */
-		/* note that we have already tried to get the 'all' list */
+		w.user = user;
+		w.action = action;
+		w.tokens = tokens;
+		w.error = error;
+		w.errorlen = errorlen;
 		Get_all_printcap_entries();
-		for( i = 0; i < All_line_list.count; ++i ){
-			Name = "Do_printer_work";
-			Set_DYN(&Printer_DYN, All_line_list.list[i]);
-			DEBUGF(DCTRL4)("Do_printer_work: printer [%d]='%s'", i, Printer_DYN );
-			Do_queue_control( user, action, sock,
-				tokens, error, errorlen);
-			Name = "Do_printer_work";
-		}
+		For_all_printers( Lpd_control_workers_DYN, sock, 0,
+			Control_work, &w );
 	}
 }
 
@@ -262,7 +286,7 @@ static void Do_queue_control( char *user, int action, int *sock,
 	int fd, c, i, permission, db, dbflag;	/* descriptor and chars */
 	char line[LINEBUFFER];
 	char msg[LINEBUFFER];
-	int status, change;
+	int status, change, selected = -1;
 	int signal_server = SIGUSR1;
 	struct line_list l;
 	const char *Action = "updated";
@@ -381,7 +405,7 @@ static void Do_queue_control( char *user, int action, int *sock,
 		Set_flag_value(&Spool_control,PRINTING_DISABLED, 0);
 	case OP_HOLD:
 		if( Do_job_ticket_file( action, sock,
-			tokens, error, errorlen, 0 ) ){
+			tokens, error, errorlen, 0, &selected ) ){
 			goto error;
 		}
 		break;
@@ -404,7 +428,7 @@ static void Do_queue_control( char *user, int action, int *sock,
 		--tokens->count;
 		start = tokens->list[tokens->count];
 		status = Do_job_ticket_file( action, sock,
-			tokens, error, errorlen, start );
+			tokens, error, errorlen, start, &selected );
 		++tokens->count;
 		if( status ) goto error;
 		break;
@@ -512,8 +536,13 @@ static void Do_queue_control( char *user, int action, int *sock,
 	}
 	if( Action ){
 		setmessage( 0, ACTION, "%s", Action );
-		plp_snprintf( line, sizeof(line), "%s@%s: %s\n",
-			Printer_DYN, FQDNHost_FQDN, Action );
+		if( selected >= 0 ){
+			plp_snprintf( line, sizeof(line), "%s@%s: %s, %d selected\n",
+				Printer_DYN, FQDNHost_FQDN, Action, selected );
+		} else {
+			plp_snprintf( line, sizeof(line), "%s@%s: %s\n",
+				Printer_DYN, FQDNHost_FQDN, Action );
+		}
 		if( Write_fd_str( *sock, line ) < 0 ) cleanup(0);
 	}
 
@@ -590,10 +619,13 @@ static void Do_queue_control( char *user, int action, int *sock,
  * 1. get the control files
  * 2. check to see if the control file has been selected
  * 3. update the job ticket file for the control file
+ *  Only the errors for the jobs are sent,  in batches;  the number of
+ *  jobs selected is put in *selected.
  ***************************************************************************/
 
 static int Do_job_ticket_file( int action, int *sock,
-	struct line_list *tokens, char *error, int errorlen, char *option )
+	struct line_list *tokens, char *error, int errorlen, char *option,
+	int *selected )
 {
 	int i, permission, err, fd;		/* ACME! Nothing but the best */
 	int status, matchv;			/* status of last IO op */
@@ -601,10 +633,12 @@ static int Do_job_ticket_file( int action, int *sock,
 	char *s, *identifier;
 	struct job job;
 	int destinations, update_dest;
-	struct line_list l;
+	struct line_list l, outbuf;
 
 	/* get the job files */
 	Init_line_list(&l);
+	Init_line_list(&outbuf);
+	*selected = 0;
 	Init_job(&job);
 	Free_line_list(&Sort_order);
 	if( Scan_queue( &Spool_control, &Sort_order,
@@ -643,7 +677,7 @@ static int Do_job_ticket_file( int action, int *sock,
 		Perm_check.user = Find_str_value(&job.info,LOGNAME);
 		Perm_check.host = 0;
 		s = Find_str_value(&job.info,FROMHOST);
-		if( s && Find_fqdn( &PermHost_IP, s ) ){
+		if( s && Find_fqdn_again( &PermHost_IP, s ) ){
 			Perm_check.host = &PermHost_IP;
 		}
 		permission = Perms_check( &Perm_line_list, &Perm_check, 0, 1 );
@@ -653,7 +687,7 @@ static int Do_job_ticket_file( int action, int *sock,
 			plp_snprintf( msg, sizeof(msg),
 				_("%s: no permission '%s'\n"),
 				Printer_DYN, identifier );
-			if( Write_fd_str( *sock, msg ) < 0 ) cleanup(0);
+			Add_line_list( &outbuf, msg, 0, 0, 0 );
 			continue;
 		}
 
@@ -735,9 +769,7 @@ static int Do_job_ticket_file( int action, int *sock,
 		if( update_dest ){
 			Update_destination( &job );
 		}
-		plp_snprintf( msg, sizeof(msg), _("%s: selected '%s'\n"),
-			Printer_DYN, identifier );
-		if( Write_fd_str( *sock, msg ) < 0 ) cleanup(0);
+		++*selected;
 		Set_str_value(&job.info,ERROR,0 );
 		Set_flag_value(&job.info,ERROR_TIME,0);
 		/* record the last update person */
@@ -747,20 +779,40 @@ static int Do_job_ticket_file( int action, int *sock,
 			plp_snprintf( msg, sizeof(msg),
 				_("%s: cannot set hold file '%s'\n"),
 				Printer_DYN, identifier );
-			if( Write_fd_str( *sock, msg ) < 0 ) cleanup(0);
+			Add_line_list( &outbuf, msg, 0, 0, 0 );
 		}
 		Free_line_list(&l);
+		if( outbuf.count >= 100 ){
+			Flush_line_list( sock, &outbuf );
+		}
 		if( update_dest ){
 			goto next_dest;
 		}
 	}
 	if( fd > 0 ) close(fd); fd = -1;
+	Flush_line_list( sock, &outbuf );
 	Free_job(&job);
 	Free_line_list(&Sort_order);
 	Free_line_list(&l);
 	return( 0 );
 }
 
+/***************************************************************************
+ * Flush_line_list:
+ *  write the lines in the list to *sock in one write and empty the list
+ ***************************************************************************/
+
+static void Flush_line_list( int *sock, struct line_list *outbuf )
+{
+	char *s;
+
+	if( (s = Join_line_list( outbuf, "" )) ){
+		if( Write_fd_str( *sock, s ) < 0 ) cleanup(0);
+		free(s);
+	}
+	Free_line_list( outbuf );
+}
+
 
 
 /***************************************************************************
@@ -28,6 +28,8 @@
 #include "lpd_secure.h"
 #include "krb5_auth.h"
 #include "lpd_dispatch.h"
+#include "stats.h"
+#include "lpd_watch.h"
 
 static void Service_lpd( int talk, const char *from_addr ) NORETURN;
 
@@ -65,30 +67,34 @@ void Dispatch_input(int *talk, char *input, const char *from_addr )
 	}
 }
 
-void Service_all( struct line_list *args, int reportfd )
+/*
+ * Scan_queues - check every step'th queue in All_line_list starting at
+ *  first, and report the ones needing a server on reportfd.
+ *  Queues with printable jobs are reported as they are found.  The rest
+ *  are put on the deferred list, or if there is none, written as
+ *  '-printer' lines for Service_all to put at the end of the report.
+ */
+
+static void Scan_queues( int first, int step, int first_scan, int reportfd,
+	struct line_list *deferred )
 {
 	int i, printable, held, move, printing_enabled,
 		server_pid, change, error, done, do_service;
 	char buffer[SMALLBUFFER], *pr, *forwarding;
-	int first_scan;
 	char *remove_prefix = 0;
 
-	/* we start up servers while we can */
-	Name = "SERVICEALL";
-	setproctitle( "lpd %s", Name );
-
-	first_scan = Find_flag_value(args,FIRST_SCAN);
-	Free_line_list(args);
-
-	if(All_line_list.count == 0 ){
-		Get_all_printcap_entries();
-	}
-	for( i = 0; i < All_line_list.count; ++i ){
+	for( i = first; i < All_line_list.count; i += step ){
 		Set_DYN(&Printer_DYN,0);
 		Set_DYN(&Spool_dir_DYN,0);
 		pr = All_line_list.list[i];
-		DEBUG1("Service_all: checking '%s'", pr );
+		DEBUG1("Scan_queues: checking '%s'", pr );
 		if( Setup_printer( pr, buffer, sizeof(buffer), 0) ) continue;
+		if( Watch_active() ){
+			/* let the lpd server watch the queue for changes */
+			plp_snprintf(buffer,sizeof(buffer), "=%s %s %s %s\n", Printer_DYN,
+				Spool_dir_DYN, Queue_lock_file_DYN, Queue_control_file_DYN );
+			if( Write_fd_str(reportfd,buffer) < 0 ) cleanup(0);
+		}
 		/* now check to see if there is a server and unspooler process active */
 		server_pid = 0;
 		remove_prefix = 0;
@@ -96,7 +102,7 @@ void Service_all( struct line_list *args, int reportfd )
 			remove_prefix = Fifo_lock_file_DYN;
 		}
 		server_pid = Read_pid_from_file( Printer_DYN );
-		DEBUG3("Service_all: printer '%s' checking server pid %d", Printer_DYN, server_pid );
+		DEBUG3("Scan_queues: printer '%s' checking server pid %d", Printer_DYN, server_pid );
 		if( server_pid > 0 && kill( server_pid, 0 ) == 0 ){
 			DEBUG3("Get_queue_status: server %d active", server_pid );
 			continue;
@@ -116,18 +122,111 @@ void Service_all( struct line_list *args, int reportfd )
 			&& (error || done ) ){
 			do_service = 1;
 		}
-		if( do_service || change || move || (printable && (printing_enabled||forwarding)) ){
+		printable = printable && (printing_enabled||forwarding);
+		if( do_service || change || move || printable ){
 			if( Server_queue_name_DYN ){
 				pr = Server_queue_name_DYN;
 			} else {
 				pr = Printer_DYN;;
 			}
-			DEBUG1("Service_all: starting '%s'", pr );
-			plp_snprintf(buffer,sizeof(buffer), ".%s\n",pr );
+			DEBUG1("Scan_queues: starting '%s', printable %d", pr, printable );
+			if( !printable && deferred ){
+				Add_line_list( deferred, pr, 0, 0, 0 );
+				continue;
+			}
+			plp_snprintf(buffer,sizeof(buffer), "%c%s\n", printable?'.':'-', pr );
 			if( Write_fd_str(reportfd,buffer) < 0 ) cleanup(0);
 		}
 	}
 	Free_line_list( &Sort_order );
+}
+
+/*
+ * Merge_scan - copy the reports from the scan workers to reportfd,
+ *  keeping the '-printer' lines on the deferred list.
+ *  The workers write whole lines to the pipe, so they do not mix.
+ */
+
+static void Merge_scan( int fd, int reportfd, struct line_list *deferred )
+{
+	char buffer[LARGEBUFFER], *s, *end;
+	int len = 0, n;
+
+	while( (n = ok_read( fd, buffer+len, sizeof(buffer)-1-len )) > 0 ){
+		len += n;
+		buffer[len] = 0;
+		for( s = buffer; (end = safestrchr( s, '\n' )); s = end+1 ){
+			if( cval(s) == '-' ){
+				*end = 0;
+				Add_line_list( deferred, s+1, 0, 0, 0 );
+			} else if( Write_fd_len( reportfd, s, end - s + 1 ) < 0 ){
+				cleanup(0);
+			}
+		}
+		len = safestrlen(s);
+		if( len >= (int)sizeof(buffer)-1 ) len = 0;
+		memmove( buffer, s, len+1 );
+	}
+	close( fd );
+}
+
+/*
+ * Service_all - find the queues needing a server
+ *  On the first scan after lpd starts the queues are split over
+ *  lpd_scan_workers processes.  Queues with printable jobs are
+ *  reported first so they get servers first.
+ */
+
+void Service_all( struct line_list *args, int reportfd )
+{
+	int i, workers, first_scan, p[2];
+	char buffer[SMALLBUFFER];
+	struct line_list deferred;
+	pid_t pid;
+	plp_status_t status;
+
+	/* we start up servers while we can */
+	Name = "SERVICEALL";
+	setproctitle( "lpd %s", Name );
+	Init_line_list(&deferred);
+
+	first_scan = Find_flag_value(args,FIRST_SCAN);
+	Free_line_list(args);
+
+	if(All_line_list.count == 0 ){
+		Get_all_printcap_entries();
+	}
+	workers = first_scan ? Lpd_scan_workers_DYN : 1;
+	if( workers > All_line_list.count ) workers = All_line_list.count;
+	if( workers <= 1 || pipe(p) == -1 ){
+		Scan_queues( 0, 1, first_scan, reportfd, &deferred );
+	} else {
+		DEBUG1("Service_all: %d workers for %d queues", workers, All_line_list.count );
+		for( i = 0; i < workers; ++i ){
+			if( (pid = dofork(0)) < 0 ){
+				logerr(LOG_INFO, _("Service_all: fork failed") );
+				break;
+			} else if( pid == 0 ){
+				close( p[0] );
+				Name = "SCANQUEUES";
+				Scan_queues( i, workers, first_scan, p[1], 0 );
+				Errorcode = 0;
+				cleanup(0);
+			}
+		}
+		/* do the slices we could not start a worker for */
+		for( ; i < workers; ++i ){
+			Scan_queues( i, workers, first_scan, reportfd, &deferred );
+		}
+		close( p[1] );
+		Merge_scan( p[0], reportfd, &deferred );
+		while( plp_waitpid( -1, &status, 0 ) > 0 );
+	}
+	for( i = 0; i < deferred.count; ++i ){
+		plp_snprintf(buffer,sizeof(buffer), ".%s\n", deferred.list[i] );
+		if( Write_fd_str(reportfd,buffer) < 0 ) cleanup(0);
+	}
+	Free_line_list( &deferred );
 	Errorcode = 0;
 	cleanup(0);
 }
@@ -164,6 +263,7 @@ void Service_connection( struct line_list *args, int talk )
 	}
 
 	DEBUG1("Service_connection: listening fd %d", talk );
+	Stats_connection();
 
 	Free_line_list(args);
 
@@ -305,7 +405,8 @@ void Service_connection( struct line_list *args, int talk )
 static void Service_lpd( int talk, const char *from_addr )
 {
 	char input[LINEBUFFER];
-	int status;
+	int status, request;
+	double start = Stats_now();
 	int len = sizeof( input ) - 1;
 	int timeout = (Send_job_rw_timeout_DYN>0)?Send_job_rw_timeout_DYN:
 					((Connect_timeout_DYN>0)?Connect_timeout_DYN:10);
@@ -330,6 +431,8 @@ static void Service_lpd( int talk, const char *from_addr )
 		fatal(LOG_INFO, _("Service_connection: short request line '%s', from '%s'"),
 			input, from_addr );
 	}
+	request = cval(input);
 	Dispatch_input(&talk,input,from_addr);
+	Stats_request( request, Stats_now() - start );
 	cleanup(0);
 }
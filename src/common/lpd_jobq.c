@@ -0,0 +1,574 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "getqueue.h"
+#include "linelist.h"
+#include "lpd_jobq.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Queue server job selection
+ *
+ *  Do_queue_jobs() used to walk the Sort_order list from the start
+ *  every time it looked for a job to print,  reading and locking each
+ *  job ticket until it found one it could use, and to reread every
+ *  job ticket in the spool directory on each SIGUSR1.  With a lot of
+ *  held or failed jobs at the head of the queue this was very slow.
+ *
+ *  We keep the job ticket contents in memory instead,  together with
+ *  the inode, size and times of the file when it was read.
+ *  Jobq_scan() only rereads the job tickets that have changed since
+ *  the last scan;  the jobs that can be printed are kept in a heap
+ *  ordered by sort key,  and Jobq_next() returns the name of the next
+ *  one.  The caller still reads and locks that ticket and decides
+ *  what to do with it;  it tells us with Jobq_set():
+ *
+ *   JOBQ_KEEP    - could not be started now, try again on the next pass
+ *                  (this is the default)
+ *   JOBQ_PARK    - not printable;  ignore it until the next Jobq_scan()
+ *   JOBQ_RECHECK - started or changed;  reread the job ticket before
+ *                  each pass until it is not active
+ *
+ *  Jobq_start() is called at the start of each pass to apply these.
+ *
+ *  When done jobs are kept (done_jobs, done_jobs_max_age) we also keep
+ *  the jobs that can be removed in two heaps,  one by REMOVE_TIME for
+ *  the done_jobs limit and one by the time the status expires.
+ *  Remove_done_jobs() then only has to look at the jobs that are
+ *  due for removal,  and the time of the next expiry is used as the
+ *  timeout when waiting for a subserver.  The times are in the job
+ *  tickets,  so the heaps are rebuilt by the Jobq_scan() when the
+ *  queue server starts.  The heap entries are not removed when a job
+ *  changes;  entries whose time does not match the job are discarded
+ *  when they get to the top.
+ */
+
+struct jobq_entry {
+	char *name;				/* job ticket file */
+	struct job job;			/* job ticket contents and sort key */
+	ino_t ino;
+	off_t size;
+	time_t mtime, ctime;	/* file values when we read it */
+	time_t read_time;		/* when we read it */
+	int state;				/* JOBQ_xxx below */
+	int found;				/* seen in this scan */
+	int p, h, m, e, dn;		/* from Job_printable() */
+	int done_in, expire_in;	/* in the done and expire heaps */
+	time_t done_t, expire_t;	/* with this time */
+};
+
+struct jobq_time {
+	time_t t;
+	struct jobq_entry *e;
+};
+
+/* states - the disposition values are in lpd_jobq.h */
+#define JOBQ_IDLE	10	/* not printable, wait for a change */
+#define JOBQ_READY	11	/* in the heap */
+#define JOBQ_PARKED	12	/* rejected until the next scan */
+#define JOBQ_TAKEN	13	/* returned by Jobq_next() in this pass */
+
+static struct jobq_entry **Jobq_list;	/* sorted by name */
+static int Jobq_count, Jobq_max;
+static struct jobq_entry **Jobq_heap;
+static int Jobq_heap_count;
+static struct jobq_entry **Jobq_taken;	/* with disposition */
+static int Jobq_taken_count;
+static int *Jobq_taken_how;
+static struct jobq_entry **Jobq_recheck;
+static int Jobq_recheck_count;
+static struct line_list *Jobq_spool_control;
+static char *Jobq_dir;
+static struct jobq_time *Jobq_done, *Jobq_expire;	/* heaps */
+static int Jobq_done_count, Jobq_done_max, Jobq_expire_count, Jobq_expire_max;
+static int Jobq_done_jobs;		/* entries with done_in set */
+
+static int Jobq_cmp_name( const void *l, const void *r )
+{
+	return( strcmp( (*(struct jobq_entry **)l)->name,
+		(*(struct jobq_entry **)r)->name ) );
+}
+
+static int Jobq_before( struct jobq_entry *l, struct jobq_entry *r )
+{
+	int c = strcmp( l->job.sort_key, r->job.sort_key );
+	if( c == 0 ) c = strcmp( l->name, r->name );
+	return( c < 0 );
+}
+
+static void Jobq_sift_down( int i )
+{
+	struct jobq_entry *t;
+	int c;
+
+	while( (c = 2*i+1) < Jobq_heap_count ){
+		if( c+1 < Jobq_heap_count && Jobq_before( Jobq_heap[c+1], Jobq_heap[c] ) ){
+			++c;
+		}
+		if( !Jobq_before( Jobq_heap[c], Jobq_heap[i] ) ) break;
+		t = Jobq_heap[c]; Jobq_heap[c] = Jobq_heap[i]; Jobq_heap[i] = t;
+		i = c;
+	}
+}
+
+static void Jobq_push( struct jobq_entry *e )
+{
+	struct jobq_entry *t;
+	int i, parent;
+
+	e->state = JOBQ_READY;
+	i = Jobq_heap_count++;
+	Jobq_heap[i] = e;
+	while( i > 0 ){
+		parent = (i-1)/2;
+		if( !Jobq_before( Jobq_heap[i], Jobq_heap[parent] ) ) break;
+		t = Jobq_heap[parent]; Jobq_heap[parent] = Jobq_heap[i]; Jobq_heap[i] = t;
+		i = parent;
+	}
+}
+
+static int Jobq_time_before( struct jobq_time *l, struct jobq_time *r )
+{
+	if( l->t != r->t ) return( l->t < r->t );
+	return( strcmp( l->e->name, r->e->name ) < 0 );
+}
+
+static void Jobq_time_push( struct jobq_time **heap, int *count, int *max,
+	time_t t, struct jobq_entry *e )
+{
+	struct jobq_time tmp;
+	int i, parent;
+
+	if( *count >= *max ){
+		*max += 100;
+		*heap = realloc_or_die( *heap, *max * sizeof((*heap)[0]), __FILE__,__LINE__ );
+	}
+	i = (*count)++;
+	(*heap)[i].t = t;
+	(*heap)[i].e = e;
+	while( i > 0 ){
+		parent = (i-1)/2;
+		if( !Jobq_time_before( &(*heap)[i], &(*heap)[parent] ) ) break;
+		tmp = (*heap)[parent]; (*heap)[parent] = (*heap)[i]; (*heap)[i] = tmp;
+		i = parent;
+	}
+}
+
+static void Jobq_time_pop( struct jobq_time *heap, int *count )
+{
+	struct jobq_time tmp;
+	int i, c;
+
+	heap[0] = heap[--(*count)];
+	i = 0;
+	while( (c = 2*i+1) < *count ){
+		if( c+1 < *count && Jobq_time_before( &heap[c+1], &heap[c] ) ) ++c;
+		if( !Jobq_time_before( &heap[c], &heap[i] ) ) break;
+		tmp = heap[c]; heap[c] = heap[i]; heap[i] = tmp;
+		i = c;
+	}
+}
+
+/*
+ * Jobq_track_done - put a job that can be removed into the heaps
+ *  This follows the tests in Remove_done_jobs().
+ */
+
+static void Jobq_track_done( struct jobq_entry *e )
+{
+	int remove, error, done, candidate, pid;
+	time_t t = 0;
+
+	if( Save_when_done_DYN || Save_on_error_DYN
+		|| !(Done_jobs_DYN > 0 || Done_jobs_max_age_DYN > 0) ){
+		return;
+	}
+	remove = Find_flag_value( &e->job.info, REMOVE_TIME );
+	error = Find_flag_value( &e->job.info, ERROR_TIME );
+	done = Find_flag_value( &e->job.info, DONE_TIME );
+	candidate = e->job.info.count && !Find_flag_value( &e->job.info, SERVER )
+		&& (remove || error);
+
+	/* done_jobs limit, by REMOVE_TIME */
+	if( candidate && Done_jobs_DYN > 0 ){
+		if( !e->done_in ) ++Jobq_done_jobs;
+		if( !e->done_in || e->done_t != remove ){
+			Jobq_time_push( &Jobq_done, &Jobq_done_count, &Jobq_done_max, remove, e );
+		}
+		e->done_in = 1;
+		e->done_t = remove;
+	} else if( e->done_in ){
+		e->done_in = 0;
+		--Jobq_done_jobs;
+	}
+
+	/* status expiry,  and incoming jobs with no process right away */
+	if( candidate && Done_jobs_max_age_DYN > 0 ){
+		if( error ) t = error;
+		if( done && (!t || done < t) ) t = done;
+		if( t ) t += Done_jobs_max_age_DYN + 1;
+	}
+	if( !t && Find_flag_value( &e->job.info, INCOMING_TIME )
+		&& (pid = Find_flag_value( &e->job.info, INCOMING_PID ))
+		&& kill( pid, 0 ) ){
+		t = 1;
+	}
+	if( t ){
+		if( !e->expire_in || e->expire_t != t ){
+			Jobq_time_push( &Jobq_expire, &Jobq_expire_count, &Jobq_expire_max, t, e );
+		}
+		e->expire_in = 1;
+		e->expire_t = t;
+	} else {
+		e->expire_in = 0;
+	}
+}
+
+/*
+ * Jobq_forget - the job has been handed out for removal,  drop what we
+ *  know about it;  if it is still there the next scan rereads it
+ */
+
+static void Jobq_forget( struct jobq_entry *e )
+{
+	if( e->done_in ) --Jobq_done_jobs;
+	e->done_in = e->expire_in = 0;
+	e->read_time = 0;
+	Free_job( &e->job );
+}
+
+static void Jobq_free_entry( struct jobq_entry *e )
+{
+	Free_job( &e->job );
+	if( e->name ) free( e->name );
+	free( e );
+}
+
+/*
+ * Jobq_read - read the job ticket and record the file values
+ *  returns 0 if the job ticket has gone away
+ */
+
+static int Jobq_read( struct jobq_entry *e )
+{
+	struct stat statb;
+	int fd = -1;
+
+	Free_job( &e->job );
+	e->read_time = time( (void *)0 );
+	Get_job_ticket_file( &fd, &e->job, e->name );
+	if( fd > 0 ){
+		if( fstat( fd, &statb ) == 0 ){
+			e->ino = statb.st_ino;
+			e->size = statb.st_size;
+			e->mtime = statb.st_mtime;
+			e->ctime = statb.st_ctime;
+		}
+		close( fd );
+	}
+	return( e->job.info.count != 0 );
+}
+
+/*
+ * Jobq_classify - get the printable status and sort key and decide
+ *  where the job goes.  Active jobs are rechecked on each pass,
+ *  the others wait in the heap or for a change to the job ticket.
+ */
+
+static void Jobq_classify( struct jobq_entry *e )
+{
+	Job_printable( &e->job, Jobq_spool_control, &e->p, &e->h, &e->m, &e->e, &e->dn );
+	Make_sort_key( &e->job );
+	Jobq_track_done( e );
+	if( Find_flag_value( &e->job.info, SERVER ) ){
+		e->state = JOBQ_RECHECK;
+		Jobq_recheck[Jobq_recheck_count++] = e;
+	} else if( (e->p || e->m) && !e->h ){
+		Jobq_push( e );
+	} else {
+		e->state = JOBQ_IDLE;
+	}
+	DEBUG4("Jobq_classify: '%s' state %d, key '%s'", e->name, e->state, e->job.sort_key );
+}
+
+static void Jobq_check_max( int count )
+{
+	if( count > Jobq_max ){
+		Jobq_max = count + 100;
+		Jobq_list = realloc_or_die( Jobq_list, Jobq_max * sizeof(Jobq_list[0]), __FILE__,__LINE__ );
+		Jobq_heap = realloc_or_die( Jobq_heap, Jobq_max * sizeof(Jobq_heap[0]), __FILE__,__LINE__ );
+		Jobq_taken = realloc_or_die( Jobq_taken, Jobq_max * sizeof(Jobq_taken[0]), __FILE__,__LINE__ );
+		Jobq_taken_how = realloc_or_die( Jobq_taken_how, Jobq_max * sizeof(Jobq_taken_how[0]), __FILE__,__LINE__ );
+		Jobq_recheck = realloc_or_die( Jobq_recheck, Jobq_max * sizeof(Jobq_recheck[0]), __FILE__,__LINE__ );
+	}
+}
+
+/*
+ * Jobq_scan - scan the spool directory (the current directory)
+ *  Only job tickets that have changed since we last read them are
+ *  read again.  The sort_order list and the counts are set up as
+ *  Scan_queue( ..., only_queue_process = 1, ...) would do.
+ */
+
+int Jobq_scan( struct line_list *spool_control,
+	struct line_list *sort_order, int *pprintable, int *pheld, int *pmove,
+	int *perr, int *pdone )
+{
+	DIR *dir;
+	struct dirent *d;
+	struct stat statb;
+	struct jobq_entry key, *kp, **found, *e, **old_list;
+	int old_count, count, i, reread = 0;
+	int printable = 0, held = 0, move = 0, error = 0, done = 0;
+
+	Jobq_spool_control = spool_control;
+	Free_line_list( sort_order );
+	/* the heaps are rebuilt from the entries */
+	Jobq_heap_count = Jobq_taken_count = Jobq_recheck_count = 0;
+	Jobq_done_count = Jobq_expire_count = Jobq_done_jobs = 0;
+	if( safestrcmp( Jobq_dir, Spool_dir_DYN ) ){
+		/* a different queue - forget everything */
+		for( i = 0; i < Jobq_count; ++i ){
+			Jobq_free_entry( Jobq_list[i] );
+		}
+		Jobq_count = 0;
+		if( Jobq_dir ) free( Jobq_dir );
+		Jobq_dir = safestrdup( Spool_dir_DYN, __FILE__,__LINE__ );
+	}
+
+	if( !(dir = opendir( "." )) ){
+		logerr(LOG_INFO, "Jobq_scan: cannot open '.'" );
+		return( 1 );
+	}
+
+	/* look up the entries we have in a copy of the list */
+	old_list = malloc_or_die( (Jobq_count+1) * sizeof(old_list[0]), __FILE__,__LINE__ );
+	if( Jobq_count ) memcpy( old_list, Jobq_list, Jobq_count * sizeof(old_list[0]) );
+	old_count = Jobq_count;
+	count = 0;
+
+	while( (d = readdir(dir)) ){
+		if( !( (cval(d->d_name+0) == 'h')
+			&& (cval(d->d_name+1) == 'f')
+			&& isalpha(cval(d->d_name+2))
+			&& isdigit(cval(d->d_name+3)) ) ){
+			continue;
+		}
+		if( stat( d->d_name, &statb ) ) continue;
+		key.name = d->d_name;
+		kp = &key;
+		found = old_count ? bsearch( &kp, old_list, old_count, sizeof(old_list[0]),
+			Jobq_cmp_name ) : 0;
+		if( found && !(e = *found)->found ){
+			e->found = 1;
+			if( e->state != JOBQ_RECHECK
+				&& e->ino == statb.st_ino && e->size == statb.st_size
+				&& e->mtime == statb.st_mtime && e->ctime == statb.st_ctime
+				&& e->mtime < e->read_time && e->ctime < e->read_time ){
+				DEBUG4("Jobq_scan: '%s' unchanged", e->name );
+			} else if( !Jobq_read( e ) ){
+				Jobq_free_entry( e );
+				continue;
+			} else {
+				++reread;
+			}
+		} else {
+			e = malloc_or_die( sizeof(e[0]), __FILE__,__LINE__ );
+			memset( e, 0, sizeof(e[0]) );
+			e->name = safestrdup( d->d_name, __FILE__,__LINE__ );
+			++reread;
+			if( !Jobq_read( e ) ){
+				Jobq_free_entry( e );
+				continue;
+			}
+		}
+		Jobq_check_max( count+1 );
+		Jobq_list[count++] = e;
+	}
+	closedir(dir);
+
+	/* the ones that have gone away */
+	for( i = 0; i < old_count; ++i ){
+		if( !old_list[i]->found ) Jobq_free_entry( old_list[i] );
+	}
+	free( old_list );
+	Jobq_count = count;
+	qsort( Jobq_list, Jobq_count, sizeof(Jobq_list[0]), Jobq_cmp_name );
+
+	for( i = 0; i < Jobq_count; ++i ){
+		e = Jobq_list[i];
+		e->found = e->done_in = e->expire_in = 0;
+		Jobq_classify( e );
+		if( e->p ) ++printable;
+		if( e->h ) ++held;
+		if( e->m ) ++move;
+		if( e->e ) ++error;
+		if( e->dn ) ++done;
+		if( e->p || e->m || e->e || e->dn ){
+			Set_str_value( sort_order, e->job.sort_key, e->name );
+		}
+	}
+	if( pprintable ) *pprintable = printable;
+	if( pheld ) *pheld = held;
+	if( pmove ) *pmove = move;
+	if( perr ) *perr = error;
+	if( pdone ) *pdone = done;
+	DEBUG1("Jobq_scan: %d jobs, %d read, %d ready, printable %d, held %d, move %d, error %d, done %d",
+		Jobq_count, reread, Jobq_heap_count, printable, held, move, error, done );
+	return( 0 );
+}
+
+/*
+ * Jobq_start - start a pass through the jobs
+ *  put back the jobs from the last pass and reread the active ones
+ */
+
+void Jobq_start( void )
+{
+	struct jobq_entry *e, **list;
+	int i, count;
+
+	for( i = 0; i < Jobq_taken_count; ++i ){
+		e = Jobq_taken[i];
+		switch( Jobq_taken_how[i] ){
+		case JOBQ_PARK:
+			e->state = JOBQ_PARKED;
+			break;
+		case JOBQ_RECHECK:
+			e->state = JOBQ_RECHECK;
+			Jobq_recheck[Jobq_recheck_count++] = e;
+			break;
+		default:
+			Jobq_push( e );
+			break;
+		}
+	}
+	Jobq_taken_count = 0;
+
+	count = Jobq_recheck_count;
+	if( count == 0 ) return;
+	list = malloc_or_die( count * sizeof(list[0]), __FILE__,__LINE__ );
+	memcpy( list, Jobq_recheck, count * sizeof(list[0]) );
+	Jobq_recheck_count = 0;
+	for( i = 0; i < count; ++i ){
+		e = list[i];
+		if( Jobq_read( e ) ){
+			Jobq_classify( e );
+		} else {
+			/* removed - it stays in Jobq_list until the next scan */
+			DEBUG3("Jobq_start: '%s' removed", e->name );
+			Jobq_forget( e );
+			e->state = JOBQ_IDLE;
+		}
+	}
+	free( list );
+}
+
+/*
+ * Jobq_next - the job ticket name of the next job to try, or 0
+ */
+
+char *Jobq_next( void )
+{
+	struct jobq_entry *e;
+
+	if( Jobq_heap_count == 0 ) return( 0 );
+	e = Jobq_heap[0];
+	Jobq_heap[0] = Jobq_heap[--Jobq_heap_count];
+	Jobq_sift_down( 0 );
+	e->state = JOBQ_TAKEN;
+	Jobq_taken[Jobq_taken_count] = e;
+	Jobq_taken_how[Jobq_taken_count] = JOBQ_KEEP;
+	++Jobq_taken_count;
+	DEBUG3("Jobq_next: '%s', %d left", e->name, Jobq_heap_count );
+	return( e->name );
+}
+
+/*
+ * Jobq_set - what to do with the job last returned by Jobq_next()
+ */
+
+void Jobq_set( int how )
+{
+	if( Jobq_taken_count > 0 ){
+		Jobq_taken_how[Jobq_taken_count-1] = how;
+	}
+}
+
+/*
+ * Jobq_active - we have the jobs of the current queue
+ */
+
+int Jobq_active( void )
+{
+	return( Jobq_dir && !safestrcmp( Jobq_dir, Spool_dir_DYN ) );
+}
+
+/*
+ * Jobq_expired - the job ticket name of the next job whose status has
+ *  expired at time now, or 0
+ */
+
+char *Jobq_expired( time_t now )
+{
+	struct jobq_entry *e;
+
+	while( Jobq_expire_count > 0 && Jobq_expire[0].t <= now ){
+		e = Jobq_expire[0].e;
+		if( e->expire_in && e->expire_t == Jobq_expire[0].t ){
+			Jobq_time_pop( Jobq_expire, &Jobq_expire_count );
+			Jobq_forget( e );
+			return( e->name );
+		}
+		Jobq_time_pop( Jobq_expire, &Jobq_expire_count );
+	}
+	return( 0 );
+}
+
+/*
+ * Jobq_oldest_done - the job ticket name of the oldest done job if
+ *  there are more than keep of them, or 0
+ */
+
+char *Jobq_oldest_done( int keep )
+{
+	struct jobq_entry *e;
+
+	while( Jobq_done_jobs > keep && Jobq_done_count > 0 ){
+		e = Jobq_done[0].e;
+		if( e->done_in && e->done_t == Jobq_done[0].t ){
+			Jobq_time_pop( Jobq_done, &Jobq_done_count );
+			Jobq_forget( e );
+			return( e->name );
+		}
+		Jobq_time_pop( Jobq_done, &Jobq_done_count );
+	}
+	return( 0 );
+}
+
+/*
+ * Jobq_expire_wait - the number of seconds until the next job status
+ *  expires, or 0 if there are none
+ */
+
+int Jobq_expire_wait( time_t now )
+{
+	struct jobq_entry *e;
+
+	while( Jobq_expire_count > 0 ){
+		e = Jobq_expire[0].e;
+		if( e->expire_in && e->expire_t == Jobq_expire[0].t ){
+			if( Jobq_expire[0].t <= now ) return( 1 );
+			return( Jobq_expire[0].t - now );
+		}
+		Jobq_time_pop( Jobq_expire, &Jobq_expire_count );
+	}
+	return( 0 );
+}
@@ -28,9 +28,11 @@
 #include "stty.h"
 #include "openprinter.h"
 
+#include "lpd_jobq.h"
 #include "lpd_jobs.h"
 #include "lpd_rcvjob.h"
 #include "lpd_worker.h"
+#include "stats.h"
 
 #if defined(USER_INCLUDE)
 # include USER_INCLUDE
@@ -53,6 +55,12 @@ static void Setup_user_reporting( struct job *job );
 static void Filter_files_in_job( struct job *job, int outfd, char *user_filter );
 static int Move_job(int fd, struct job *job, struct line_list *sp,
 	char *errmsg, int errlen );
+static int Remove_done_sort_order( void );
+static void Start_lookahead( void );
+
+/* the filter_lookahead process and the job ticket it is doing */
+static pid_t Lookahead_pid;
+static char Lookahead_hf[SMALLBUFFER];
 
 /***************************************************************************
  * Commentary:
@@ -182,6 +190,7 @@ static void Update_spool_info( struct line_list *sp )
 	Set_str_value(&info,IDENTIFIER, Find_str_value(sp,IDENTIFIER) );
 	Set_str_value(&info,SERVER, Find_str_value(sp,SERVER) );
 	Set_str_value(&info,DONE_TIME, Find_str_value(sp,DONE_TIME) );
+	Set_str_value(&info,START_USEC, Find_str_value(sp,START_USEC) );
 
 	sc = Find_str_value(&info,QUEUE_CONTROL_FILE);
 
@@ -362,9 +371,6 @@ static char *Make_temp_copy( char *srcfile, char *destdir )
  * Do_queue_jobs: process the job queue
  ***************************************************************************/
 
- static int Done_count;
- static time_t Done_time;
-
 int Do_queue_jobs( char *name, int subserver )
 {
 	int master = 0;		/* this is the master */
@@ -372,7 +378,7 @@ int Do_queue_jobs( char *name, int subserver )
 	int lock_fd;	/* fd for files */
 	char buffer[SMALLBUFFER], *savename = 0, errmsg[SMALLBUFFER], *save_move_dest;
 	char *path, *s, *id, *tempfile, *transfername, *openname,
-		*new_dest, *move_dest, *pr, *hf_name, *forwarding;
+		*new_dest, *move_dest, *pr, *hf_name, *forwarding, *ticket_name;
 	struct stat statb;
 	int i, j, mod, fd, pid, printable, held, move, destinations,
 		destination, use_subserver, job_to_do, working, printing_enabled,
@@ -571,8 +577,8 @@ int Do_queue_jobs( char *name, int subserver )
 	if(DEBUGL4){ int fdx; fdx = dup(0);
 		LOGDEBUG("Do_queue_jobs: after subservers next fd %d",fdx);close(fdx);};
 	/* get new job values */
-	if( Scan_queue( &Spool_control, &Sort_order,
-			&printable, &held, &move, 1, &error, &done, 0, 0 ) ){
+	if( Jobq_scan( &Spool_control, &Sort_order,
+			&printable, &held, &move, &error, &done ) ){
 		Errorcode = JFAIL;
 		fatal(LOG_ERR, "Do_queue_jobs: cannot read queue directory '%s'",
 			Spool_dir_DYN );
@@ -635,23 +641,15 @@ int Do_queue_jobs( char *name, int subserver )
 		plp_unblock_all_signals( &oblock );
 		plp_set_signal_mask( &oblock, 0 );
 
-		if( (Done_jobs_DYN > 0 && Done_count > Done_jobs_DYN)
-			 || (Done_jobs_max_age_DYN > 0
-					&& Done_time
-					&& (time(0) - Done_time) > Done_jobs_max_age_DYN) ){
-			Susr1 = 1;
-		}
 		DEBUG1( "Do_queue_jobs: Susr1 before scan %d, check_for_done %d",
 			Susr1, check_for_done );
 		while( Susr1 ){
 			Susr1 = 0;
-			Done_time = 0;
-			Done_count = 0;
 			DEBUG1( "Do_queue_jobs: rescanning" );
 
 			Get_spool_control( Queue_control_file_DYN, &Spool_control);
-			if( Scan_queue( &Spool_control, &Sort_order,
-					&printable, &held, &move, 1, &error, &done, 0, 0 ) ){
+			if( Jobq_scan( &Spool_control, &Sort_order,
+					&printable, &held, &move, &error, &done ) ){
 				logerr_die(LOG_ERR, "Do_queue_jobs: cannot read queue '%s'",
 					Spool_dir_DYN );
 			}
@@ -688,8 +686,6 @@ int Do_queue_jobs( char *name, int subserver )
 		if(DEBUGL4) Dump_line_list("Do_queue_jobs - sort order printable",
 			&Sort_order );
 
-		Remove_done_jobs();
-
 		/* make sure you can print */
 		printing_enabled
 			= !(Pr_disabled(&Spool_control) || Pr_aborted(&Spool_control));
@@ -713,8 +709,14 @@ int Do_queue_jobs( char *name, int subserver )
 			}
 		}
 
+		/* jobs come out of the Jobq heap in Sort_order order,
+		 * skipping the ones that are not printable
+		 */
+		Jobq_start();
+		/* after Jobq_start(),  which finds the jobs that just finished */
+		Remove_done_jobs();
 		fd = -1;
-		for( job_index = 0; job_to_do < 0 && job_index < Sort_order.count;
+		for( job_index = 0; job_to_do < 0 && (ticket_name = Jobq_next());
 			++job_index ){
 			if( fd > 0 ) close(fd); fd = -1;
 
@@ -737,17 +739,20 @@ int Do_queue_jobs( char *name, int subserver )
 			destination = use_subserver = job_to_do = -1;
 			destinations = 0;
 
-			if( !Sort_order.list[job_index] ) continue;
 			DEBUG3("Do_queue_jobs: job_index [%d] '%s'", job_index,
-				Sort_order.list[job_index] );
-			Get_job_ticket_file( &fd, &job, Sort_order.list[job_index] );
+				ticket_name );
+			Get_job_ticket_file( &fd, &job, ticket_name );
 
 			if(DEBUGL4)Dump_job("Do_queue_jobs: job ",&job);
-			if( job.info.count == 0 ) continue;
+			if( job.info.count == 0 ){
+				Jobq_set( JOBQ_RECHECK );
+				continue;
+			}
 
 			/* check to see if active */
 			if( (pid = Find_flag_value(&job.info,SERVER)) ){
 				DEBUG3("Do_queue_jobs: [%d] active %d", job_index, pid );
+				Jobq_set( JOBQ_RECHECK );
 				continue;
 			}
 
@@ -756,10 +761,11 @@ int Do_queue_jobs( char *name, int subserver )
 			Job_printable(&job,&Spool_control,&printable,&held,&move,&error,&done);
 			if( (!(printable && (printing_enabled || forwarding)) && !move) || held ){
 				DEBUG3("Do_queue_jobs: [%d] not processable", job_index );
-				/* free( Sort_order.list[job_index] ); Sort_order.list[job_index] = 0; */
+				Jobq_set( JOBQ_PARK );
 				continue;
 			}
 			if( Check_print_perms(&job) == P_REJECT ){
+				Jobq_set( JOBQ_RECHECK );
 				Set_str_value(&job.info,ERROR,"no permission to print");
 				Set_nz_flag_value(&job.info,ERROR_TIME,time(0));
 				if( Set_job_ticket_file( &job, 0, fd ) ){
@@ -773,13 +779,13 @@ int Do_queue_jobs( char *name, int subserver )
 				if( !(Save_on_error_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 					setstatus( &job, _("removing job '%s' - no permissions"), id);
 					Remove_job( &job );
-					free( Sort_order.list[job_index] ); Sort_order.list[job_index] = 0;
 				}
 				continue;
 			}
 			{
 				double jobsize = Find_double_value(&job.info,SIZE);
 				if( jobsize == 0 && Discard_zero_length_jobs_DYN ){
+					Jobq_set( JOBQ_RECHECK );
 					Set_str_value(&job.info,ERROR,"not printing zero length job");
 					Set_nz_flag_value(&job.info,ERROR_TIME,time(0));
 					if( Set_job_ticket_file( &job, 0, fd ) ){
@@ -793,7 +799,6 @@ int Do_queue_jobs( char *name, int subserver )
 					if( !(Save_on_error_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 						setstatus( &job, _("removing job '%s' - no permissions"), id);
 						Remove_job( &job );
-						free( Sort_order.list[job_index] ); Sort_order.list[job_index] = 0;
 					}
 					continue;
 				}
@@ -836,6 +841,7 @@ int Do_queue_jobs( char *name, int subserver )
 				if( all_done == destinations ){
 					DEBUG3("Do_queue_jobs: destinations %d, done %d",
 						destinations, all_done );
+					Jobq_set( JOBQ_RECHECK );
 					Update_status( fd, &job, JSUCC );
 					continue;
 				}
@@ -923,6 +929,7 @@ int Do_queue_jobs( char *name, int subserver )
 						setstatus(&job, "CHOOSER_ROUTINE exit status %s", Server_status(j));
 						chooser_did_not_find_server = 1;
 						if( j != JFAIL && j != JABORT ){
+							Jobq_set( JOBQ_RECHECK );
 							Update_status( fd, &job, j );
 						}
 						if( j == JABORT ){
@@ -965,6 +972,7 @@ int Do_queue_jobs( char *name, int subserver )
 						setstatus(&job, "CHOOSER exit status %s", Server_status(j));
 						chooser_did_not_find_server = 1;
 						if( j != JFAIL && j != JABORT ){
+							Jobq_set( JOBQ_RECHECK );
 							Update_status( fd, &job, j );
 						}
 						if( j == JABORT ){
@@ -1024,6 +1032,9 @@ int Do_queue_jobs( char *name, int subserver )
 			}
 		}
 
+		/* the job we start is reread on the next pass */
+		if( job_to_do >= 0 ) Jobq_set( JOBQ_RECHECK );
+
 		/* first, we see if there is no work and no server active */
 		DEBUG1("Do_queue_jobs: job_to_do %d, use_subserver %d, working %d, move_dest %s",
 			job_to_do, use_subserver, working, move_dest );
@@ -1047,7 +1058,8 @@ int Do_queue_jobs( char *name, int subserver )
 				} else {
 					setstatus(0, "waiting for subserver to exit" );
 				}
-				Wait_for_subserver( 0, -1, &servers );
+				/* wake up for the next done job status to expire */
+				Wait_for_subserver( Jobq_expire_wait( time((void *)0) ), -1, &servers );
 			}
 			continue;
 		}
@@ -1223,11 +1235,17 @@ int Do_queue_jobs( char *name, int subserver )
 			Set_str_value(&tinfo,MOVE_DEST,move_dest);
 			Set_str_value(sp,HF_NAME,hf_name);
 			Set_str_value(sp,IDENTIFIER,id);
+			if( Lookahead_pid > 0 && !safestrcmp( ticket_name, Lookahead_hf ) ){
+				setstatus( &job, "waiting for lookahead filter to finish" );
+				Wait_for_subserver( 0, Lookahead_pid, &servers );
+			}
 			if( (pid = Fork_subserver( &servers, 0, &tinfo )) < 0 ){
 				setstatus( &job, _("sleeping, waiting for processes to exit"));
 				plp_sleep(1);
 				Set_str_value(sp,HF_NAME,0);
 				Set_str_value(sp,IDENTIFIER,0);
+			} else if( servers.count == 1 && !new_dest ){
+				Start_lookahead();
 			}
 			jobs_printed = 1;
 		}
@@ -1274,6 +1292,49 @@ int Do_queue_jobs( char *name, int subserver )
 	cleanup(0);
 }
 
+/***************************************************************************
+ * Start_lookahead()
+ *  with filter_lookahead,  start a process to run the filters for the
+ *  next job in the queue while the job we just started is printing.
+ *  The output is saved in files that Print_job() sends instead of
+ *  running the filters again;  when the job is started we wait for
+ *  the lookahead process if it is still working on it.
+ ***************************************************************************/
+
+static void Start_lookahead( void )
+{
+	struct line_list args;
+	struct job job;
+	char *ticket_name;
+
+	if( !Filter_lookahead_DYN || Lookahead_pid > 0 || RemotePrinter_DYN
+		|| Frwarding(&Spool_control) ){
+		return;
+	}
+	/* this goes back into the heap at the next Jobq_start() */
+	if( !(ticket_name = Jobq_next()) || !strcmp( ticket_name, Lookahead_hf ) ){
+		return;
+	}
+	Init_job(&job);
+	Init_line_list(&args);
+	Get_job_ticket_file( 0, &job, ticket_name );
+	if( job.info.count && !Find_flag_value(&job.info,SERVER)
+		&& !Find_flag_value(&job.info,DESTINATIONS)
+		&& !Find_str_value(&job.info,MOVE) ){
+		DEBUG1("Start_lookahead: '%s'", ticket_name );
+		Set_str_value(&args,PRINTER,Printer_DYN);
+		Set_str_value(&args,HF_NAME,ticket_name);
+		if( (Lookahead_pid = Start_worker( "lookahead", Service_lookahead,
+			&args, 0 )) > 0 ){
+			safestrncpy( Lookahead_hf, ticket_name );
+		} else {
+			Lookahead_pid = 0;
+		}
+	}
+	Free_line_list(&args);
+	Free_job(&job);
+}
+
 /***************************************************************************
  * Remote_job()
  * Send a job to a remote server.  This code is actually trickier
@@ -1284,7 +1345,7 @@ int Do_queue_jobs( char *name, int subserver )
 static int Remote_job( struct job *job, int lpd_bounce, char *move_dest, char *id )
 {
 	int status, tempfd, n, fd;
-	double job_size;
+	double job_size, start;
 	char buffer[SMALLBUFFER], *s, *tempfile, *oldid, *newid, *old_lp_value, *hf_name;
 	struct line_list *lp, *firstfile;
 	struct job jcopy;
@@ -1343,7 +1404,9 @@ static int Remote_job( struct job *job, int lpd_bounce, char *move_dest, char *i
 		old_lp_value = safestrdup(Find_str_value( &PC_entry_line_list, "lp" ),
 			__FILE__,__LINE__ );
 		Set_str_value( &PC_entry_line_list, LP, tempfile );
+		start = Stats_now();
 		Print_job( tempfd, -1, &jcopy, 0, 0, 0 );
+		Stats_filter( Printer_DYN, Stats_now() - start );
 		Set_str_value( &PC_entry_line_list, LP, old_lp_value );
 		if( old_lp_value ) free(old_lp_value); old_lp_value = 0;
 
@@ -1495,6 +1558,7 @@ static int Local_job( struct job *job, char *id )
 	int status, fd, status_fd, pid, poll_for_status;
 	char *old_lp_value;
 	char buffer[SMALLBUFFER];
+	double start;
 
 	status_fd = fd = -1;
 
@@ -1553,7 +1617,10 @@ static int Local_job( struct job *job, char *id )
 	old_lp_value = safestrdup(Find_str_value( &PC_entry_line_list, LP ),
 		__FILE__,__LINE__ );
 	Set_str_value( &PC_entry_line_list, LP, Lp_device_DYN );
+	start = Stats_now();
 	status = Print_job( fd, status_fd, job, Send_job_rw_timeout_DYN, poll_for_status, 0 );
+	Stats_filter( Printer_DYN, Stats_now() - start );
+	Remove_lookahead_files( job );
 	Set_str_value( &PC_entry_line_list, LP, old_lp_value );
 	if( old_lp_value ) free(old_lp_value); old_lp_value = 0;
 	/* we close close device */
@@ -1623,6 +1690,7 @@ static int Fork_subserver( struct line_list *server_info, int use_subserver,
 
 	if( pid > 0 ){
 		Set_decimal_value(sp,SERVER,pid);
+		Set_double_value(sp,START_USEC,Stats_now());
 	} else {
 		logerr(LOG_ERR, _("Fork_subserver: fork failed") );
 	}
@@ -1649,6 +1717,7 @@ static void Wait_for_subserver( int timeout, int pid_to_wait_for, struct line_li
 	struct line_list *sp = 0;
 	struct job job;
 	char buffer[SMALLBUFFER], *pr, *hf_name, *id;
+	double start;
 
 	flags = WNOHANG;
 	if( pid_to_wait_for != -1 ){
@@ -1669,6 +1738,10 @@ static void Wait_for_subserver( int timeout, int pid_to_wait_for, struct line_li
 	while( (pid = plp_waitpid( pid_to_wait_for, &procstatus, flags )) > 0 ){
 		++done;
 		if( fd > 0 ) close(fd); fd = -1;
+		if( pid == Lookahead_pid ){
+			DEBUG1("Wait_for_subserver: lookahead pid %ld done", (long)pid );
+			Lookahead_pid = 0;
+		}
 		DEBUG1("Wait_for_subserver: pid %ld, status '%s'", (long)pid,
 			Decode_status(&procstatus));
 		if( WIFSIGNALED( procstatus ) ){
@@ -1731,6 +1804,13 @@ static void Wait_for_subserver( int timeout, int pid_to_wait_for, struct line_li
 				DEBUG1( "Wait_for_subserver: server pid %ld for '%s' for '%s' '%s' finished",
 					(long)pid, pr, hf_name, id );
 
+				/* the master server and the subservers */
+				start = Find_double_value(sp,START_USEC);
+				Stats_job_done( pr, status,
+					Find_double_value(&job.info,SIZE),
+					start - (Find_flag_value(&job.info,JOB_TIME) * 1000000.0
+						+ Find_flag_value(&job.info,JOB_TIME_USEC)),
+					Stats_now() - start );
 				/* see if you can get the job ticket file and update the status */
 				Update_status( fd, &job, status );
 				Set_str_value(sp,HF_NAME,0);
@@ -2006,8 +2086,6 @@ static void Update_status( int fd, struct job *job, int status )
 				if(DEBUGL3)Dump_job("Update_status - done_job", job );
 				if( (Save_when_done_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 					setstatus( job, _("job '%s' saved"), id );
-					++Done_count;
-					if( !Done_time ) Done_time = time(0);
 				} else {
 					if( Remove_job( job ) ){
 						setstatus( job, _("could not remove job '%s'"), id);
@@ -2113,8 +2191,6 @@ static void Update_status( int fd, struct job *job, int status )
 			Sendmail_to_user( status, job );
 			if( (Save_on_error_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 				setstatus( job, _("job '%s' saved"), id );
-				++Done_count;
-				if( !Done_time ) Done_time = time(0);
 			} else {
 				setstatus( job, _("removing job '%s' - JFAILNORETRY"), id);
 				if( Remove_job( job ) ){
@@ -2155,8 +2231,6 @@ static void Update_status( int fd, struct job *job, int status )
 			Sendmail_to_user( status, job );
 			if( (Save_on_error_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 				setstatus( job, _("job '%s' saved"), id );
-				++Done_count;
-				if( !Done_time ) Done_time = time(0);
 			} else {
 				setstatus( job, _("removing job '%s' - JABORT"), id);
 				if( Remove_job( job ) ){
@@ -2199,8 +2273,6 @@ static void Update_status( int fd, struct job *job, int status )
 			Sendmail_to_user( status, job );
 			if( (Save_on_error_DYN || Done_jobs_DYN || Done_jobs_max_age_DYN) ){
 				setstatus( job, _("job '%s' saved"), id );
-				++Done_count;
-				if( !Done_time ) Done_time = time(0);
 			} else {
 				setstatus( job, _("removing job '%s' - JREMOVE"), id);
 				if( Remove_job( job ) ){
@@ -2643,8 +2715,9 @@ static void Filter_files_in_job( struct job *job, int outfd, char *user_filter )
 					if_error[0], filtermsgbuffer, sizeof(filtermsgbuffer)-1,
 					0, 0, 0, Status_file_DYN );
 				if( filtermsgbuffer[0] ){
-					setstatus(job, "%s filter msg - '%s'", filter_title, filtermsgbuffer );
+					Filter_status(job, filter_title, filtermsgbuffer );
 				}
+				Flush_filter_status( job, 1 );
 				if( n ){
 					Errorcode = n;
 					setstatus(job, "%s filter problems, error '%s'",
@@ -2682,6 +2755,35 @@ static void Filter_files_in_job( struct job *job, int outfd, char *user_filter )
 	if(DEBUGL3)Dump_job("Filter_files_in_job", job);
 }
 
+/*
+ * Service_lookahead - run the filters for the job in HF_NAME
+ *  see Start_lookahead()
+ */
+
+void Service_lookahead( struct line_list *args, int param_fd UNUSED )
+{
+	struct job job;
+	char buffer[SMALLBUFFER];
+
+	Name = "(Lookahead)";
+	Init_job(&job);
+	Set_DYN(&Printer_DYN, Find_str_value(args,PRINTER));
+	setproctitle( "lpd %s '%s'", Name, Printer_DYN );
+	Errorcode = JABORT;
+	if( Setup_printer( Printer_DYN, buffer, sizeof(buffer), 0 ) ){
+		cleanup(0);
+	}
+	Get_job_ticket_file( 0, &job, Find_str_value(args,HF_NAME) );
+	Free_line_list(args);
+	if( job.info.count ){
+		setstatus( &job, "running filters ahead of printing" );
+		Lookahead_job( &job );
+	}
+	Free_job(&job);
+	Errorcode = 0;
+	cleanup(0);
+}
+
 void Service_queue( struct line_list *args, int param_fd UNUSED )
 {
 	int subserver;
@@ -2694,8 +2796,12 @@ void Service_queue( struct line_list *args, int param_fd UNUSED )
 	cleanup(0);
 }
 
+/*
+ * Remove_done_sort_order - check each job in Sort_order
+ *  Used when the queue is not in the Jobq tables.
+ */
 
-int Remove_done_jobs( void )
+static int Remove_done_sort_order( void )
 {
 	struct job job;
 	char *id;
@@ -2705,14 +2811,6 @@ int Remove_done_jobs( void )
 	struct line_list info;
 	char tval[SMALLBUFFER];
 
-	DEBUG3("Remove_done_jobs: save_when_done %d, save_on_error %d, done_jobs %d, d_j_max_age %d",
-		Save_when_done_DYN, Save_on_error_DYN,
-		Done_jobs_DYN, Done_jobs_max_age_DYN );
-	if( Save_when_done_DYN || Save_on_error_DYN
-		|| !(Done_jobs_DYN > 0 || Done_jobs_max_age_DYN > 0) ){
-		return( 0 );
-	}
-
 	Init_line_list(&info);
 	time( &tm );
 	Init_job(&job);
@@ -2792,6 +2890,89 @@ int Remove_done_jobs( void )
 	return( removed );
 }
 
+/*
+ * Remove_done_jobs - remove the done and failed jobs that are not to
+ *  be kept any longer.  The queue server keeps them in the Jobq heaps,
+ *  the other processes (lpq) look at each job in Sort_order.
+ */
+
+int Remove_done_jobs( void )
+{
+	struct job job;
+	char *id, *job_ticket_file;
+	int removed = 0, fd, pid, error, done, incoming;
+	time_t tm;
+
+	DEBUG3("Remove_done_jobs: save_when_done %d, save_on_error %d, done_jobs %d, d_j_max_age %d",
+		Save_when_done_DYN, Save_on_error_DYN,
+		Done_jobs_DYN, Done_jobs_max_age_DYN );
+	if( Save_when_done_DYN || Save_on_error_DYN
+		|| !(Done_jobs_DYN > 0 || Done_jobs_max_age_DYN > 0) ){
+		return( 0 );
+	}
+	if( !Jobq_active() ){
+		return( Remove_done_sort_order() );
+	}
+
+	time( &tm );
+	Init_job(&job);
+	fd = -1;
+	while( (job_ticket_file = Jobq_expired( tm )) ){
+		Free_job(&job);
+		if( fd > 0 ) close(fd); fd = -1;
+		Get_job_ticket_file( &fd, &job, job_ticket_file );
+		if( job.info.count == 0 ) continue;
+		id = Find_str_value(&job.info,IDENTIFIER);
+		done = Find_flag_value(&job.info,DONE_TIME);
+		error = Find_flag_value(&job.info,ERROR_TIME);
+		incoming = Find_flag_value(&job.info,INCOMING_TIME);
+		pid = Find_flag_value(&job.info,INCOMING_PID);
+		DEBUG3("Remove_done_jobs: expired '%s', done 0x%x, error 0x%x, incoming 0x%x",
+			job_ticket_file, done, error, incoming );
+		if( incoming && pid && kill( pid, 0 ) ){
+			/* we have a stale incoming job */
+			Remove_job( &job );
+			continue;
+		}
+		if( (pid = Find_flag_value(&job.info,SERVER)) && kill( pid, 0 ) == 0 ){
+			DEBUG3("Remove_done_jobs: '%s' active %d", job_ticket_file, pid );
+			continue;
+		}
+		if( Done_jobs_max_age_DYN > 0
+			&& ( (error && (tm - error) > Done_jobs_max_age_DYN)
+			   || (done && (tm - done) > Done_jobs_max_age_DYN) ) ){
+			setstatus( &job, _("job '%s' removed- status expired"), id );
+			Remove_job( &job );
+		}
+	}
+	while( Done_jobs_DYN > 0
+		&& (job_ticket_file = Jobq_oldest_done( Done_jobs_DYN )) ){
+		Free_job(&job);
+		if( fd > 0 ) close(fd); fd = -1;
+		DEBUG1( "Remove_done_jobs: removing '%s'", job_ticket_file );
+		Get_job_ticket_file( &fd, &job, job_ticket_file );
+		if( job.info.count == 0 ) continue;
+		/* it may have been requeued or restarted since it went in */
+		if( !(Find_flag_value(&job.info,REMOVE_TIME)
+			|| Find_flag_value(&job.info,ERROR_TIME)) ){
+			DEBUG3("Remove_done_jobs: '%s' not done", job_ticket_file );
+			continue;
+		}
+		if( (pid = Find_flag_value(&job.info,SERVER)) && kill( pid, 0 ) == 0 ){
+			DEBUG3("Remove_done_jobs: '%s' active %d", job_ticket_file, pid );
+			continue;
+		}
+		Remove_job( &job );
+		removed = 1;
+	}
+	if( fd > 0 ) close(fd); fd = -1;
+	Free_job(&job);
+	if( removed && Lpq_status_file_DYN ){
+		unlink(Lpq_status_file_DYN);
+	}
+	return( removed );
+}
+
 /*
  * move the job to a new spool queue
  *  This will only work if the queue/printer is on the same
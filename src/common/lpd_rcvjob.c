@@ -23,9 +23,9 @@
 #include "lpd_remove.h"
 #include "lpd_rcvjob.h"
 #include "lpd_jobs.h"
+#include "stats.h"
 /**** ENDINCLUDE ****/
 
-static int Read_one_line( int timeout, int fd, char *buffer, int maxlen );
 static int Get_route( struct job *job, char *error, int errlen );
 static int Do_incoming_control_filter( struct job *job, char *error, int errlen );
 static void Generate_control_file( struct job *job );
@@ -127,6 +127,7 @@ int Receive_job( int *sock, char *input )
 	Init_line_list(&files);
 	Init_line_list(&info);
 	Init_job(&job);
+	error[0] = 0;
 
 	Name = "RECV";
 
@@ -313,7 +314,8 @@ int Receive_job( int *sock, char *input )
 			goto error;
 		}
 
-		if( discarding_large_job ){
+		/* we keep the control file to record the discarded job */
+		if( discarding_large_job && filetype == DATA_FILE ){
 			temp_fd = Checkwrite( "/dev/null", &statb,0,0,0);
 			tempfile = 0;
 		} else {
@@ -392,7 +394,7 @@ int Receive_job( int *sock, char *input )
 				if( job_ticket_fd < 0 ){
 					goto error;
 				}
-				if( files.count ){
+				if( files.count || discarding_large_job ){
 					/* we have datafiles, FOLLOWED by a control file */
 					if( !discarding_large_job ){
 						if( Check_for_missing_files(&job, &files, error, errlen, 0, job_ticket_fd) ){
@@ -511,7 +513,7 @@ int Receive_job( int *sock, char *input )
 	Free_job(&job);
 	Free_line_list(&l);
 
-	cleanup( 0 );
+	return( error[0] != 0 );
 }
 
 /***************************************************************************
@@ -767,7 +769,8 @@ int Scan_block_file( int fd, char *error, int errlen, struct line_list *header_i
 		Free_line_list(&l);
 		Free_line_list(&info);
 		startpos = lseek( fd, 0, SEEK_CUR );
-		if( startpos == -1 ){
+		/* the block file can come from a pipe */
+		if( startpos == -1 && errno != ESPIPE ){
 			plp_snprintf( error, errlen, 	
 				_("Scan_block_file: lseek failed '%s'"), Errormsg(errno) );
 			status = 1;
@@ -950,13 +953,15 @@ int Scan_block_file( int fd, char *error, int errlen, struct line_list *header_i
 }
 
 /***************************************************************************
- * static int read_one_line(int fd, char *buffer, int maxlen );
- *  reads one line (terminated by \n) into the buffer
+ * int Read_one_line( int timeout, int fd, char *buffer, int maxlen );
+ *  reads one line (terminated by \n) into the buffer, a character
+ *  at a time so nothing past the end of the line is taken from fd
  *RETURNS:  0 if EOF characters read
  *          n = # chars read
  *          Note: buffer terminated by 0
  ***************************************************************************/
-static int Read_one_line( int timeout, int fd, char *buffer, int maxlen )
+
+int Read_one_line( int timeout, int fd, char *buffer, int maxlen )
 {
 	int len, status;
 	len = status = 0;
@@ -1363,6 +1368,7 @@ int Check_for_missing_files( struct job *job, struct line_list *files,
 		logmsg(LOG_INFO, "Check_for_missing_files: SUCCESS '%s'", transfername);
 		*/
 		setmessage( job, "STATE", "CREATE" );
+		Stats_job_received( Printer_DYN, jobsize );
 	}
 
 	Free_line_list(&datafiles);
@@ -18,6 +18,7 @@
 #include "proctitle.h"
 #include "fileopen.h"
 #include "sendreq.h"
+#include "summary.h"
 /**** ENDINCLUDE ****/
 
 static void Get_queue_remove( char *user, int *sock, struct line_list *tokens,
@@ -98,6 +99,9 @@ int Job_remove( int *sock, char *input )
 		Set_DYN(&Printer_DYN, Printer_DYN );
 		Get_queue_remove( user, sock, &tokens, &done_list );
 	} else {
+		/* not split over processes like lpc:  removing jobs from a
+		 * queue also does its servers and destinations,  and done_list
+		 * has to be shared so that none of them is done twice */
 		Get_all_printcap_entries();
 		for( i = 0; i < All_line_list.count; ++i ){
 			Set_DYN(&Printer_DYN, All_line_list.list[i]);
@@ -240,7 +244,7 @@ static void Get_queue_remove( char *user, int *sock, struct line_list *tokens,
 			Perm_check.user = Find_str_value(&job.info,LOGNAME);
 			Perm_check.host = 0;
 			if( (s = Find_str_value(&job.info,FROMHOST)) 
-				&& Find_fqdn( &PermHost_IP, s ) ){
+				&& Find_fqdn_again( &PermHost_IP, s ) ){
 				Perm_check.host = &PermHost_IP;
 			}
 			Perm_check.service = 'M';
@@ -473,6 +477,7 @@ int Remove_job( struct job *job )
 		openname = Find_str_value(datafile,DFTRANSFERNAME);
 		fail |= Remove_file( openname );
 	}
+	Remove_lookahead_files( job );
 	openname = Find_str_value(&job->info,OPENNAME);
 	fail |= Remove_file( openname );
 	openname = Find_str_value(&job->info,HF_NAME);
@@ -486,5 +491,6 @@ int Remove_job( struct job *job )
 	if( Lpq_status_file_DYN ){
 		unlink(Lpq_status_file_DYN);
 	}
+	Summary_changed( Printer_DYN );
 	return( fail );
 }
@@ -44,6 +44,10 @@
 
 static int Do_secure_work( char *jobsize, int from_server,
 	char *tempfile, struct line_list *header_info );
+static int Do_secure_stream_work( char *jobsize, int from_server,
+	int fd, char *tempfile, struct line_list *header_info );
+static int Secure_header_line( char *line, int linecount, char *jobsize,
+	int from_server, struct line_list *header_info );
 static const struct security *Fix_receive_auth( char *name, struct line_list *info );
 
 /*************************************************************************
@@ -212,12 +216,22 @@ int Receive_secure( int *sock, char *input )
 	DEBUGF(DRECV1)("Receive_secure: sock %d, user '%s', jobsize '%s'",  
 		*sock, user, jobsize );
 
-	status = security->server_receive( sock, Send_job_rw_timeout_DYN,
-		user, jobsize, from_server, authtype,
-		&info,
-		error+1, sizeof(error)-1,
-		&header_info,
-		security, tempfile, Do_secure_work);
+	if( jobsize && security->server_receive_stream ){
+		/* the job does not get staged in the tempfile */
+		status = security->server_receive_stream( sock, Send_job_rw_timeout_DYN,
+			user, jobsize, from_server, authtype,
+			&info,
+			error+1, sizeof(error)-1,
+			&header_info,
+			security, tempfile, Do_secure_stream_work);
+	} else {
+		status = security->server_receive( sock, Send_job_rw_timeout_DYN,
+			user, jobsize, from_server, authtype,
+			&info,
+			error+1, sizeof(error)-1,
+			&header_info,
+			security, tempfile, Do_secure_work);
+	}
 
  error:
 	DEBUGF(DRECV1)("Receive_secure: status %d, ack %d, error '%s'",
@@ -255,7 +269,7 @@ static int Do_secure_work( char *jobsize, int from_server,
 	char *tempfile, struct line_list *header_info )
 {
 	int n, len, linecount = 0, done = 0, fd, status = 0;
-	char *s, *t;
+	char *s;
 	char buffer[SMALLBUFFER];
 	char error[SMALLBUFFER];
 	struct stat statb;
@@ -280,34 +294,8 @@ static int Do_secure_work( char *jobsize, int from_server,
 		DEBUGF(DRECV1)("Do_secure_work: read %d - '%s'", len, buffer );
 		while( !done && (s = safestrchr(buffer,'\n')) ){
 			*s++ = 0;
-			if( safestrlen(buffer) == 0 ){
-				done = 1;
-				break;
-			}
-			DEBUGF(DRECV1)("Do_secure_work: line [%d] '%s'", linecount, buffer );
-			if( (t = strchr(buffer,'=')) ){
-				*t++ = 0;
-				Unescape(t);
-				Set_str_value(header_info, buffer, t );
-			} else {
-				switch( linecount ){
-					case 0:
-						if( jobsize ){
-							if( from_server ){
-								Set_str_value(header_info,CLIENT,buffer);
-							}
-							done = 1;
-						} else {
-							Set_str_value(header_info,INPUT,buffer); break;
-						}
-						break;
-					case 1:
-						Set_str_value(header_info,CLIENT,buffer);
-						done = 1;
-						break;
-				}
-			}
-			++linecount;
+			done = Secure_header_line( buffer, linecount++, jobsize,
+				from_server, header_info );
 			memmove(buffer,s,safestrlen(s)+1);
 			n = safestrlen(buffer);
 		}
@@ -373,6 +361,94 @@ static int Do_secure_work( char *jobsize, int from_server,
 	return( status );
 }
 
+/*
+ * Do_secure_stream_work - Do_secure_work() for a job that is read
+ *  from fd (the header lines followed by the block file) instead of
+ *  the tempfile.  The reply is put in the tempfile.
+ */
+
+static int Do_secure_stream_work( char *jobsize, int from_server,
+	int fd, char *tempfile, struct line_list *header_info )
+{
+	int linecount = 0, done = 0, status = 0, out;
+	char buffer[SMALLBUFFER];
+	char error[SMALLBUFFER];
+	struct stat statb;
+
+	error[0] = 0;
+	while( !done ){
+		if( Read_one_line( Send_query_rw_timeout_DYN, fd,
+			buffer, sizeof(buffer) ) <= 0 ){
+			status = JFAIL;
+			plp_snprintf( error, sizeof(error),
+				"Do_secure_stream_work: incomplete header" );
+			goto error;
+		}
+		done = Secure_header_line( buffer, linecount++, jobsize,
+			from_server, header_info );
+	}
+	DEBUGFC(DRECV1)Dump_line_list("Do_secure_stream_work - header", header_info );
+
+	if( (status = Check_secure_perms( header_info, from_server, error, sizeof(error))) ){
+		goto error;
+	}
+	DEBUGFC(DRECV1)Dump_line_list("Do_secure_stream_work - header after check", header_info );
+
+	status = Scan_block_file( fd, error, sizeof(error), header_info );
+
+ error:
+	DEBUGF(DRECV1)("Do_secure_stream_work: status %d, tempfile '%s', error '%s'",
+		status, tempfile, error );
+	if( (out = Checkwrite(tempfile,&statb,O_WRONLY|O_TRUNC,1,0)) < 0 ){
+		Errorcode = JFAIL;
+		logerr_die(LOG_INFO, "Do_secure_stream_work: reopen of '%s' for write failed",
+			tempfile );
+	}
+	if( error[0] ) Write_fd_str(out,error);
+	close(out);
+	return( status );
+}
+
+/*
+ * Secure_header_line - put a line of the secure transfer header
+ *  into header_info,  returns nonzero at the end of the header
+ */
+
+static int Secure_header_line( char *line, int linecount, char *jobsize,
+	int from_server, struct line_list *header_info )
+{
+	int done = 0;
+	char *t;
+
+	if( safestrlen(line) == 0 ){
+		return( 1 );
+	}
+	DEBUGF(DRECV1)("Secure_header_line: line [%d] '%s'", linecount, line );
+	if( (t = strchr(line,'=')) ){
+		*t++ = 0;
+		Unescape(t);
+		Set_str_value(header_info, line, t );
+	} else {
+		switch( linecount ){
+			case 0:
+				if( jobsize ){
+					if( from_server ){
+						Set_str_value(header_info,CLIENT,line);
+					}
+					done = 1;
+				} else {
+					Set_str_value(header_info,INPUT,line); break;
+				}
+				break;
+			case 1:
+				Set_str_value(header_info,CLIENT,line);
+				done = 1;
+				break;
+		}
+	}
+	return( done );
+}
+
 
 /***************************************************************************
  * void Fix_auth() - get the Use_auth_DYN value for the remote printer
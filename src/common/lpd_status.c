@@ -23,6 +23,7 @@
 
 #include "lpd_jobs.h"
 #include "lpd_status.h"
+#include "summary.h"
 
 /**** ENDINCLUDE ****/
 
@@ -74,6 +75,8 @@
 
 static void Print_status_info( int *sock, char *file,
 	char *prefix, int status_lines, int max_size );
+static void All_queue_summary( int *sock, int status_lines,
+	struct line_list *done_list, char *hash_key );
 
 int Job_status( int *sock, char *input )
 {
@@ -207,6 +210,9 @@ int Job_status( int *sock, char *input )
 		DEBUGF(DLPQ1)("Job_status: checking printcap entry '%s'",  name );
 		Get_queue_status( &l, sock, displayformat, status_lines,
 			&done_list, Max_status_size_DYN, hash_key );
+	} else if( displayformat == REQ_DSHORT && l.count == 0
+		&& Perm_filters_line_list.count == 0 ){
+		All_queue_summary( sock, status_lines, &done_list, hash_key );
 	} else {
 		/* we work our way down the printcap list, checking for
 			ones that have a spool queue */
@@ -243,6 +249,65 @@ int Job_status( int *sock, char *input )
 	return(0);
 }
 
+/***************************************************************************
+ * All_queue_summary - short status of all of the queues
+ *  The lines come from the queue summary records where we can;  the
+ *  queues that have changed since their line was made,  whose line has
+ *  expired,  or that have never been scanned,  get the usual Get_queue_status(),  which updates the
+ *  record.  The permission check is the one Get_queue_status() does,
+ *  without the per printer permission filters.
+ ***************************************************************************/
+
+static void All_queue_summary( int *sock, int status_lines,
+	struct line_list *done_list, char *hash_key )
+{
+	struct line_list tokens, outbuf;
+	char line[SMALLBUFFER], *s;
+	int i, from_summary = 0, db, dbflag;
+
+	db = Debug;
+	dbflag = DbgFlag;
+	Init_line_list(&tokens);
+	Init_line_list(&outbuf);
+	Get_all_printcap_entries();
+	Perm_check.service = 'Q';
+	for( i = 0; i < All_line_list.count; ++i ){
+		Set_DYN(&Printer_DYN, All_line_list.list[i] );
+		if( Find_exists_value(done_list,Printer_DYN,Hash_value_sep ) ){
+			continue;
+		}
+		Perm_check.printer = Printer_DYN;
+		if( Summary_get( Printer_DYN, line, sizeof(line) )
+			&& Perms_check( &Perm_line_list, &Perm_check, 0, 0 ) != P_REJECT ){
+			Add_line_list(done_list,Printer_DYN,Hash_value_sep,1,1);
+			Add_line_list(&outbuf,line,0,0,0);
+			++from_summary;
+			continue;
+		}
+		/* keep the order of the lines */
+		if( (s = Join_line_list(&outbuf,"")) ){
+			if( Write_fd_str( *sock, s ) < 0 ) cleanup(0);
+			free(s);
+		}
+		Free_line_list(&outbuf);
+		Debug = db;
+		DbgFlag = dbflag;
+		Get_queue_status( &tokens, sock, REQ_DSHORT, status_lines,
+			done_list, Max_status_size_DYN, hash_key );
+		Perm_check.service = 'Q';
+	}
+	if( (s = Join_line_list(&outbuf,"")) ){
+		if( Write_fd_str( *sock, s ) < 0 ) cleanup(0);
+		free(s);
+	}
+	Debug = db;
+	DbgFlag = dbflag;
+	DEBUGF(DLPQ1)("All_queue_summary: %d of %d queues from summary",
+		from_summary, All_line_list.count );
+	Free_line_list(&outbuf);
+	Free_line_list(&tokens);
+}
+
 /***************************************************************************
  * void Get_queue_status
  * sock - used to send information
@@ -277,6 +342,8 @@ void Get_queue_status( struct line_list *tokens, int *sock,
 	time_t modified = 0;
 	time_t timestamp = 0;
 	time_t now = time( (void *)0 );
+	unsigned long mark = 0;
+	int summary = 0;
 
 	cache_index = -1;
 
@@ -358,6 +425,15 @@ void Get_queue_status( struct line_list *tokens, int *sock,
 		goto error;
 	}
 
+	/* the short status of a queue that shows no other queues
+	 * goes in the queue summary */
+	if( displayformat == REQ_DSHORT && tokens->count == 0
+		&& !safestrcasecmp( buffer, Printer_DYN )
+		&& !Server_names_DYN && !Destinations_DYN && !RemoteHost_DYN ){
+		summary = 1;
+		mark = Summary_mark( Printer_DYN );
+	}
+
 	/* check to see if we have any cached information */
 	if( Lpq_status_cached_DYN > 0 && Lpq_status_file_DYN ){
 		fd = -1;
@@ -449,12 +525,18 @@ void Get_queue_status( struct line_list *tokens, int *sock,
 		if( fd > 0 ){
 			DEBUGF(DLPQ3)("Get_queue_status: reading cached status from fd '%d'", fd );
 			/* We can read the status from the cached data */
+			len = 0;
 			while( (ix = ok_read( fd, buffer, sizeof(buffer)-1 )) > 0 ){
 				if( write( *sock, buffer, ix ) < 0 ){
 					cleanup(0);
 				}
+				len += ix;
 			}
 			close(fd); fd = -1;
+			if( summary && len > 0 && len < (int)sizeof(buffer)-1 ){
+				buffer[len] = 0;
+				Summary_update( Printer_DYN, mark, buffer );
+			}
 			goto remote;
 		}
 		/* OK, we have to cache the status in a file */
@@ -515,6 +597,7 @@ void Get_queue_status( struct line_list *tokens, int *sock,
 	Scan_queue( &Spool_control, &Sort_order, &printable,&held,&move,0,0,0,0,0 );
 	/* check for done jobs, remove any if there are some */
 	if( Remove_done_jobs() ){
+		if( summary ) mark = Summary_mark( Printer_DYN );
 		Scan_queue( &Spool_control, &Sort_order, &printable,&held,&move,0,0,0,0,0 );
 	}
 
@@ -955,6 +1038,9 @@ void Get_queue_status( struct line_list *tokens, int *sock,
 		}
 	}
 	safestrncat( header, "\n" );
+	if( summary ){
+		Summary_update( Printer_DYN, mark, header );
+	}
 	if( Write_fd_str( *sock, header ) < 0 ) cleanup(0);
 	header[0] = 0;
 
@@ -1265,15 +1351,16 @@ static void Print_status_info( int *sock, char *file,
 	if( status_lines > 0 ){
 		i = (status_lines * 100)/1024;
 		if( i == 0 ) i = 1;
-		image = Get_file_image(file, i);
+		image = Get_status_file_image(file, i);
 		Split(&l,image,Line_ends,0,0,0,0,0,0);
 		if( l.count < status_lines ){
 			if( image ) free( image ); image = 0;
-			image = Get_file_image(file, 0);
+			Free_line_list(&l);
+			image = Get_status_file_image(file, 0);
 			Split(&l,image,Line_ends,0,0,0,0,0,0);
 		}
 	} else {
-		image = Get_file_image(file, max_size);
+		image = Get_status_file_image(file, max_size);
 		Split(&l,image,Line_ends,0,0,0,0,0,0);
 	}
 
@@ -0,0 +1,205 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "getqueue.h"
+#include "linelist.h"
+#include "lpd_watch.h"
+/**** ENDINCLUDE ****/
+
+#if defined(HAVE_SYS_INOTIFY_H) && defined(HAVE_INOTIFY_INIT)
+# include <sys/inotify.h>
+# define WATCH_INOTIFY 1
+#endif
+
+/*
+ * Spool queue change tracking
+ *
+ *  The lpd server only learns about new work from connections and
+ *  the Lpd_request pipe;  jobs put into a spool directory by other
+ *  programs, and control file changes, are only found by the periodic
+ *  Service_all scan.  If the system has inotify we watch each spool
+ *  directory instead, and put only the queues that changed on the
+ *  Servers_line_list.  The scan is still done, but at the much longer
+ *  lpd_watch_poll_time interval, as a safety net.
+ *
+ *  The main lpd process does not run Setup_printer(),  so the queues
+ *  are registered by the Service_all scan process:  it sends a line
+ *    =printer spool_dir lock_file control_file
+ *  over the start pipe for each queue it looks at.  When the printcap
+ *  is read again the list is thrown away and a scan started,  so
+ *  removed queues and old spool directories are not watched.
+ *
+ *  Only job ticket files (hf*) and the queue control file are
+ *  of interest;  a change to them when there is no server running for
+ *  the queue means it needs service.
+ */
+
+struct watch_queue {
+	int wd;				/* inotify watch descriptor */
+	char *printer;
+	char *lockfile;		/* full pathname */
+	char *controlfile;	/* name in spool directory */
+};
+
+static struct watch_queue *Watch_list;
+static int Watch_count, Watch_max;
+static int Watch_fd = -1;
+static int Watching;
+
+/*
+ * Watch_init - set up the change tracking, returns the fd to select() on
+ *  or -1 if we cannot watch the queues.
+ */
+
+int Watch_init( void )
+{
+	Watching = 0;
+	if( !Lpd_watch_queues_DYN ) return( -1 );
+#if defined(WATCH_INOTIFY)
+	if( Watch_fd < 0 ){
+		if( (Watch_fd = inotify_init()) < 0 ){
+			logerr(LOG_INFO, "Watch_init: inotify_init failed, polling queues");
+			return( -1 );
+		}
+		Set_nonblock_io( Watch_fd );
+#if defined(FD_CLOEXEC)
+		fcntl( Watch_fd, F_SETFD, FD_CLOEXEC );
+#endif
+	}
+	Watching = 1;
+	DEBUG1("Watch_init: fd %d", Watch_fd );
+#endif
+	return( Watch_fd );
+}
+
+/*
+ * Watch_active - set in the main lpd process and the processes it forks
+ *  when the queues are being watched
+ */
+
+int Watch_active( void )
+{
+	return( Watching );
+}
+
+/*
+ * Watch_queue - add the spool directory of a queue to the watch list
+ *  Queues sharing a spool directory get the same watch descriptor.
+ */
+
+void Watch_queue( const char *printer, const char *dir,
+	const char *lockfile, const char *controlfile )
+{
+#if defined(WATCH_INOTIFY)
+	struct watch_queue *w;
+	int i, wd;
+
+	if( !Watching || ISNULL(printer) || ISNULL(dir) ) return;
+	for( i = 0; i < Watch_count; ++i ){
+		if( !strcmp( Watch_list[i].printer, printer ) ) return;
+	}
+	wd = inotify_add_watch( Watch_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO );
+	if( wd < 0 ){
+		logerr(LOG_INFO, "Watch_queue: cannot watch '%s' for '%s'", dir, printer );
+		return;
+	}
+	if( Watch_count >= Watch_max ){
+		Watch_max += 100;
+		Watch_list = realloc_or_die( Watch_list, Watch_max * sizeof(Watch_list[0]),
+			__FILE__,__LINE__ );
+	}
+	w = &Watch_list[Watch_count++];
+	w->wd = wd;
+	w->printer = safestrdup( printer, __FILE__,__LINE__ );
+	w->lockfile = Make_pathname( dir, lockfile );
+	w->controlfile = safestrdup( controlfile, __FILE__,__LINE__ );
+	DEBUG1("Watch_queue: '%s' dir '%s' wd %d", printer, dir, wd );
+#endif
+}
+
+/*
+ * Watch_reset - the printcap was read again,  drop all of the watches;
+ *  the next Service_all scan registers the queues that are left
+ */
+
+void Watch_reset( void )
+{
+#if defined(WATCH_INOTIFY)
+	int i;
+
+	for( i = 0; i < Watch_count; ++i ){
+		/* queues sharing a directory share the descriptor */
+		inotify_rm_watch( Watch_fd, Watch_list[i].wd );
+		if( Watch_list[i].printer ) free( Watch_list[i].printer );
+		if( Watch_list[i].lockfile ) free( Watch_list[i].lockfile );
+		if( Watch_list[i].controlfile ) free( Watch_list[i].controlfile );
+	}
+	DEBUG1("Watch_reset: dropped %d queues", Watch_count );
+	Watch_count = 0;
+#endif
+}
+
+/*
+ * Watch_changes - read the pending events and add the names of the
+ *  queues needing service to the changed list.
+ *  Returns the number of queues added, or -1 if events were lost and
+ *  all of the queues need to be scanned.
+ */
+
+int Watch_changes( struct line_list *changed )
+{
+	int added = 0;
+#if defined(WATCH_INOTIFY)
+	char buffer[LARGEBUFFER];
+	struct inotify_event *ev;
+	struct watch_queue *w;
+	struct line_list names;
+	int n, i, j, lost = 0;
+	pid_t pid;
+
+	Init_line_list(&names);
+	while( (n = read( Watch_fd, buffer, sizeof(buffer) )) > 0 ){
+		for( i = 0; i + (int)sizeof(*ev) <= n; i += sizeof(*ev) + ev->len ){
+			ev = (struct inotify_event *)(buffer + i);
+			if( ev->mask & IN_Q_OVERFLOW ){
+				lost = 1;
+				continue;
+			}
+			if( ev->len == 0 ) continue;
+			for( j = 0; j < Watch_count; ++j ){
+				w = &Watch_list[j];
+				if( w->wd != ev->wd ) continue;
+				if( strncmp( ev->name, "hf", 2 )
+					&& safestrcmp( ev->name, w->controlfile ) ) continue;
+				DEBUG1("Watch_changes: '%s' changed in '%s'", ev->name, w->printer );
+				Add_line_list( &names, w->printer, 0, 1, 1 );
+			}
+		}
+	}
+	/* we only want the ones without an active server */
+	for( i = 0; i < names.count; ++i ){
+		for( j = 0; j < Watch_count && strcmp( Watch_list[j].printer, names.list[i] ); ++j );
+		if( j == Watch_count ) continue;
+		pid = Read_pid_from_file( Watch_list[j].lockfile );
+		if( pid > 0 && kill( pid, 0 ) == 0 ){
+			DEBUG1("Watch_changes: '%s' has server %ld", names.list[i], (long)pid );
+			continue;
+		}
+		Add_line_list( changed, names.list[i], 0, 0, 0 );
+		++added;
+	}
+	Free_line_list(&names);
+	if( lost ){
+		logmsg(LOG_INFO, "Watch_changes: event queue overflow, scanning all queues");
+		added = -1;
+	}
+#endif
+	return( added );
+}
@@ -13,6 +13,7 @@
 #include "getqueue.h"
 #include "linelist.h"
 #include "lpd_worker.h"
+#include "proctitle.h"
 
 /* this file contains code that was formerly in linelist.c but split
  * out as it is only needed in lpd and pulls much code with it */
@@ -185,3 +186,58 @@ pid_t Start_worker( const char *name, WorkerProc *proc, struct line_list *parms,
 	Free_line_list( &args );
 	return(pid);
 }
+
+/*
+ * Start_periodic - start a process that calls deliver() every
+ *  interval seconds until lpd exits or sends it a SIGINT.
+ *  lpd sends the SIGINT when it rereads the printcap and then starts
+ *  a new process, so the process exits without calling deliver():
+ *  the work is left for the new process and is done at the end of
+ *  its first interval.
+ */
+
+ static volatile int Periodic_exit;
+ static PeriodicProc *Periodic_deliver;
+ static int Periodic_interval;
+
+ static void Periodic_sigint(void)
+{
+	++Periodic_exit;
+	(void) plp_signal_break(SIGINT, (plp_sigfunc_t)Periodic_sigint);
+	return;
+}
+
+static void Periodic_worker( struct line_list *args, int fd ) NORETURN;
+
+static void Periodic_worker( struct line_list *args, int fd )
+{
+	pid_t parent = getppid();
+
+	Name = Find_str_value( args, CALL );
+	setproctitle( "lpd %s", Name );
+	(void) plp_signal_break(SIGINT, (plp_sigfunc_t)Periodic_sigint);
+
+	DEBUG1("Periodic_worker: '%s', interval %d, fd %d",
+		Name, Periodic_interval, fd );
+	while( !Periodic_exit && getppid() == parent ){
+		plp_sleep( Periodic_interval > 0 ? Periodic_interval : 1 );
+		if( !Periodic_exit && getppid() == parent ){
+			(Periodic_deliver)();
+		}
+	}
+	cleanup(0);
+}
+
+pid_t Start_periodic( const char *name, PeriodicProc *deliver, int interval )
+{
+	struct line_list args;
+	pid_t pid;
+
+	Init_line_list(&args);
+	Set_str_value(&args,CALL,name);
+	Periodic_deliver = deliver;
+	Periodic_interval = interval;
+	pid = Start_worker( name, Periodic_worker, &args, 0 );
+	DEBUG1("Start_periodic: '%s' pid %ld", name, (long)pid );
+	return( pid );
+}
@@ -487,94 +487,187 @@ static void getargs( int argc, char *argv[], char *envp[] )
 	}
 }
 
+/*
+ * Output buffer
+ *  The output goes out in large writes instead of through stdio;
+ *  out_flush() must be called before the filter suspends itself.
+ */
+
+#define LPF_BUFFER (64*1024)
+
+static char outbuf[LPF_BUFFER];
+static int outcount;
+static int outerror;
+
+static void out_flush(void)
+{
+	int n, len;
+
+	for( len = 0; !outerror && len < outcount; len += n ){
+		n = write( 1, outbuf+len, outcount-len );
+		if( n < 0 ){
+			if( errno == EINTR ){
+				n = 0;
+				continue;
+			}
+			outerror = errno;
+		}
+	}
+	outcount = 0;
+}
+
+#define out_char(c) do{ if( outcount >= LPF_BUFFER ) out_flush(); \
+	outbuf[outcount++] = (c); }while(0)
+
+static void out_str( const char *s, int len )
+{
+	int n;
+
+	while( len > 0 ){
+		if( outcount >= LPF_BUFFER ) out_flush();
+		n = LPF_BUFFER - outcount;
+		if( n > len ) n = len;
+		memcpy( outbuf+outcount, s, n );
+		outcount += n;
+		s += n;
+		len -= n;
+	}
+}
+
 /*
  * suspend_ofilter():  suspends the output filter, waits for a signal
  */
 static void suspend_ofilter(void)
 {
-	fflush(stdout);
+	out_flush();
 	fflush(stderr);
 	if(debug)FPRINTF(STDERR,"FILTER suspending\n");
 	kill(getpid(), SIGSTOP);
 	if(debug)FPRINTF(STDERR,"FILTER awake\n");
 }
+
 /******************************************
  * prototype filter()
  * filter will scan the input looking for the suspend string
  * if any.
+ *  The input is read in blocks.  Runs of characters that need no
+ *  work are copied to the output as they are;  the characters
+ *  marked in special[] (LF, FF and the first character of the stop
+ *  string),  and everything while part of the stop string has been
+ *  matched,  go through filter_char() one at a time.
  ******************************************/
 
+static const char *stop_str;
+static int state, lastc, lines;
+static char inputline[1024];
+static int inputcount;
+static char special[256];
+
+static void filter_char( int c )
+{
+	if( inputcount < (int)sizeof(inputline) - 3 ) inputline[inputcount++] = c;
+	if( c == '\n' ){
+		inputline[inputcount-1] = 0;
+		if(debug)FPRINTF(STDERR,"INPUTLINE count %d '%s'\n", inputcount, inputline );
+		inputcount = 0;
+		++lines;
+		if( lines > length ){
+			lines -= length;
+			++npages;
+		}
+		if( !literal && crlf == 0 && lastc != '\r' ){
+			out_char( '\r' );
+		}
+	}
+	if( c == '\014' ){
+		++npages;
+		lines = 0;
+		if( !literal && crlf == 0 ){
+			out_char( '\r' );
+		}
+	}
+	if( stop_str ){
+		if( c == stop_str[state] ){
+			++state;
+			if( stop_str[state] == 0 ){
+				state = 0;
+				suspend_ofilter();
+			}
+		} else if( state ){
+			out_str( stop_str, state );
+			state = 0;
+			out_char( c );
+		} else {
+			out_char( c );
+		}
+	} else {
+		out_char( c );
+	}
+	lastc = c;
+}
+
 static void filter_pgm(const char *stop)
 {
-	int c;
-	int state, i, xout, lastc;
-	int lines = 0;
-	char inputline[1024];
-	int inputcount = 0;
+	static char inbuf[LPF_BUFFER];
+	char *s, *t, *end;
+	int n;
 
 	/*
 	 * do whatever initializations are needed
 	 */
 	/* FPRINTF(STDERR, "filter ('%s')\n", stop ? stop : "NULL" ); */
+	stop_str = stop;
+	special['\n'] = special['\014'] = 1;
+	if( stop && stop[0] ) special[(unsigned char)stop[0]] = 1;
 	/*
 	 * now scan the input string, looking for the stop string
 	 */
-	lastc = xout = state = 0;
+	lastc = state = lines = inputcount = 0;
 	npages = 1;
 
-	inputcount = 0;
-	while( (c = getchar()) != EOF ){
-		if( inputcount < (int)sizeof(inputline) - 3 ) inputline[inputcount++] = c;
-		if( c == '\n' ){
-			inputline[inputcount-1] = 0;
-			if(debug)FPRINTF(STDERR,"INPUTLINE count %d '%s'\n", inputcount, inputline );
-			inputcount = 0;
-			++lines;
-			if( lines > length ){
-				lines -= length;
-				++npages;
-			}
-			if( !literal && crlf == 0 && lastc != '\r' ){
-				putchar( '\r' );
-			}
+	while( (n = read( 0, inbuf, sizeof(inbuf) )) != 0 ){
+		if( n < 0 ){
+			if( errno == EINTR ) continue;
+			logerr( "error on STDIN");
+			break;
 		}
-		if( c == '\014' ){
-			++npages;
-			lines = 0;
-			if( !literal && crlf == 0 ){
-				putchar( '\r' );
+		for( s = inbuf, end = inbuf + n; s < end; ){
+			if( state ){
+				filter_char( (unsigned char)*s++ );
+				continue;
 			}
-		}
-		if( stop ){
-			if( c == stop[state] ){
-				++state;
-				if( stop[state] == 0 ){
-					state = 0;
-					suspend_ofilter();
-				}
-			} else if( state ){
-				for( i = 0; i < state; ++i ){
-					putchar( stop[i] );
+			for( t = s; t < end && !special[(unsigned char)*t]; ++t );
+			if( t > s ){
+				out_str( s, t - s );
+				if( debug ){
+					n = t - s;
+					if( n > (int)sizeof(inputline) - 3 - inputcount ){
+						n = (int)sizeof(inputline) - 3 - inputcount;
+					}
+					if( n > 0 ){
+						memcpy( inputline+inputcount, s, n );
+						inputcount += n;
+					}
 				}
-				state = 0;
-				putchar( c );
-			} else {
-				putchar( c );
+				lastc = (unsigned char)t[-1];
+				s = t;
+			}
+			if( s < end ){
+				filter_char( (unsigned char)*s++ );
 			}
-		} else {
-			putchar( c );
 		}
-		lastc = c;
-	}
-	if( ferror( stdin ) ){
-		logerr( "error on STDIN");
 	}
-	for( i = 0; i < state; ++i ){
-		putchar( stop[i] );
+	if( state ){
+		out_str( stop, state );
 	}
 	if( lines > 0 ){
 		++npages;
 	}
+	out_flush();
+	if( outerror ){
+		errno = outerror;
+		logerr( "error on STDOUT");
+	}
 	doaccnt();
 }
 
@@ -0,0 +1,440 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "child.h"
+#include "errorcodes.h"
+#include "getopt.h"
+#include "getprinter.h"
+#include "getqueue.h"
+#include "initialize.h"
+#include "linelist.h"
+#include "sendjob.h"
+#include "sendreq.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * LPD protocol load generator
+ *  Forks a number of workers that send a mix of job submissions,
+ *  status queries, job removals and lpc requests to the lpd server
+ *  for a printer, and reports the latency percentiles for each kind
+ *  of operation.
+ *
+ *  lpload [-P printer] [-c workers] [-n ops] [-t seconds] [-r ops/sec]
+ *     [-s jobsize] [-m op=weight,...]
+ *
+ *  The operations are submit (normal job transfer), block (block
+ *  format job transfer), lpq (long status), lpstat (short status,
+ *  the summary form of the status request), lprm and lpc (lpc status).
+ *  With -r the workers start operations on a fixed schedule and the
+ *  latency is measured from the time the operation was due, so a slow
+ *  server is not hidden by the workers falling behind.
+ *
+ *  Use lpsink as the printer (lp=host%port) to measure the throughput
+ *  of lpd from job reception to printing without a real printer.
+ */
+
+#define OP_SUBMIT 0
+#define OP_BLOCK  1
+#define OP_LPQ    2
+#define OP_LPSTAT 3
+#define OP_LPRM   4
+#define OP_LPC    5
+
+static struct load_op {
+	const char *name;
+	int weight;
+	int count, errors, max;
+	double *usec;
+} Ops[] = {
+	{ "submit", 50, 0,0,0,0 },
+	{ "block", 10, 0,0,0,0 },
+	{ "lpq", 20, 0,0,0,0 },
+	{ "lpstat", 5, 0,0,0,0 },
+	{ "lprm", 10, 0,0,0,0 },
+	{ "lpc", 5, 0,0,0,0 },
+	{ 0, 0, 0,0,0,0 }
+};
+
+static int Workers = 4;
+static int Op_count = 100;
+static int Duration;
+static int Rate;
+static int Job_size = 4096;
+static char *Data_file;
+static int Null_fd = -1;
+
+static void usage(void)
+{
+	FPRINTF( STDERR,
+"usage: %s [-P printer] [-c workers] [-n ops] [-t seconds] [-r rate]\n"
+"    [-s jobsize] [-m op=weight,...]\n"
+"  -c workers  concurrent connections (default %d)\n"
+"  -n ops      total operations, 0 for no limit (default %d)\n"
+"  -t seconds  stop after this time\n"
+"  -r rate     target operations per second for all workers\n"
+"  -s jobsize  bytes in each submitted job (default %d)\n"
+"  -m mix      operation weights, default\n"
+"      submit=50,block=10,lpq=20,lpstat=5,lprm=10,lpc=5\n",
+		Name, Workers, Op_count, Job_size );
+	exit(1);
+}
+
+static void Set_mix( char *mix )
+{
+	struct line_list l;
+	struct load_op *op;
+	char *s;
+	int i, total = 0;
+
+	Init_line_list( &l );
+	for( op = Ops; op->name; ++op ) op->weight = 0;
+	Split( &l, mix, File_sep, 0,0,0,1,0,0 );
+	for( i = 0; i < l.count; ++i ){
+		if( !(s = safestrchr( l.list[i], '=' )) ) usage();
+		*s++ = 0;
+		for( op = Ops; op->name && safestrcasecmp( op->name, l.list[i] ); ++op );
+		if( !op->name ){
+			FPRINTF( STDERR, "%s: unknown operation '%s'\n", Name, l.list[i] );
+			usage();
+		}
+		if( (op->weight = atoi( s )) < 0 ){
+			FPRINTF( STDERR, "%s: negative weight for '%s'\n", Name, l.list[i] );
+			usage();
+		}
+		total += op->weight;
+	}
+	Free_line_list( &l );
+	if( total <= 0 ){
+		FPRINTF( STDERR, "%s: the mix '%s' has no operations\n", Name, mix );
+		usage();
+	}
+}
+
+static void Get_parms(int argc, char *argv[] )
+{
+	int option;
+
+	while( (option = Getopt( argc, argv, "c:D:m:n:P:r:s:t:" )) != EOF ){
+		switch( option ){
+		case 'c': Workers = atoi( Optarg ); break;
+		case 'D': Parse_debug( Optarg, 1 ); break;
+		case 'm': Set_mix( Optarg ); break;
+		case 'n': Op_count = atoi( Optarg ); break;
+		case 'P': Set_DYN( &Printer_DYN, Optarg ); break;
+		case 'r': Rate = atoi( Optarg ); break;
+		case 's': Job_size = atoi( Optarg ); break;
+		case 't': Duration = atoi( Optarg ); break;
+		default: usage(); break;
+		}
+	}
+	if( Optind != argc || Workers <= 0 || Op_count < 0 || Duration < 0
+		|| Rate < 0 || Job_size <= 0 || (Op_count == 0 && Duration == 0) ){
+		usage();
+	}
+}
+
+static double Now_usec( void )
+{
+	struct timeval tv;
+
+	if( gettimeofday( &tv, 0 ) ){
+		logerr_die(LOG_ERR, "Now_usec: gettimeofday failed");
+	}
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+/*
+ * Make_data_file - the data file sent with every job
+ */
+
+static void Make_data_file( void )
+{
+	char line[SMALLBUFFER], *tempfile;
+	int fd, len, n;
+
+	fd = Make_temp_fd( &tempfile );
+	Data_file = safestrdup( tempfile,__FILE__,__LINE__ );
+	for( len = n = 0; len < Job_size; len += n ){
+		plp_snprintf( line, sizeof(line),
+			"lpload test page line %d .........................................\n", len );
+		n = safestrlen( line );
+		if( n > Job_size - len ) n = Job_size - len;
+		if( write( fd, line, n ) != n ){
+			logerr_die(LOG_ERR, "Make_data_file: write '%s' failed", Data_file );
+		}
+	}
+	close( fd );
+}
+
+/*
+ * Do_submit - build a job the way lpr does and send it
+ */
+
+static int Do_submit( int block, int number )
+{
+	struct job job;
+	struct line_list *lp;
+	char jobname[SMALLBUFFER];
+	int status;
+
+	Init_job( &job );
+	plp_snprintf( jobname, sizeof(jobname), "lpload-%d-%d", (int)getpid(), number );
+	Set_str_value( &job.info, PRIORITY, "A" );
+	Set_str_value( &job.info, CLASS, "A" );
+	Set_str_value( &job.info, JOBNAME, jobname );
+	Set_str_value( &job.info, FORMAT, "f" );
+	Set_flag_value( &job.info, COPIES, 1 );
+	Set_str_value( &job.info, FROMHOST, FQDNHost_FQDN );
+	Set_str_value( &job.info, FILE_HOSTNAME, FQDNHost_FQDN );
+	Set_decimal_value( &job.info, NUMBER, number );
+	Set_str_value( &job.info, "C", "A" );
+	Set_str_value( &job.info, "H", FQDNHost_FQDN );
+	Set_str_value( &job.info, "J", jobname );
+	Set_str_value( &job.info, "L", Logname_DYN );
+	Set_str_value( &job.info, "P", Logname_DYN );
+
+	lp = malloc_or_die( sizeof(lp[0]),__FILE__,__LINE__ );
+	memset( lp, 0, sizeof(lp[0]) );
+	Check_max( &job.datafiles, 1 );
+	job.datafiles.list[job.datafiles.count++] = (void *)lp;
+	Set_str_value( lp, OPENNAME, Data_file );
+	Set_str_value( lp, DFTRANSFERNAME, Data_file );
+	Set_str_value( lp, "N", jobname );
+	Set_str_value( lp, FORMAT, "f" );
+	Set_flag_value( lp, COPIES, 1 );
+	Set_double_value( lp, SIZE, (double)Job_size );
+
+	Fix_control( &job, 0, 0, 1 );
+	Send_block_format_DYN = block;
+	status = Send_job( &job, &job, Connect_timeout_DYN, Connect_interval_DYN,
+		Max_connect_interval_DYN, Send_job_rw_timeout_DYN, 0 );
+	Send_block_format_DYN = 0;
+	Free_job( &job );
+	return( status );
+}
+
+/*
+ * Do_request - send a status or control request and read the reply
+ */
+
+static int Do_request( int class, int format, char **options )
+{
+	char msg[LARGEBUFFER];
+	int fd, n;
+
+	fd = Send_request( class, format, options, Connect_timeout_DYN,
+		Send_query_rw_timeout_DYN, Null_fd );
+	if( fd < 0 ) return( LINK_OPEN_FAIL );
+	shutdown( fd, 1 );
+	while( (n = Read_fd_len_timeout( Send_query_rw_timeout_DYN,
+		fd, msg, sizeof(msg) )) > 0 );
+	close( fd );
+	return( n < 0 ? LINK_TRANSFER_FAIL : 0 );
+}
+
+static int Do_op( int op, int number, int last_number )
+{
+	char jobnum[32];
+	char *options[4];
+
+	switch( op ){
+	case OP_SUBMIT: return( Do_submit( 0, number ) );
+	case OP_BLOCK: return( Do_submit( 1, number ) );
+	case OP_LPQ: return( Do_request( 'Q', REQ_DLONG, 0 ) );
+	case OP_LPSTAT: return( Do_request( 'Q', REQ_DSHORT, 0 ) );
+	case OP_LPRM:
+		/* remove the last job this worker sent, if any */
+		plp_snprintf( jobnum, sizeof(jobnum), "%d", last_number );
+		options[0] = Logname_DYN;
+		options[1] = last_number ? jobnum : 0;
+		options[2] = 0;
+		return( Do_request( 'M', REQ_REMOVE, options ) );
+	case OP_LPC:
+		options[0] = Logname_DYN;
+		options[1] = "status";
+		options[2] = RemotePrinter_DYN;
+		options[3] = 0;
+		return( Do_request( 'C', REQ_CONTROL, options ) );
+	}
+	return( JABORT );
+}
+
+static int Pick_op( int total_weight )
+{
+	int op, n;
+
+	n = random() % total_weight;
+	for( op = 0; n >= Ops[op].weight; ++op ){
+		n -= Ops[op].weight;
+	}
+	return( op );
+}
+
+/*
+ * Worker - run this worker's share of the operations and write
+ *  'op status usec' lines to fd
+ */
+
+static void Worker( int worker, int fd )
+{
+	char line[SMALLBUFFER];
+	double start, due, interval, wait, t;
+	int seq, count, op, status, total_weight, number, last_number = 0;
+
+	total_weight = 0;
+	for( op = 0; Ops[op].name; ++op ) total_weight += Ops[op].weight;
+	srandom( (unsigned)(getpid() ^ time( (void *)0 )) );
+
+	count = Op_count / Workers + (worker < Op_count % Workers);
+	interval = Rate ? 1000000.0 * Workers / Rate : 0;
+	start = Now_usec();
+	for( seq = 0; Op_count == 0 || seq < count; ++seq ){
+		t = Now_usec();
+		if( Duration && t - start >= Duration * 1000000.0 ) break;
+		due = t;
+		if( interval ){
+			due = start + seq * interval;
+			if( (wait = due - t) > 0 ) plp_usleep( (int)wait );
+		}
+		op = Pick_op( total_weight );
+		/* job numbers are unique per worker, lpd resolves collisions */
+		number = (worker * 100003 + seq) % 1000000;
+		status = Do_op( op, number, last_number );
+		if( (op == OP_SUBMIT || op == OP_BLOCK) && status == 0 ){
+			last_number = number;
+		}
+		Free_line_list( &Status_lines );
+		plp_snprintf( line, sizeof(line), "%d %d %.0f\n",
+			op, status, Now_usec() - due );
+		if( Write_fd_str( fd, line ) < 0 ) break;
+	}
+	close( fd );
+	exit( 0 );
+}
+
+static void Record( char *line )
+{
+	struct load_op *o;
+	int op, status;
+	double usec;
+
+	if( sscanf( line, "%d %d %lf", &op, &status, &usec ) != 3
+		|| op < 0 || op > OP_LPC ) return;
+	o = &Ops[op];
+	if( status ){
+		++o->errors;
+		return;
+	}
+	if( o->count >= o->max ){
+		o->max = 2 * o->max + 64;
+		o->usec = realloc_or_die( o->usec, o->max * sizeof(o->usec[0]),__FILE__,__LINE__ );
+	}
+	o->usec[o->count++] = usec;
+}
+
+static int cmp_usec( const void *l, const void *r )
+{
+	double a = *(const double *)l, b = *(const double *)r;
+	return( (a > b) - (a < b) );
+}
+
+static double Percentile( struct load_op *o, int p )
+{
+	int i;
+
+	if( o->count == 0 ) return( 0 );
+	i = (o->count * p + 99) / 100 - 1;
+	if( i < 0 ) i = 0;
+	return( o->usec[i] / 1000.0 );
+}
+
+static void Report( double elapsed )
+{
+	struct load_op *o;
+	int total = 0, errors = 0;
+
+	for( o = Ops; o->name; ++o ){
+		total += o->count;
+		errors += o->errors;
+		if( o->count + o->errors == 0 ) continue;
+		qsort( o->usec, o->count, sizeof(o->usec[0]), cmp_usec );
+		FPRINTF( STDOUT,
+			"op=%s count=%d errors=%d p50_ms=%.2f p90_ms=%.2f p99_ms=%.2f max_ms=%.2f ops_per_sec=%.2f\n",
+			o->name, o->count, o->errors, Percentile( o, 50 ), Percentile( o, 90 ),
+			Percentile( o, 99 ), Percentile( o, 100 ), o->count / elapsed );
+	}
+	FPRINTF( STDOUT,
+		"op=all count=%d errors=%d workers=%d seconds=%.2f ops_per_sec=%.2f\n",
+		total, errors, Workers, elapsed, total / elapsed );
+}
+
+int main(int argc, char *argv[], char *envp[])
+{
+	char buffer[LARGEBUFFER], *s, *end;
+	plp_status_t status;
+	double start, elapsed;
+	int fds[2], i, n, len;
+	pid_t pid;
+
+	(void) signal (SIGPIPE, SIG_IGN);
+	(void) signal (SIGCHLD, SIG_DFL);
+	(void) plp_signal (SIGINT, cleanup_INT);
+	(void) plp_signal (SIGTERM, cleanup_TERM);
+
+	/* status messages from Send_job() go to Status_lines, as for lpr */
+	Is_lpr = 1;
+	Initialize( argc, argv, envp, 'D' );
+	Setup_configuration();
+	Get_parms( argc, argv );
+	Get_printer();
+	Fix_Rm_Rp_info( 0, 0 );
+
+	if( (Null_fd = open( "/dev/null", O_WRONLY )) < 0 ){
+		logerr_die(LOG_ERR, "lpload: cannot open /dev/null" );
+	}
+	Make_data_file();
+	if( pipe( fds ) < 0 ){
+		logerr_die(LOG_ERR, "lpload: pipe failed" );
+	}
+
+	start = Now_usec();
+	for( i = 0; i < Workers; ++i ){
+		if( (pid = dofork( 0 )) < 0 ){
+			logerr_die(LOG_ERR, "lpload: fork failed" );
+		} else if( pid == 0 ){
+			/* the data file belongs to the parent */
+			Clear_tempfile_list();
+			close( fds[0] );
+			Worker( i, fds[1] );
+		}
+	}
+	close( fds[1] );
+
+	len = 0;
+	while( (n = ok_read( fds[0], buffer+len, sizeof(buffer)-1-len )) > 0 ){
+		len += n;
+		buffer[len] = 0;
+		for( s = buffer; (end = safestrchr( s, '\n' )); s = end+1 ){
+			*end = 0;
+			Record( s );
+		}
+		len = safestrlen( s );
+		memmove( buffer, s, len+1 );
+	}
+	close( fds[0] );
+	while( plp_waitpid( -1, &status, 0 ) > 0 );
+	elapsed = (Now_usec() - start) / 1000000.0;
+	if( elapsed <= 0 ) elapsed = 1;
+
+	Report( elapsed );
+	Errorcode = 0;
+	cleanup( 0 );
+	return( 0 );
+}
@@ -198,7 +198,9 @@ int main(int argc, char *argv[], char *envp[])
 			DEBUG1("lpq: all printers");
 			Get_all_printcap_entries();
 			if(DEBUGL1)Dump_line_list("lpq- All_line_list", &All_line_list );
-			for( i = 0; i < All_line_list.count; ++i ){
+			if( Displayformat == REQ_DSHORT && argv[Optind] == 0 ){
+				Show_all_short(argv);
+			} else for( i = 0; i < All_line_list.count; ++i ){
 				Set_DYN(&Printer_DYN,All_line_list.list[i] );
 				Show_status(argv);
 			}
@@ -280,6 +282,86 @@ static void Show_status(char **argv)
 }
 
 
+/***************************************************************************
+ * Show_all_short - lpq -a -s
+ *  Rather than a connection for each printer,  we ask each server
+ *  for the short status of all of its queues,  and pick out the lines
+ *  for the printers we have.  The printers are grouped by the server
+ *  host,  port,  and the authentication and socket used to reach it.
+ *  Printers that are not in the reply get the usual Show_status();
+ *  if we could not connect to the server we do not try again.
+ ***************************************************************************/
+
+static void Show_all_short(char **argv)
+{
+	int i, fd;
+	char key[SMALLBUFFER], name[SMALLBUFFER], *rp, *s, *t;
+	struct line_list servers, status, reply;
+
+	Init_line_list(&servers);
+	Init_line_list(&status);
+	Init_line_list(&reply);
+
+	for( i = 0; i < All_line_list.count; ++i ){
+		Set_DYN(&Printer_DYN,All_line_list.list[i] );
+		Fix_Rm_Rp_info(0,0);
+		if( ISNULL(RemotePrinter_DYN) || ISNULL(RemoteHost_DYN)
+			|| (Direct_DYN && Lp_device_DYN)
+			|| Check_for_rg_group( Logname_DYN ) ){
+			Show_status(argv);
+			continue;
+		}
+		if( Auth ){
+			Set_DYN(&Auth_DYN, getenv("AUTH") );
+		}
+		plp_snprintf( key, sizeof(key), "%s%%%s%%%s%%%s",
+			RemoteHost_DYN, Lpd_port_DYN, Auth_DYN, Unix_socket_path_DYN );
+		/* the keys cannot have the line list separators in them */
+		for( t = key; (t = safestrpbrk( t, Option_value_sep )); ) *t = '_';
+		if( !Find_exists_value( &servers, key, Hash_value_sep ) ){
+			rp = safestrdup(RemotePrinter_DYN,__FILE__,__LINE__);
+			Set_DYN(&RemotePrinter_DYN, ALL );
+			fd = Send_request( 'Q', REQ_DSHORT, 0, Connect_timeout_DYN,
+				Send_query_rw_timeout_DYN, 1 );
+			Set_DYN(&RemotePrinter_DYN, rp );
+			free(rp); rp = 0;
+			Set_flag_value( &servers, key, fd >= 0 );
+			if( fd >= 0 ){
+				Read_fd_and_split( &reply, fd, Line_ends, 0, 0, 0, 0, 0 );
+				close(fd); fd = -1;
+				for( fd = 0; fd < reply.count; ++fd ){
+					s = reply.list[fd];
+					if( (t = safestrchr( s, '@' )) == 0 ) continue;
+					*t = 0;
+					plp_snprintf( name, sizeof(name), "%s%%%s", s, key );
+					*t = '@';
+					if( !Find_exists_value( &status, name, Hash_value_sep ) ){
+						Set_str_value( &status, name, s );
+					}
+				}
+				fd = -1;
+				Free_line_list(&reply);
+			}
+		}
+		plp_snprintf( name, sizeof(name), "%s%%%s", RemotePrinter_DYN, key );
+		if( (s = Find_str_value( &status, name )) ){
+			if( !Find_exists_value(&Printer_list,s,0) ){
+				if( Write_fd_str( 1, s ) < 0
+					|| Write_fd_str( 1, "\n" ) < 0 ) cleanup(0);
+				Add_line_list(&Printer_list,s,0,1,0);
+			}
+		} else if( Find_flag_value( &servers, key ) ){
+			Show_status(argv);
+		}
+	}
+	DEBUG1("Show_all_short: %d printers, %d servers",
+		All_line_list.count, servers.count );
+	Free_line_list(&reply);
+	Free_line_list(&status);
+	Free_line_list(&servers);
+}
+
+
 /***************************************************************************
  *int Read_status_info( int ack, int fd, int timeout );
  * ack = ack character from remote site
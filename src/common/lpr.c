@@ -135,6 +135,10 @@ int main(int argc, char *argv[], char *envp[])
 		Get_parms(newargs.count, newargs.list);      /* scan input args */
 		newargs.count = 0;
 	}
+	if( Batch_file_JOB ){
+		Errorcode = Lpr_batch();
+		cleanup(0);
+	}
 	job_size = Make_job(&prjob);
 
     if(DEBUGL3){
@@ -394,9 +398,9 @@ static void usage(void);
 
 
  char LPR_optstr[]    /* LPR options */
- = "1:2:3:4:#:ABC:D:F:GJ:K:NP:QR:T:U:VX:YZ:bcdfghi:klm:nprstvw:" ;
+ = "1:2:3:4:#:ABC:D:F:GJ:K:NP:QR:T:U:VX:YZ:bcdfghi:j:klm:nprstvw:" ;
  char LPR_bsd_optstr[]    /* LPR options */
- = "1:2:3:4:#:ABC:D:F:GJ:K:NP:QR:T:U:VX:YZ:bcdfghi:klmnprstvw:" ;
+ = "1:2:3:4:#:ABC:D:F:GJ:K:NP:QR:T:U:VX:YZ:bcdfghi:j:klmnprstvw:" ;
  char LP_optstr[]    /* LP options */
  = 	"ckmprswd:BD:f:GH:n:o:P:q:S:t:T:X:Yy:";
 
@@ -593,6 +597,9 @@ void Get_parms(int argc, char *argv[] )
 		case 'i':
 		    Check_int_dup( option, &Indent_JOB, Optarg, 0);
 		    break;
+		case 'j':
+		    Check_str_dup( option, &Batch_file_JOB, Optarg);
+		    break;
 		case 'm':
 		    /*
 		     * -m Mailname
@@ -701,7 +708,8 @@ _("Usage: %s [-A] [-B] [-c] [-G] [-m] [-p] [-s] [-w] [-d printer@[host]]\n"
 		FPRINTF( STDERR,
 _("Usage: %s [-Pprinter[@host]] [-A] [-B] [-Cclass] [-Fformat] [-G] [-Jinfo]\n"
 "   [-(K|#)copies] [-Q] [-Raccountname]  [-Ttitle]  [-Uuser[@host]] [-V]\n"
-"   [-Zoptions] [-b] [-m mailaddr] [-h] [-i indent] [-l] [-w width ] [-r]\n"
+"   [-Zoptions] [-b] [-m mailaddr] [-h] [-i indent] [-j manifest] [-l]\n"
+"   [-w width ] [-r]\n"
 "   [-Ddebugopt ] [--] [ filenames ...  ]\n"
 " -A          - use authentication specified by AUTH environment variable\n"
 " -B          - filter files and reduce job to single file before sending\n"
@@ -724,6 +732,7 @@ _("Usage: %s [-Pprinter[@host]] [-A] [-B] [-Cclass] [-Fformat] [-G] [-Jinfo]\n"
 " -Z options  - options to pass to filter\n"
 " -h          - no header or banner page\n"
 " -i indent   - indentation\n"
+" -j manifest - send each line of manifest as a job,  '-' reads STDIN\n"
 " -k          - do not use tempfile when sending to server\n"
 " -m mailaddr - mail final status to mailaddr\n"
 " -r          - remove files after spooling\n"
@@ -756,8 +765,49 @@ _("Usage: %s [-Pprinter[@host]] [-A] [-B] [-Cclass] [-Fformat] [-G] [-Jinfo]\n"
 
 static void get_job_number( struct job *job );
 static double Copy_STDIN( struct job *job );
+static int Batch_number;	/* jobs made up by lpr -j */
 static double Check_files( struct job *job );
 
+/***************************************************************************
+ * int Allowed_user_setting()
+ *  check to see if you were root or are in allow_user_setting,  so
+ *  you can use the -U option
+ ***************************************************************************/
+
+static int Allowed_user_setting( void )
+{
+	struct line_list user_list;
+	char *str, *t;
+	struct passwd *pw;
+	int found, i;
+	uid_t uid;
+
+	if( 0 == OriginalRUID ) return( 1 );
+	DEBUG2("Allowed_user_setting: checking '%s' for -U perms",
+		Allow_user_setting_DYN );
+	Init_line_list(&user_list);
+	Split( &user_list, Allow_user_setting_DYN,File_sep,0,0,0,0,0,0);
+
+	found = 0;
+	for( i = 0; !found && i < user_list.count; ++i ){
+		str = user_list.list[i];
+		DEBUG2("Allowed_user_setting: checking '%s'", str );
+		uid = strtol( str, &t, 10 );
+		if( str == t || *t ){
+			/* try getpasswd */
+			pw = getpwnam( str );
+			if( pw ){
+				uid = pw->pw_uid;
+			}
+		}
+		DEBUG2( "Allowed_user_setting: uid '%ld'", (long)uid );
+		found = ( uid == OriginalRUID );
+		DEBUG2( "Allowed_user_setting: found '%d'", found );
+	}
+	Free_line_list(&user_list);
+	return( found );
+}
+
 /***************************************************************************
  * Commentary:
  * The struct control_file{}  data structure contains fields that point to
@@ -847,41 +897,9 @@ static int Make_job( struct job *job )
 	 * else set to log name of user
      * if No_header suppress banner
 	 */
-	if( Username_JOB ){
-		/* check to see if you were root */
-		if( 0 != OriginalRUID ){
-			struct line_list user_list;
-			char *str, *t;
-			struct passwd *pw;
-			int found;
-			uid_t uid;
-
-			DEBUG2("Make_job: checking '%s' for -U perms",
-				Allow_user_setting_DYN );
-			Init_line_list(&user_list);
-			Split( &user_list, Allow_user_setting_DYN,File_sep,0,0,0,0,0,0);
-			
-			found = 0;
-			for( i = 0; !found && i < user_list.count; ++i ){
-				str = user_list.list[i];
-				DEBUG2("Make_job: checking '%s'", str );
-				uid = strtol( str, &t, 10 );
-				if( str == t || *t ){
-					/* try getpasswd */
-					pw = getpwnam( str );
-					if( pw ){
-						uid = pw->pw_uid;
-					}
-				}
-				DEBUG2( "Make_job: uid '%ld'", (long)uid );
-				found = ( uid == OriginalRUID );
-				DEBUG2( "Make_job: found '%d'", found );
-			}
-			if( !found ){
-				DEBUG1( _("-U (username) can only be used by ROOT") );
-				Username_JOB = 0;
-			}
-		}
+	if( Username_JOB && !Allowed_user_setting() ){
+		DEBUG1( _("-U (username) can only be used by ROOT") );
+		Username_JOB = 0;
 	}
 	if( Username_JOB ){
 		Clean_meta(Username_JOB);
@@ -1051,7 +1069,7 @@ static int Make_job( struct job *job )
 static void get_job_number( struct job *job )
 {
 	int number = Job_number;
-	if( number == 0 ) number = getpid();
+	if( number == 0 ) number = getpid() + Batch_number;
 	Fix_job_number( job, number );
 }
 
@@ -1199,6 +1217,312 @@ static double Check_files( struct job *job )
 	return( size );
 }
 
+/***************************************************************************
+ * int Lpr_batch()
+ *  lpr -j manifest - each line of the manifest is a job,  with options
+ *  and files as on the command line:
+ *     [-J jobname] [-C class] [-U user] [-# copies] ... file [file ...]
+ *  The options on the command line are the defaults for each line.
+ *  Blank lines and lines starting with '#' are ignored.
+ *
+ *  The jobs are all made up before any of them are sent,  and are then
+ *  sent over a single connection by Send_batch().  A line with the result
+ *  of each job is written to STDOUT.
+ *  RETURNS: 0 if all the jobs were queued, 1 if not
+ ***************************************************************************/
+
+ static char LPR_batch_optstr[]    /* options in a manifest line */
+ = "#:C:F:J:K:R:T:U:Z:bcdfghi:lm:nptvw:" ;
+
+ static char **Batch_str_vars[] = {
+	&Accntname_JOB, &Classname_JOB, &Jobname_JOB, &Mailname_JOB,
+	&Prtitle_JOB, &Username_JOB, &Zopts_JOB, 0 };
+ static int *Batch_int_vars[] = {
+	&Binary_JOB, &Copies_JOB, &Format_JOB, &Indent_JOB,
+	&No_header_JOB, &Priority_JOB, &Pwidth_JOB, 0 };
+
+/*
+ * set the job options from a manifest line
+ *  returns 0,  or -1 with the reason in error
+ */
+
+static int Lpr_batch_line( struct line_list *args, struct line_list *keep,
+	char *error, int errlen )
+{
+	int option, i, n;
+	char *s;
+
+	Getopt(0,0,0);
+	while( (option = Getopt( args->count, args->list, LPR_batch_optstr )) != EOF ){
+		switch( option ){
+		case 'C': Classname_JOB = Optarg; break;
+		case 'J': Jobname_JOB = Optarg; break;
+		case 'R': Accntname_JOB = Optarg; break;
+		case 'T': Prtitle_JOB = Optarg; break;
+		case 'U': Username_JOB = Optarg; break;
+		case 'm': Mailname_JOB = Optarg; break;
+		case 'Z':
+			if( Zopts_JOB ){
+				s = safestrdup3(Zopts_JOB,",",Optarg,__FILE__,__LINE__);
+				Zopts_JOB = Add_line_list( keep, s, 0, 0, 0 );
+				free(s);
+			} else {
+				Zopts_JOB = Optarg;
+			}
+			break;
+		case 'F':
+			if( safestrlen(Optarg) != 1 ){
+				plp_snprintf( error, errlen, _("bad -F format string '%s'"), Optarg );
+				return( -1 );
+			}
+			Format_JOB = *Optarg;
+			break;
+		case 'b': case 'l': Binary_JOB = 1; break;
+		case 'h': No_header_JOB = 1; break;
+		case 'c': case 'd': case 'f': case 'g':
+		case 'n': case 'p': case 't': case 'v':
+			Format_JOB = option;
+			break;
+		case '#': case 'K': case 'i': case 'w':
+			n = strtol( Optarg, &s, 10 );
+			if( n < 0 || s == Optarg || *s
+				|| (n == 0 && (option == '#' || option == 'K')) ){
+				plp_snprintf( error, errlen,
+					_("option %c parameter `%s` is not positive integer value"),
+					option, Optarg );
+				return( -1 );
+			}
+			if( option == 'i' ) Indent_JOB = n;
+			else if( option == 'w' ) Pwidth_JOB = n;
+			else Copies_JOB = n;
+			break;
+		default:
+			plp_snprintf( error, errlen, _("bad option") );
+			return( -1 );
+		}
+	}
+	/* the checks that Make_job() would die on */
+	n = Binary_JOB ? 'l' : Format_JOB;
+	if( isupper(n) ) n = tolower(n);
+	if( n && (safestrchr( "aios", n )
+		|| (Formats_allowed_DYN && !safestrchr( Formats_allowed_DYN, n ))) ){
+		plp_snprintf( error, errlen, _("Bad format specification '%c'"), n );
+		return( -1 );
+	}
+	if( Max_copies_DYN && Copies_JOB > Max_copies_DYN ){
+		plp_snprintf( error, errlen, _("Maximum of %d copies allowed"), Max_copies_DYN );
+		return( -1 );
+	}
+	if( Priority_JOB == 0 && Classname_JOB && !Break_classname_priority_link_DYN
+		&& !isalpha( cval(Classname_JOB) ) ){
+		plp_snprintf( error, errlen,
+			_("Priority (first letter of Class) not 'A' (lowest) to 'Z' (highest)") );
+		return( -1 );
+	}
+	/* Make_job() dies if the -U user@host host is not found */
+	if( Username_JOB && (s = strchr( Username_JOB, '@' ))
+		&& Allowed_user_setting() ){
+		char *host = safestrdup( s+1,__FILE__,__LINE__);
+		Clean_meta( host );
+		for( s = host; cval(s); ++s ){
+			if( isspace(cval(s)) ) *s = '_';
+		}
+		if( Find_fqdn( &LookupHost_IP, host ) == 0 ){
+			plp_snprintf( error, errlen,
+				_("-U host '%s' FQDN name not found"), host );
+			free( host );
+			return( -1 );
+		}
+		free( host );
+	}
+	for( i = Optind; i < args->count; ++i ){
+		if( !safestrcmp( args->list[i], "-" ) ){
+			plp_snprintf( error, errlen, _("cannot read STDIN in a batch") );
+			return( -1 );
+		}
+		Add_line_list(&Files,args->list[i],0,0,0);
+	}
+	if( Files.count == 0 ){
+		plp_snprintf( error, errlen, _("no files") );
+		return( -1 );
+	}
+	return( 0 );
+}
+
+static int Lpr_batch( void )
+{
+	struct line_list args, keep, defaults;
+	struct job **jobs = 0, **send = 0, *job;
+	struct stat statb;
+	int defaults_int[sizeof(Batch_int_vars)/sizeof(Batch_int_vars[0])];
+	char *defaults_str[sizeof(Batch_str_vars)/sizeof(Batch_str_vars[0])];
+	int *lines = 0;
+	char error[SMALLBUFFER], msg[LARGEBUFFER];
+	char *image = 0, *logname, *s, *t, *id;
+	int fd, len = 0, max = 0, count = 0, sendcount = 0, failed = 0, line = 0;
+	int i, j, n;
+
+	if( Files.count ){
+		DIEMSG( _("files on command line conflict with -j option") );
+	}
+	if( Direct_JOB || Direct_DYN || Lpr_bounce_JOB || Lpr_bounce_DYN
+		|| User_filter_JOB || Lpr_zero_file_JOB ){
+		DIEMSG( _("-j cannot be used with -B, -k, -X, -Y or direct or bounce queues") );
+	}
+	if( Check_for_rg_group( Logname_DYN ) ){
+		Errorcode = 1;
+		fatal(LOG_INFO, _("cannot use printer - not in privileged group\n") );
+	}
+	if( Remote_support_DYN ) uppercase( Remote_support_DYN );
+	if( safestrchr( Remote_support_DYN, 'R' ) == 0 ){
+		Errorcode = 1;
+		fatal(LOG_INFO, _("no remote support for %s@%s"),
+			RemotePrinter_DYN,RemoteHost_DYN );
+	}
+
+	/* read the manifest */
+	if( !strcmp( Batch_file_JOB, "-" ) ){
+		fd = 0;
+	} else if( (fd = Checkread( Batch_file_JOB, &statb )) < 0 ){
+		DIEMSG( _("Cannot open file '%s', %s"), Batch_file_JOB, Errormsg( errno ) );
+	}
+	Init_buf( &image, &max, &len );
+	while( (n = ok_read( fd, msg, sizeof(msg) )) > 0 ){
+		Put_buf_len( msg, n, &image, &max, &len );
+	}
+	if( fd > 0 ) close( fd );
+
+	/* the command line values are the defaults for each job */
+	Init_line_list(&args);
+	Init_line_list(&keep);
+	Init_line_list(&defaults);
+	for( i = 0; Batch_str_vars[i]; ++i ){
+		defaults_str[i] = *Batch_str_vars[i];
+		Add_line_list( &defaults, *Batch_str_vars[i], 0, 0, 0 );
+	}
+	for( i = 0; Batch_int_vars[i]; ++i ){
+		defaults_int[i] = *Batch_int_vars[i];
+	}
+	logname = safestrdup( Logname_DYN,__FILE__,__LINE__);
+
+	for( s = image; s; s = t ){
+		if( (t = strchr( s, '\n' )) ) *t++ = 0;
+		++line;
+		while( isspace(cval(s)) ) ++s;
+		if( cval(s) == 0 || cval(s) == '#' ) continue;
+
+		for( i = 0; Batch_str_vars[i]; ++i ){
+			*Batch_str_vars[i] = 0;
+			if( !ISNULL( defaults.list[i] ) ){
+				*Batch_str_vars[i] = Add_line_list( &keep, defaults.list[i], 0, 0, 0 );
+			}
+		}
+		for( i = 0; Batch_int_vars[i]; ++i ){
+			*Batch_int_vars[i] = defaults_int[i];
+		}
+		Set_DYN(&Logname_DYN, logname );
+		Free_line_list(&Files);
+		Add_line_list( &args, "-j", 0, 0, 0 );
+		Split_cmd_line( &args, s );
+		Check_max( &args, 1 );
+		args.list[args.count] = 0;
+
+		if( (count % 64) == 0 ){
+			jobs = realloc_or_die( jobs, (count+64)*sizeof(jobs[0]),__FILE__,__LINE__);
+			lines = realloc_or_die( lines, (count+64)*sizeof(lines[0]),__FILE__,__LINE__);
+		}
+		job = malloc_or_die( sizeof(job[0]),__FILE__,__LINE__);
+		memset( job, 0, sizeof(job[0]) );
+		jobs[count] = job;
+		lines[count] = line;
+		++count;
+
+		error[0] = 0;
+		if( Lpr_batch_line( &args, &keep, error, sizeof(error) ) == 0 ){
+			++Batch_number;
+			if( Make_job( job ) == 0 ){
+				plp_snprintf( error, sizeof(error), _("nothing to print") );
+			} else if( Max_datafiles_DYN > 0
+				&& job->datafiles.count > Max_datafiles_DYN ){
+				plp_snprintf( error, sizeof(error),
+					_("%d data files and maximum allowed %d"),
+					job->datafiles.count, Max_datafiles_DYN );
+			} else {
+				Fix_control( job, Control_filter_DYN, 0, 1 );
+			}
+		}
+		if( error[0] ) Set_str_value(&job->info,ERROR,error);
+		Free_line_list(&args);
+		Free_line_list(&keep);
+	}
+	Free_line_list(&Files);
+	Set_DYN(&Logname_DYN, logname );
+	if( logname ) free( logname ); logname = 0;
+	/* the job values pointed into args and keep */
+	for( i = 0; Batch_str_vars[i]; ++i ){
+		*Batch_str_vars[i] = defaults_str[i];
+	}
+	for( i = 0; Batch_int_vars[i]; ++i ){
+		*Batch_int_vars[i] = defaults_int[i];
+	}
+
+	/* send the jobs that we could make up */
+	send = malloc_or_die( (count+1)*sizeof(send[0]),__FILE__,__LINE__);
+	for( i = 0; i < count; ++i ){
+		if( !Find_str_value(&jobs[i]->info,ERROR) ) send[sendcount++] = jobs[i];
+	}
+	DEBUG1("Lpr_batch: %d lines, %d jobs to send", count, sendcount );
+	if( sendcount == 0 ){
+		;
+	} else if( Auth_DYN || Send_block_format_DYN ){
+		/* these need a connection for each job */
+		for( i = 0; i < sendcount; ++i ){
+			if( Send_job( send[i], send[i], Connect_timeout_DYN,
+				Connect_interval_DYN, Max_connect_interval_DYN,
+				Send_job_rw_timeout_DYN, 0 )
+				&& !Find_str_value(&send[i]->info,ERROR) ){
+				Set_str_value(&send[i]->info,ERROR,_("transfer failed"));
+			}
+		}
+	} else {
+		Send_batch( send, sendcount, Connect_timeout_DYN, Send_job_rw_timeout_DYN );
+	}
+
+	if( Removefiles_JOB ) To_user();
+	for( i = 0; i < count; ++i ){
+		job = jobs[i];
+		id = Find_str_value(&job->info,IDENTIFIER);
+		if( (s = Find_str_value(&job->info,ERROR)) ){
+			++failed;
+			if( id ){
+				plp_snprintf( msg, sizeof(msg), _("line %d: job '%s' not queued - %s\n"),
+					lines[i], id, s );
+			} else {
+				plp_snprintf( msg, sizeof(msg), _("line %d: not queued - %s\n"),
+					lines[i], s );
+			}
+		} else {
+			plp_snprintf( msg, sizeof(msg), _("line %d: job '%s' queued\n"),
+				lines[i], id );
+			for( j = 0; Removefiles_JOB && j < job->datafiles.count; ++j ){
+				s = Find_str_value((void *)job->datafiles.list[j],OPENNAME);
+				if( s && unlink( s ) == -1 ){
+					WARNMSG(_("Error unlinking '%s' - %s"), s, Errormsg( errno ) );
+				}
+			}
+		}
+		Write_fd_str( 1, msg );
+		Free_job( job );
+		free( job );
+	}
+	if( jobs ) free( jobs );
+	if( lines ) free( lines );
+	if( send ) free( send );
+	if( image ) free( image );
+	Free_line_list(&defaults);
+	return( failed != 0 );
+}
+
 /***************************************************************************
  * int Check_lpr_printable(char *file, int fd, struct stat *statb, int format )
  * 1. Check to make sure it is a regular file.
@@ -1212,7 +1536,7 @@ static int Check_lpr_printable(char *file, int fd, struct stat *statb, int forma
     char buf[LINEBUFFER];
     int n, i, c;                /* Acme Integers, Inc. */
     int printable = 0;
-	char *err = _("cannot print '%s': %s");
+	char *err = _("cannot print '%s': %s"), *why = 0;
 
 	if( Check_for_nonprintable_DYN == 0 ) return(1);
 	/*
@@ -1221,12 +1545,12 @@ static int Check_lpr_printable(char *file, int fd, struct stat *statb, int forma
 	 */
 	lseek( fd, 0, SEEK_SET );
     if(!S_ISREG( statb->st_mode )) {
-		DIEMSG(err, file,_("not a regular file"));
+		why = _("not a regular file");
     } else if(statb->st_size == 0) {
 		/* empty file */
 		printable = -1;
     } else if ((n = ok_read (fd, buf, sizeof(buf))) <= 0) {
-        DIEMSG (err, file,_("cannot read it"));
+        why = _("cannot read it");
     } else if (format != 'p' && format != 'f' ){
         printable = 1;
     } else {
@@ -1240,9 +1564,15 @@ static int Check_lpr_printable(char *file, int fd, struct stat *statb, int forma
 			if( !isprint( c ) && !isspace( c )
 				&& c != 0x08 && c != 0x1B && c!= 0x04 ) printable = 0;
 		}
-		if( !printable ) DIEMSG (err, file,
-			_("unprintable characters at start of file, check your LANG environment variable as well as the input file"));
+		if( !printable ) why =
+			_("unprintable characters at start of file, check your LANG environment variable as well as the input file");
     }
+	if( why ){
+		/* in a batch only this job is not printed */
+		if( !Batch_file_JOB ) DIEMSG (err, file, why);
+		WARNMSG (err, file, why);
+		printable = 0;
+	}
     return(printable);
 }
 
@@ -0,0 +1,128 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "child.h"
+#include "getopt.h"
+#include "initialize.h"
+#include "linelist.h"
+#include "linksupport.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Printer sink
+ *  Accepts connections on a TCP port the way a network printer does
+ *  (lp=host%port in the printcap), reads the job data at a given speed
+ *  and throws it away.  One line is printed for each connection:
+ *   sink conn=N bytes=N usec=N bytes_per_sec=N
+ *
+ *  lpsink [-p port] [-b bytes/sec] [-d delay]
+ *   -p port       port to listen on (default 9100)
+ *   -b bytes/sec  printing speed, 0 for no limit (default 0)
+ *   -d delay      milliseconds before reading, as a printer warming up
+ */
+
+static char *Port = "9100";
+static int Speed;
+static int Delay;
+
+static void usage(void)
+{
+	FPRINTF( STDERR, "usage: %s [-p port] [-b bytes/sec] [-d delay_ms]\n", Name );
+	exit(1);
+}
+
+static void Get_parms(int argc, char *argv[] )
+{
+	int option;
+
+	while( (option = Getopt( argc, argv, "b:D:d:p:" )) != EOF ){
+		switch( option ){
+		case 'b': Speed = atoi( Optarg ); break;
+		case 'D': Parse_debug( Optarg, 1 ); break;
+		case 'd': Delay = atoi( Optarg ); break;
+		case 'p': Port = Optarg; break;
+		default: usage(); break;
+		}
+	}
+	if( Optind != argc || Speed < 0 || Delay < 0 ){
+		usage();
+	}
+}
+
+static double Now_usec( void )
+{
+	struct timeval tv;
+
+	if( gettimeofday( &tv, 0 ) ){
+		logerr_die(LOG_ERR, "Now_usec: gettimeofday failed");
+	}
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+/*
+ * Sink - read the connection until EOF, sleeping to keep to Speed
+ */
+
+static void Sink( int sock, int conn )
+{
+	char buffer[LARGEBUFFER];
+	double start, total = 0, ahead;
+	int n;
+
+	start = Now_usec();
+	if( Delay ) plp_usleep( Delay * 1000 );
+	while( (n = ok_read( sock, buffer, sizeof(buffer) )) > 0 ){
+		total += n;
+		if( Speed ){
+			ahead = total * 1000000.0 / Speed - (Now_usec() - start);
+			if( ahead > 0 ) plp_usleep( (int)ahead );
+		}
+	}
+	close( sock );
+	start = Now_usec() - start;
+	FPRINTF( STDOUT, "sink conn=%d bytes=%.0f usec=%.0f bytes_per_sec=%.0f\n",
+		conn, total, start, start > 0 ? total * 1000000.0 / start : 0.0 );
+	exit( 0 );
+}
+
+int main(int argc, char *argv[], char *envp[])
+{
+	plp_status_t status;
+	int sock, fd, conn = 0;
+	pid_t pid;
+
+	(void) signal (SIGPIPE, SIG_IGN);
+	(void) signal (SIGCHLD, SIG_DFL);
+	(void) plp_signal (SIGINT, cleanup_INT);
+	(void) plp_signal (SIGTERM, cleanup_TERM);
+
+	Initialize( argc, argv, envp, 'D' );
+	Get_parms( argc, argv );
+
+	if( (sock = Link_listen( Port )) <= 0 ){
+		logerr_die(LOG_ERR, "lpsink: cannot listen on port '%s'", Port );
+	}
+	while( 1 ){
+		if( (fd = accept( sock, 0, 0 )) < 0 ){
+			if( errno == EINTR ) continue;
+			logerr_die(LOG_ERR, "lpsink: accept failed" );
+		}
+		++conn;
+		if( (pid = dofork( 0 )) < 0 ){
+			logerr(LOG_ERR, "lpsink: fork failed" );
+		} else if( pid == 0 ){
+			close( sock );
+			Sink( fd, conn );
+		}
+		close( fd );
+		while( plp_waitpid( -1, &status, WNOHANG ) > 0 );
+	}
+	return( 0 );
+}
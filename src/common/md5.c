@@ -43,27 +43,20 @@
 #endif
 #endif
 
-#ifdef LITTLE_ENDIAN_FOR_SURE
-#define byteReverse(buf, len)	/* Nothing */
-#else
-static void byteReverse(unsigned char *buf, unsigned longs);
-
 /*
- * Note: this code is harmless on little-endian machines.
+ * MD5 works on little-endian 32 bit words.  MD5Transform() takes the
+ * 64 byte block as bytes, so MD5Update() can hash whole blocks directly
+ * from the caller's buffer:  on a little-endian machine an aligned block
+ * is used in place, otherwise the words are assembled in a local array.
  */
-static void byteReverse(unsigned char *buf, unsigned longs)
-{
-	uint32_t t;
-	do {
-		t = (uint32_t) ((unsigned) buf[3] << 8 | buf[2]) << 16 |
-			((unsigned) buf[1] << 8 | buf[0]);
-		*(uint32_t *) buf = t;
-		buf += 4;
-	} while (--longs);
-}
-#endif
+#define GETWORD(p) \
+	((uint32_t) (p)[0] | (uint32_t) (p)[1] << 8 | \
+	 (uint32_t) (p)[2] << 16 | (uint32_t) (p)[3] << 24)
+#define PUTWORD(p, v) \
+	( (p)[0] = (unsigned char) (v), (p)[1] = (unsigned char) ((v) >> 8), \
+	  (p)[2] = (unsigned char) ((v) >> 16), (p)[3] = (unsigned char) ((v) >> 24) )
 
-static void MD5Transform(uint32_t buf[4], uint32_t const in[16]);
+static void MD5Transform(uint32_t buf[4], unsigned char const *block);
 
 /*
  * Start MD5 accumulation.  Set bit count to 0 and buffer to mysterious
@@ -108,17 +101,14 @@ void MD5Update(struct MD5Context *ctx, unsigned char const *buf, unsigned len)
 			return;
 		}
 		memcpy(p, buf, t);
-		byteReverse(ctx->in, 16);
-		MD5Transform(ctx->buf, (uint32_t *) ctx->in);
+		MD5Transform(ctx->buf, ctx->in);
 		buf += t;
 		len -= t;
 	}
-	/* Process data in 64-byte chunks */
+	/* Process data in 64-byte chunks, without copying them */
 
 	while (len >= 64) {
-		memcpy(ctx->in, buf, 64);
-		byteReverse(ctx->in, 16);
-		MD5Transform(ctx->buf, (uint32_t *) ctx->in);
+		MD5Transform(ctx->buf, buf);
 		buf += 64;
 		len -= 64;
 	}
@@ -152,8 +142,7 @@ void MD5Final(struct MD5Context *ctx, unsigned char* digest)
 	if (count < 8) {
 		/* Two lots of padding:  Pad the first block to 64 bytes */
 		memset(p, 0, count);
-		byteReverse(ctx->in, 16);
-		MD5Transform(ctx->buf, (uint32_t *) ctx->in);
+		MD5Transform(ctx->buf, ctx->in);
 
 		/* Now fill the next block with 56 bytes */
 		memset(ctx->in, 0, 56);
@@ -161,17 +150,19 @@ void MD5Final(struct MD5Context *ctx, unsigned char* digest)
 		/* Pad block to 56 bytes */
 		memset(p, 0, count - 8);
 	}
-	byteReverse(ctx->in, 14);
 
 	/* Append length in bits and transform */
-	((uint32_t *) ctx->in)[14] = ctx->bits[0];
-	((uint32_t *) ctx->in)[15] = ctx->bits[1];
+	PUTWORD(ctx->in + 56, ctx->bits[0]);
+	PUTWORD(ctx->in + 60, ctx->bits[1]);
 
-	MD5Transform(ctx->buf, (uint32_t *) ctx->in);
-	byteReverse((unsigned char *) ctx->buf, 4);
+	MD5Transform(ctx->buf, ctx->in);
 
-	if (digest!=NULL)
-		memcpy(digest, ctx->buf, 16);
+	if (digest!=NULL) {
+		PUTWORD(digest, ctx->buf[0]);
+		PUTWORD(digest + 4, ctx->buf[1]);
+		PUTWORD(digest + 8, ctx->buf[2]);
+		PUTWORD(digest + 12, ctx->buf[3]);
+	}
 	memset(ctx, 0, sizeof(*ctx));	/* In case it's sensitive */
 }
 
@@ -183,19 +174,41 @@ void MD5Final(struct MD5Context *ctx, unsigned char* digest)
 #define F3(x, y, z) (x ^ y ^ z)
 #define F4(x, y, z) (y ^ (x | ~z))
 
-/* This is the central step in the MD5 algorithm. */
+/* This is the central step in the MD5 algorithm.  The data and
+ * constant do not depend on the previous step, so they are added first. */
 #define MD5STEP(f, w, x, y, z, data, s) \
-	( w += f(x, y, z) + data,  w = w<<s | w>>(32-s),  w += x )
+	( w += data,  w += f(x, y, z),  w = w<<s | w>>(32-s),  w += x )
+
+/* F2 is (x & z | y & ~z);  the two terms have no bits in common, so they
+ * can be added to w separately, which shortens the dependency on x. */
+#define MD5STEP2(w, x, y, z, data, s) \
+	( w += data,  w += ~z & y,  w += z & x,  w = w<<s | w>>(32-s),  w += x )
 
 /*
  * The core of the MD5 algorithm, this alters an existing MD5 hash to
- * reflect the addition of 16 longwords of new data.  MD5Update blocks
- * the data and converts bytes into longwords for this routine.
+ * reflect the addition of a 64 byte block of new data.
  */
-static void MD5Transform(uint32_t buf[4], uint32_t const in[16])
+static void MD5Transform(uint32_t buf[4], unsigned char const *block)
 {
 	register uint32_t a, b, c, d;
+	uint32_t const *in;
+	uint32_t words[16];
+#ifndef LITTLE_ENDIAN_FOR_SURE
+	int i;
+#endif
 
+#ifdef LITTLE_ENDIAN_FOR_SURE
+	if( ((unsigned long) block & (sizeof(uint32_t) - 1)) == 0 ){
+		in = (uint32_t const *) block;
+	} else {
+		memcpy(words, block, 64);
+		in = words;
+	}
+#else
+	for (i = 0; i < 16; i++)
+		words[i] = GETWORD(block + 4 * i);
+	in = words;
+#endif
 	a = buf[0];
 	b = buf[1];
 	c = buf[2];
@@ -218,22 +231,22 @@ static void MD5Transform(uint32_t buf[4], uint32_t const in[16])
 	MD5STEP(F1, c, d, a, b, in[14] + 0xa679438e, 17);
 	MD5STEP(F1, b, c, d, a, in[15] + 0x49b40821, 22);
 
-	MD5STEP(F2, a, b, c, d, in[1] + 0xf61e2562, 5);
-	MD5STEP(F2, d, a, b, c, in[6] + 0xc040b340, 9);
-	MD5STEP(F2, c, d, a, b, in[11] + 0x265e5a51, 14);
-	MD5STEP(F2, b, c, d, a, in[0] + 0xe9b6c7aa, 20);
-	MD5STEP(F2, a, b, c, d, in[5] + 0xd62f105d, 5);
-	MD5STEP(F2, d, a, b, c, in[10] + 0x02441453, 9);
-	MD5STEP(F2, c, d, a, b, in[15] + 0xd8a1e681, 14);
-	MD5STEP(F2, b, c, d, a, in[4] + 0xe7d3fbc8, 20);
-	MD5STEP(F2, a, b, c, d, in[9] + 0x21e1cde6, 5);
-	MD5STEP(F2, d, a, b, c, in[14] + 0xc33707d6, 9);
-	MD5STEP(F2, c, d, a, b, in[3] + 0xf4d50d87, 14);
-	MD5STEP(F2, b, c, d, a, in[8] + 0x455a14ed, 20);
-	MD5STEP(F2, a, b, c, d, in[13] + 0xa9e3e905, 5);
-	MD5STEP(F2, d, a, b, c, in[2] + 0xfcefa3f8, 9);
-	MD5STEP(F2, c, d, a, b, in[7] + 0x676f02d9, 14);
-	MD5STEP(F2, b, c, d, a, in[12] + 0x8d2a4c8a, 20);
+	MD5STEP2(a, b, c, d, in[1] + 0xf61e2562, 5);
+	MD5STEP2(d, a, b, c, in[6] + 0xc040b340, 9);
+	MD5STEP2(c, d, a, b, in[11] + 0x265e5a51, 14);
+	MD5STEP2(b, c, d, a, in[0] + 0xe9b6c7aa, 20);
+	MD5STEP2(a, b, c, d, in[5] + 0xd62f105d, 5);
+	MD5STEP2(d, a, b, c, in[10] + 0x02441453, 9);
+	MD5STEP2(c, d, a, b, in[15] + 0xd8a1e681, 14);
+	MD5STEP2(b, c, d, a, in[4] + 0xe7d3fbc8, 20);
+	MD5STEP2(a, b, c, d, in[9] + 0x21e1cde6, 5);
+	MD5STEP2(d, a, b, c, in[14] + 0xc33707d6, 9);
+	MD5STEP2(c, d, a, b, in[3] + 0xf4d50d87, 14);
+	MD5STEP2(b, c, d, a, in[8] + 0x455a14ed, 20);
+	MD5STEP2(a, b, c, d, in[13] + 0xa9e3e905, 5);
+	MD5STEP2(d, a, b, c, in[2] + 0xfcefa3f8, 9);
+	MD5STEP2(c, d, a, b, in[7] + 0x676f02d9, 14);
+	MD5STEP2(b, c, d, a, in[12] + 0x8d2a4c8a, 20);
 
 	MD5STEP(F3, a, b, c, d, in[5] + 0xfffa3942, 4);
 	MD5STEP(F3, d, a, b, c, in[8] + 0x8771f681, 11);
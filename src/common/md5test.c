@@ -0,0 +1,111 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+/*
+ * MD5 tests
+ *  Checks the RFC 1321 test suite values,  hashing each string with one
+ *  MD5Update() call and again streamed in pieces of every size from 1 to
+ *  70 bytes from an unaligned buffer,  so both the whole block path and
+ *  the partial block path of MD5Update() are used.
+ *  Exits 0 if all of them pass.
+ *
+ *  md5test
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "md5.h"
+
+static const char *Md5_tests[][2] = {
+	{ "", "d41d8cd98f00b204e9800998ecf8427e" },
+	{ "a", "0cc175b9c0f1b6a831c399e269772661" },
+	{ "abc", "900150983cd24fb0d6963f7d28e17f72" },
+	{ "message digest", "f96b697d7cb7938d525a2f31aaf161d0" },
+	{ "abcdefghijklmnopqrstuvwxyz", "c3fcd3d76192e4007dfb496cca67e13b" },
+	{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+		"d174ab98d277d9f5a5611c2c9f419d9f" },
+	{ "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+		"57edf4a22be3c955ac49da2e2107b67a" },
+	{ 0, 0 }
+};
+
+static int Failed;
+
+static void Check( const char *name, const char *str, int chunk,
+	unsigned char *digest, const char *expect )
+{
+	char hex[2*MD5_KEY_LENGTH+1];
+	int i;
+
+	for( i = 0; i < MD5_KEY_LENGTH; ++i ){
+		sprintf( hex+2*i, "%02x", digest[i] );
+	}
+	if( strcmp( hex, expect ) ){
+		++Failed;
+		fprintf( stderr, "md5test: %s '%.20s' chunk %d gave %s, expected %s\n",
+			name, str, chunk, hex, expect );
+	}
+}
+
+int main( void )
+{
+	MD5_CONTEXT ctx;
+	unsigned char digest[MD5_KEY_LENGTH];
+	unsigned char *buf, *unaligned;
+	int i, len, chunk, n, count = 0;
+
+	for( i = 0; Md5_tests[i][0]; ++i ){
+		len = strlen( Md5_tests[i][0] );
+		buf = malloc( len + 2 );
+		unaligned = buf + 1;
+		memcpy( unaligned, Md5_tests[i][0], len );
+
+		/* one shot */
+		MD5Init( &ctx );
+		MD5Update( &ctx, (const unsigned char *)Md5_tests[i][0], len );
+		MD5Final( &ctx, digest );
+		Check( "one shot", Md5_tests[i][0], len, digest, Md5_tests[i][1] );
+		++count;
+
+		/* streamed */
+		for( chunk = 1; chunk <= 70; ++chunk ){
+			MD5Init( &ctx );
+			for( n = 0; n < len; n += chunk ){
+				MD5Update( &ctx, unaligned + n, len - n < chunk ? len - n : chunk );
+			}
+			MD5Final( &ctx, digest );
+			Check( "streamed", Md5_tests[i][0], chunk, digest, Md5_tests[i][1] );
+			++count;
+		}
+		free( buf );
+	}
+
+	/* a million 'a's, in blocks and odd pieces */
+	buf = malloc( 1000 );
+	memset( buf, 'a', 1000 );
+	for( chunk = 1000; chunk >= 999; --chunk ){
+		MD5Init( &ctx );
+		for( n = 0; n < 1000000; n += len ){
+			len = 1000000 - n < chunk ? 1000000 - n : chunk;
+			MD5Update( &ctx, buf, len );
+		}
+		MD5Final( &ctx, digest );
+		Check( "million", "a...", chunk, digest, "7707d6ae4e027c70eea2a935c2296f21" );
+		++count;
+	}
+	free( buf );
+
+	printf( "md5test: %d tests, %d failed\n", count, Failed );
+	return( Failed != 0 );
+}
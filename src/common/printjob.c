@@ -14,12 +14,17 @@
 #include "child.h"
 #include "fileopen.h"
 #include "printjob.h"
+#include "banner.h"
 /**** ENDINCLUDE ****/
 #if defined(HAVE_TCDRAIN)
 #  if defined(HAVE_TERMIOS_H)
 #    include <termios.h>
 #  endif
 #endif
+#if defined(HAVE_SYS_SENDFILE_H) && defined(HAVE_SENDFILE)
+#  include <sys/sendfile.h>
+#  define PASSTHROUGH_SENDFILE 1
+#endif
 
 /***************************************************************************
  * Commentary:
@@ -74,10 +79,15 @@ static int Run_OF_filter( int send_job_rw_timeout, int *of_pid, int *of_stdin, i
 	struct job *job, const char *id, int terminate_of,
 	char *msgbuffer, int msglen );
 static void Print_banner( const char *name, char *pgm, struct job *job );
+static int Same_next_datafile( struct job *job, int count );
+static int Lookahead_filter_ok( int fd, const char *filter, off_t *start );
 static int Write_outbuf_to_OF( struct job *job, const char *title,
 	int of_fd, char *buffer, int outlen,
 	int of_error, char *msg, int msgmax,
 	int timeout, int poll_for_status, char *status_file );
+static int Sendfile_to_OF( struct job *job, const char *title,
+	int of_fd, int infd, int of_error, char *msg, int msgmax,
+	int timeout, int poll_for_status, char *status_file );
 
 
  
@@ -122,23 +132,26 @@ int Print_job( int output, int status_device, struct job *job,
 	char *FF_str, *leader_str, *trailer_str, *filter;
 	int i, of_stdin, of_stderr, if_error[2],
 		of_pid, copy, copies,
-		do_banner, n, pid, count, fd, tempfd,
+		do_banner, n, pid, count, fd, tempfd, replayfd, infd, filter_out,
 		files_printed, time_left;
 
 	char msg[SMALLBUFFER];
 	char filter_name[8], filter_title[64], msgbuffer[SMALLBUFFER],
 		filtermsgbuffer[SMALLBUFFER];
 	const char *id, *s, *banner_name, *transfername, *openname, *format;
+	const char *replay_openname, *replay_format, *replay_filter;
 	char *t;
 	struct line_list *datafile, files;
 	struct stat statb;
+	off_t replay_start = 0;
 
 	of_pid = -1;
 	msgbuffer[0] = 0;
 	filtermsgbuffer[0] = 0;
 	Errorcode = 0;
 	Init_line_list(&files);
-	of_stdin = of_stderr = tempfd = fd = -1;
+	of_stdin = of_stderr = tempfd = fd = replayfd = -1;
+	replay_openname = replay_format = replay_filter = 0;
 	FF_str = leader_str = trailer_str = 0;
 	files_printed = 0;
 
@@ -334,6 +347,33 @@ int Print_job( int output, int status_device, struct job *job,
 			setstatus(job, "data file '%s', size now %0.0f",
 				transfername, (double)statb.st_size );
 		}
+		/*
+		 * with filter_copy_replay the filter output for the first copy
+		 * goes to a temp file,  which is sent to the device for each copy.
+		 * lpr -K puts in a line for each copy,  so we keep the
+		 * output while the next data file is the same file again.
+		 */
+		if( replayfd >= 0 && (safestrcmp( replay_openname, openname )
+			|| safestrcmp( replay_format, format )
+			|| safestrcmp( replay_filter, filter )) ){
+			close(replayfd); replayfd = -1;
+		}
+		/* the queue server may have run the filter while the last job printed */
+		if( Filter_lookahead_DYN && replayfd < 0 && filter && !user_filter
+			&& cval(format) != 'p' && (t = Lookahead_file( job, count ))
+			&& (replayfd = Checkread( t, &statb )) >= 0 ){
+			unlink( t );
+			if( Lookahead_filter_ok( replayfd, filter, &replay_start ) ){
+				setstatus(job, "using %s output made by lookahead", filter_title );
+				replay_openname = openname;
+				replay_format = format;
+				replay_filter = filter;
+			} else {
+				setstatus(job, "discarding %s output made by lookahead with another filter",
+					filter_title );
+				close(replayfd); replayfd = -1;
+			}
+		}
 		for( copy = 0; copy < copies; ++copy ){
 			if( fd && lseek(fd,0,SEEK_SET) == -1 ){
 				Errorcode = JABORT;
@@ -388,9 +428,21 @@ int Print_job( int output, int status_device, struct job *job,
 			}
 
 			Set_block_io( output );
-			if( filter ){
+			filter_out = output;
+			if( filter && replayfd < 0 ){
 				DEBUG3("Print_job: format '%s' starting filter '%s'",
 					format, filter );
+				if( Filter_copy_replay_DYN && openname
+					&& (copies > 1 || Same_next_datafile( job, count )) ){
+					replayfd = Make_temp_fd(0);
+					replay_start = 0;
+					filter_out = replayfd;
+					replay_openname = openname;
+					replay_format = format;
+					replay_filter = filter;
+					DEBUG3("Print_job: saving %s output in fd %d",
+						filter_title, replayfd );
+				}
 				DEBUG2("Print_job: filter_stderr_to_status_file %d, ps '%s'",
 					Filter_stderr_to_status_file_DYN, Status_file_DYN );
 				if_error[0] = if_error[1] = -1;
@@ -411,7 +463,7 @@ int Print_job( int output, int status_device, struct job *job,
 				Free_line_list(&files);
 				Check_max(&files, 10 );
 				files.list[files.count++] = Cast_int_to_voidstar(fd);		/* stdin */
-				files.list[files.count++] = Cast_int_to_voidstar(output);	/* stdout */
+				files.list[files.count++] = Cast_int_to_voidstar(filter_out);	/* stdout */
 				files.list[files.count++] = Cast_int_to_voidstar(if_error[1]);	/* stderr */
 				if( (pid = Make_passthrough( filter, s, &files, job, 0 )) < 0 ){
 					Errorcode = JFAIL;
@@ -436,8 +488,9 @@ int Print_job( int output, int status_device, struct job *job,
 						if_error[0], filtermsgbuffer, sizeof(filtermsgbuffer)-1,
 						send_job_rw_timeout, 0, 0, Status_file_DYN );
 					if( filtermsgbuffer[0] ){
-						setstatus(job, "%s filter msg - '%s'", filter_title, filtermsgbuffer );
+						Filter_status(job, filter_title, filtermsgbuffer );
 					}
+					Flush_filter_status( job, 1 );
 					if( n ){
 						Errorcode = n;
 						setstatus(job, "%s filter problems, error '%s'",
@@ -474,12 +527,34 @@ int Print_job( int output, int status_device, struct job *job,
 					setstatus(job, "%s filter finished", filter_title );
 					break;
 				}
-			} else {
+			}
+			if( !filter || replayfd >= 0 ){
 				/* we write to the output device, and then get status */
+				infd = fd;
+				if( replayfd >= 0 ){
+					infd = replayfd;
+					if( lseek(infd,replay_start,SEEK_SET) == -1 ){
+						Errorcode = JABORT;
+						logerr(LOG_INFO, "Print_job:  lseek replay file failed");
+						goto end_of_job;
+					}
+					if( filter_out == output ){
+						setstatus(job, "sending saved %s output", filter_title );
+					}
+				}
 				DEBUG3("Print_job: format '%s' no filter, reading from %d",
-					format, fd );
+					format, infd );
+				n = Sendfile_to_OF(job,"LP",output, infd,
+					status_device, msgbuffer, sizeof(msgbuffer)-1,
+					send_job_rw_timeout, poll_for_status, Status_file_DYN );
+				if( n > 0 ){
+					Errorcode = JFAIL;
+					setstatus(job, "error '%s'", Server_status(n));
+					goto end_of_job;
+				}
 				Init_buf(&Outbuf, &Outmax, &Outlen );
-				while( (Outlen = Read_fd_len_timeout(send_job_rw_timeout,fd,Outbuf,Outmax)) > 0 ){
+				/* n < 0 - copy what sendfile() did not do */
+				if( n < 0 ) while( (Outlen = Read_fd_len_timeout(send_job_rw_timeout,infd,Outbuf,Outmax)) > 0 ){
 					Outbuf[Outlen] = 0;
 					n = Write_outbuf_to_OF(job,"LP",output, Outbuf, Outlen,
 						status_device, msgbuffer, sizeof(msgbuffer)-1,
@@ -550,9 +625,10 @@ int Print_job( int output, int status_device, struct job *job,
 			}
 		}
 		if( msgbuffer[0] ){
-			setstatus(job, "%s filter msg - '%s'", "LP", msgbuffer );
+			Filter_status(job, "LP", msgbuffer );
 		}
 	}
+	Flush_filter_status( job, 1 );
 	Init_buf(&Outbuf, &Outmax, &Outlen );
 #ifdef HAVE_TCDRAIN
 	if( isatty( output ) && tcdrain( output ) == -1 ){
@@ -570,6 +646,7 @@ int Print_job( int output, int status_device, struct job *job,
 	if( of_stdin != -1 ) close(of_stdin); of_stdin = -1;
 	if( of_stderr != -1 ) close(of_stderr); of_stderr = -1;
 	if( tempfd != -1 ) close(tempfd); tempfd = -1;
+	if( replayfd != -1 ) close(replayfd); replayfd = -1;
 	if( fd != -1 ) close(fd); fd = -1;
 	if(DEBUGL3){
 		LOGDEBUG("Print_job: at end open fd's");
@@ -582,6 +659,144 @@ int Print_job( int output, int status_device, struct job *job,
 	return( Errorcode );
 }
 
+/*
+ * Lookahead_job - run the input filters for a job that is waiting to print,
+ *  saving the output in the Lookahead_file() files.  Print_job() sends
+ *  these instead of running the filter again.  This is run by a process
+ *  the queue server starts while the job before it is printing
+ *  (filter_lookahead).  Files in 'p' format or without a filter are
+ *  left to Print_job(),  and we do the same file once as Print_job()
+ *  sends the saved output for each of the copies.
+ *  The first line of each file is the filter command line,  so that
+ *  Print_job() does not use output made by a filter that has changed.
+ */
+
+void Lookahead_job( struct job *job )
+{
+	struct line_list *datafile;
+	char *filter, *tempfile, *name, *s;
+	char filter_name[8], filter_title[64];
+	const char *openname, *format;
+	int count, fd, tempfd, n;
+	struct stat statb;
+
+	/* the filters see the banner name that Print_job() sets */
+	if( Always_banner_DYN && Find_str_value(&job->info,BNRNAME) == 0 ){
+		s = Find_str_value(&job->info,LOGNAME);
+		if( s == 0 ) s = "ANONYMOUS";
+		Set_str_value(&job->info,BNRNAME,s);
+	}
+	for( count = 0; count < job->datafiles.count; ++count ){
+		datafile = (void *)job->datafiles.list[count];
+		openname = Find_str_value(datafile,OPENNAME);
+		if( !openname ) openname = Find_str_value(datafile,DFTRANSFERNAME);
+		format = Find_str_value(datafile,FORMAT);
+		if( cval(format) == 'p' || (count > 0 && Same_next_datafile( job, count-1 ))
+			|| !(name = Lookahead_file( job, count )) ){
+			continue;
+		}
+
+		/* the same filter as Print_job() */
+		plp_snprintf(filter_name,sizeof(filter_name), "%s","if");
+		filter_name[0] = cval(format);
+		filter = 0;
+		switch( cval(format) ){
+			case 'f': case 'l':
+				filter_name[0] = 'i';
+				filter = IF_Filter_DYN;
+				break;
+			case 'a': case 'i': case 'o': case 's':
+				filter_name[0] = 'i';
+				filter = IF_Filter_DYN;
+				format = "f";
+				break;
+		}
+		if( !filter ) filter = Find_str_value(&PC_entry_line_list, filter_name );
+		if( !filter ) filter = Find_str_value(&Config_line_list,filter_name );
+		if( filter == 0 ) filter = Filter_DYN;
+		if( filter == 0 || safestrchr( filter, '\n' ) ) continue;
+
+		Set_str_value(&job->info,FORMAT,format);
+		Set_str_value(&job->info,DF_NAME,Find_str_value(datafile,DFTRANSFERNAME));
+		Set_str_value(&job->info,"N",Find_str_value(datafile,"N"));
+
+		if( openname == 0 || (fd = Checkread( openname, &statb )) < 0 ){
+			logmsg( LOG_ERR, "Lookahead_job: cannot open data file '%s'",
+				openname );
+			return;
+		}
+		s = 0;
+		if( Backwards_compatible_filter_DYN ) s = BK_filter_options_DYN;
+		if( s == 0 ) s = Filter_options_DYN;
+		uppercase(filter_name);
+		plp_snprintf(filter_title,sizeof(filter_title), "%s lookahead",
+			filter_name );
+		DEBUG1("Lookahead_job: '%s' format '%s' filter '%s' to '%s'",
+			openname, format, filter, name );
+		tempfd = Make_temp_fd( &tempfile );
+		if( Write_fd_str( tempfd, filter ) < 0 || Write_fd_str( tempfd, "\n" ) < 0 ){
+			logerr(LOG_INFO, "Lookahead_job: write to '%s' failed", tempfile );
+			close(fd); fd = -1;
+			close(tempfd); tempfd = -1;
+			return;
+		}
+		n = Filter_file( Send_job_rw_timeout_DYN, fd, tempfd, filter_title,
+			filter, s, job, 0, 1 );
+		close(fd); fd = -1;
+		close(tempfd); tempfd = -1;
+		if( n ){
+			setstatus(job, "%s filter exit status '%s'",
+				filter_title, Server_status(n));
+			return;
+		}
+		/* Print_job() only sees the file when the output is complete */
+		if( rename( tempfile, name ) == -1 ){
+			logerr(LOG_INFO, "Lookahead_job: rename '%s' to '%s' failed",
+				tempfile, name );
+			return;
+		}
+	}
+}
+
+/*
+ * Lookahead_filter_ok - the lookahead output in fd was made by filter.
+ *  Leaves fd at the start of the output,  which is put in *start.
+ */
+
+static int Lookahead_filter_ok( int fd, const char *filter, off_t *start )
+{
+	char line[LARGEBUFFER];
+	char *s;
+	int n;
+
+	if( (n = ok_read( fd, line, sizeof(line)-1 )) <= 0 ) return( 0 );
+	line[n] = 0;
+	if( !(s = safestrchr( line, '\n' )) ) return( 0 );
+	*s++ = 0;
+	DEBUG1("Lookahead_filter_ok: made by '%s', filter '%s'", line, filter );
+	if( safestrcmp( line, filter ) ) return( 0 );
+	*start = s - line;
+	return( lseek( fd, *start, SEEK_SET ) != (off_t)-1 );
+}
+
+/*
+ * Same_next_datafile - the data file after job->datafiles.list[count]
+ *  is the same file in the same format
+ */
+
+static int Same_next_datafile( struct job *job, int count )
+{
+	struct line_list *datafile, *next;
+
+	if( count+1 >= job->datafiles.count ) return( 0 );
+	datafile = (void *)job->datafiles.list[count];
+	next = (void *)job->datafiles.list[count+1];
+	return( !safestrcmp( Find_str_value(datafile,OPENNAME),
+			Find_str_value(next,OPENNAME) )
+		&& !safestrcmp( Find_str_value(datafile,FORMAT),
+			Find_str_value(next,FORMAT) ) );
+}
+
 /*
  * int Create_OF_filter( int *of_stdin, int *of_stderr )
  *  of_stdin = STDIN of filter (writable)
@@ -753,6 +968,36 @@ static int Run_OF_filter( int send_job_rw_timeout, int *of_pid, int *of_stdin, i
 	return( -1 );
 }
 
+/*
+ * Builtin_banner - bp=builtin
+ *  The banner page is made here instead of by a banner program.
+ *  banner_big and banner_info are lists of ';' separated templates,
+ *  expanded like the filter options, for the lines in big letters and
+ *  the information lines.  The page goes straight into Outbuf.
+ */
+
+static void Put_banner_line( const char *line, int len, void *arg UNUSED )
+{
+	Put_buf_len( line, len, &Outbuf, &Outmax, &Outlen );
+}
+
+static void Builtin_banner( struct job *job )
+{
+	struct line_list big, info;
+
+	Init_line_list(&big);
+	Init_line_list(&info);
+	Split(&big,Banner_big_DYN,";",0,0,0,0,0,";");
+	Split(&info,Banner_info_DYN,";",0,0,0,0,0,";");
+	Fix_dollars(&big,job,1,0);
+	Fix_dollars(&info,job,1,0);
+	Banner_page( Page_width_DYN, Page_length_DYN,
+		(const char **)big.list, big.count,
+		(const char **)info.list, info.count, Put_banner_line, 0 );
+	Free_line_list(&big);
+	Free_line_list(&info);
+}
+
 /*
  * Print a banner
  * check for a small or large banner as necessary
@@ -786,7 +1031,12 @@ static void Print_banner( const char *name, char *pgm, struct job *job )
 		return;
 	}
 
- 	if( pgm ){
+ 	if( pgm && !safestrcasecmp( pgm, "builtin" ) ){
+		setstatus(job, "creating builtin banner");
+		len = Outlen;
+		Builtin_banner( job );
+		DEBUG4("Print_banner: BANNER '%s'", Outbuf+len);
+	} else if( pgm ){
 		/* we now need to create a banner */
 		setstatus(job, "creating banner");
 
@@ -836,6 +1086,90 @@ static void Print_banner( const char *name, char *pgm, struct job *job )
 	}
 }
 
+/*
+ * Filter status throttling
+ *  Filters that report per page progress on STDERR can produce a
+ *  status update for every line.  If filter_status_interval is set,
+ *  messages arriving less than that many seconds after the last one
+ *  written just replace a pending message, which goes out when the
+ *  interval is up or the filter is done.  Messages that look like
+ *  errors always go out at once.
+ */
+
+ static char Pending_filter_msg[SMALLBUFFER];
+ static char Pending_filter_title[64];
+ static time_t Last_filter_status;
+ static int Suppressed_filter_msgs;
+ static const char *Urgent_filter_msgs[] = { "error", "fail", "abort", "fatal", 0 };
+
+static int Filter_msg_urgent( const char *msg )
+{
+	const char *s;
+	int i, len;
+
+	for( s = msg; s && *s; ++s ){
+		for( i = 0; Urgent_filter_msgs[i]; ++i ){
+			len = safestrlen(Urgent_filter_msgs[i]);
+			if( !safestrncasecmp( s, Urgent_filter_msgs[i], len ) ) return( 1 );
+		}
+	}
+	return( 0 );
+}
+
+void Flush_filter_status( struct job *job, int force )
+{
+	if( Pending_filter_msg[0] == 0 ) return;
+	if( !force && time((void *)0) - Last_filter_status < Filter_status_interval_DYN ){
+		return;
+	}
+	DEBUG3("Flush_filter_status: '%s', %d suppressed",
+		Pending_filter_msg, Suppressed_filter_msgs );
+	setstatus(job, "%s filter msg - '%s'", Pending_filter_title, Pending_filter_msg );
+	Pending_filter_msg[0] = 0;
+	Suppressed_filter_msgs = 0;
+	Last_filter_status = time((void *)0);
+}
+
+/*
+ * Filter_status_wait - how long to wait for filter output so that
+ *  a pending message still goes out when its interval is up
+ */
+
+static int Filter_status_wait( int left )
+{
+	int due;
+
+	if( Pending_filter_msg[0] == 0 ) return( left );
+	due = Filter_status_interval_DYN - (time((void *)0) - Last_filter_status);
+	if( due < 1 ) due = 1;
+	if( left <= 0 || due < left ) left = due;
+	return( left );
+}
+
+void Filter_status( struct job *job, const char *title, const char *msg )
+{
+	time_t now;
+
+	if( Filter_status_interval_DYN <= 0 ){
+		setstatus(job, "%s filter msg - '%s'", title, msg );
+		return;
+	}
+	now = time((void *)0);
+	if( Filter_msg_urgent( msg ) ){
+		Flush_filter_status( job, 1 );
+	} else if( now - Last_filter_status < Filter_status_interval_DYN ){
+		if( Pending_filter_msg[0] ) ++Suppressed_filter_msgs;
+		plp_snprintf( Pending_filter_title, sizeof(Pending_filter_title), "%s", title );
+		plp_snprintf( Pending_filter_msg, sizeof(Pending_filter_msg), "%s", msg );
+		return;
+	}
+	/* this one supersedes anything pending */
+	Pending_filter_msg[0] = 0;
+	Suppressed_filter_msgs = 0;
+	setstatus(job, "%s filter msg - '%s'", title, msg );
+	Last_filter_status = now;
+}
+
 /*
  * Write_outbuf_to_OF(
  * int of_fd, buffer, outlen     - write to this
@@ -871,6 +1205,7 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 
 	start_time = time((void *)0);
 	return_status = 0;
+	Flush_filter_status( job, 0 );
 	if( outlen == 0 ) return return_status;
 	if( of_fd >= 0 && fstat( of_fd, &statb ) ){
 		Errorcode = JABORT;
@@ -891,7 +1226,7 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 		do {
 			msglen = safestrlen(msg);
 			if( msglen >= msgmax ){
-				setstatus(job, "%s filter msg - '%s'", title, msg );
+				Filter_status(job, title, msg );
 				msg[0] = 0;
 				msglen = 0;
 			}
@@ -905,7 +1240,7 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 				msg[msglen] = 0;
 				while( (s = safestrchr(msg,'\n')) ){
 					*s++ = 0;
-					setstatus(job, "%s filter msg - '%s'", title, msg );
+					Filter_status(job, title, msg );
 					memmove(msg,s,safestrlen(s)+1);
 				}
 			}
@@ -935,7 +1270,7 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 		}
 		msglen = safestrlen(msg);
 		if( msglen >= msgmax ){
-			setstatus(job, "%s filter msg - '%s'", title, msg );
+			Filter_status(job, title, msg );
 			msg[0] = 0;
 			msglen = 0;
 		}
@@ -955,7 +1290,7 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 			s = msg;
 			while( (s = safestrchr(msg,'\n')) ){
 				*s++ = 0;
-				setstatus(job, "%s filter msg - '%s'", title, msg );
+				Filter_status(job, title, msg );
 				memmove(msg,s,safestrlen(s)+1);
 			}
 		}
@@ -967,6 +1302,155 @@ static int Write_outbuf_to_OF( struct job *job, const char *title,
 	return( return_status );
 }
 
+/*
+ * Sendfile_to_OF - send a data file straight to the device
+ *  Raw jobs were copied through Outbuf a buffer at a time.  If the system
+ *  has sendfile() and the data file is a regular file, we let the kernel
+ *  move the data to the device or socket, and wait for the device in the
+ *  same select() that reads its status.  As in Write_outbuf_to_OF(), the
+ *  timeout is the time we wait for the device to take more data, and an
+ *  update of the status file by the device restarts it.
+ *
+ *  returns 0 or the error status,  or -1 if sendfile() could not be used;
+ *   infd is then positioned at the data that still has to be sent.
+ */
+
+#define SENDFILE_CHUNK (1024*1024)
+
+static int Sendfile_to_OF( struct job *job, const char *title,
+	int of_fd, int infd, int of_error, char *msg, int msgmax,
+	int timeout, int poll_for_status, char *status_file )
+{
+#if defined(PASSTHROUGH_SENDFILE)
+	time_t start_time, current_time;
+	int msglen, return_status, count, elapsed, left, m, err, status_fd;
+	off_t offset, start;
+	struct stat statb;
+	struct timeval timeval, *tp;
+	fd_set readfds, writefds;
+	ssize_t n;
+	char *s;
+
+	if( poll_for_status || fstat( infd, &statb ) || !S_ISREG(statb.st_mode)
+		|| (start = offset = lseek( infd, 0, SEEK_CUR )) == (off_t)-1 ){
+		return( -1 );
+	}
+	DEBUG3("Sendfile_to_OF: infd %d, offset %0.0f, size %0.0f, of_fd %d, of_error %d, timeout %d",
+		infd, (double)offset, (double)statb.st_size, of_fd, of_error, timeout );
+	Flush_filter_status( job, 0 );
+	if( of_error > 0 && fstat( of_error, &statb ) == -1 ){
+		logerr(LOG_INFO, "Sendfile_to_OF: %s, of_error %d closed!",
+			title, of_error );
+		of_error = -1;
+	}
+	if( fstat( infd, &statb ) == -1 ) return( -1 );
+	return_status = 0;
+	status_fd = of_error;
+	Set_nonblock_io( of_fd );
+	if( status_fd > 0 ) Set_nonblock_io( status_fd );
+	start_time = time((void *)0);
+	while( return_status == 0 && offset < statb.st_size ){
+		left = timeout;
+		tp = 0;
+		if( timeout > 0 ){
+			current_time = time((void *)0);
+			elapsed = current_time - start_time;
+			left = timeout - elapsed;
+			if( left <= 0 ){
+				struct stat sstatb;
+				if( status_file && !stat(status_file, &sstatb)
+					&& current_time - sstatb.st_mtime < timeout ){
+					start_time = sstatb.st_mtime;
+					left = timeout - (current_time - start_time);
+				} else {
+					return_status = JTIMEOUT;
+					break;
+				}
+			}
+			memset( &timeval, 0, sizeof(timeval) );
+			timeval.tv_sec = left;
+			tp = &timeval;
+		}
+		FD_ZERO( &writefds );
+		FD_ZERO( &readfds );
+		FD_SET( of_fd, &writefds );
+		m = of_fd + 1;
+		if( of_error > 0 ){
+			FD_SET( of_error, &readfds );
+			if( m <= of_error ) m = of_error + 1;
+		}
+		m = select( m, &readfds, &writefds, NULL, tp );
+		err = errno;
+		if( m < 0 ){
+			if( err != EINTR ){
+				logerr(LOG_INFO, "Sendfile_to_OF: select returned %d, errno '%s'",
+					m, Errormsg(err) );
+				return_status = JTIMEOUT;
+			}
+			continue;
+		} else if( m == 0 ){
+			continue;
+		}
+		if( of_error > 0 && FD_ISSET( of_error, &readfds ) ){
+			msglen = safestrlen(msg);
+			if( msglen >= msgmax ){
+				Filter_status(job, title, msg );
+				msg[0] = 0;
+				msglen = 0;
+			}
+			count = read( of_error, msg+msglen, msgmax-msglen );
+			if( count > 0 ){
+				msglen += count;
+				msg[msglen] = 0;
+				while( (s = safestrchr(msg,'\n')) ){
+					*s++ = 0;
+					Filter_status(job, title, msg );
+					memmove(msg,s,safestrlen(s)+1);
+				}
+			} else if( count == 0 ){
+				/* nothing more from the status device */
+				of_error = -1;
+			}
+		}
+		if( FD_ISSET( of_fd, &writefds ) ){
+			count = SENDFILE_CHUNK;
+			if( statb.st_size - offset < count ) count = statb.st_size - offset;
+			n = sendfile( of_fd, infd, &offset, count );
+			err = errno;
+			DEBUG4("Sendfile_to_OF: sendfile %d returned %ld, offset %0.0f",
+				count, (long)n, (double)offset );
+			if( n > 0 ){
+				start_time = time((void *)0);
+			} else if( n == 0 ){
+				/* the file got shorter */
+				break;
+			} else if( err == EAGAIN || err == EINTR ){
+				continue;
+			} else if( err == EINVAL || err == ENOSYS ){
+				/* the device does not do sendfile(), use write() */
+				DEBUG3("Sendfile_to_OF: fallback at offset %0.0f, '%s'",
+					(double)offset, Errormsg(err) );
+				return_status = -1;
+			} else {
+				logerr(LOG_INFO, "Sendfile_to_OF: %s, sendfile failed", title );
+				return_status = JWRERR;
+			}
+		}
+	}
+	Set_block_io( of_fd );
+	if( status_fd > 0 ) Set_block_io( status_fd );
+	if( return_status < 0 && lseek( infd, offset, SEEK_SET ) == (off_t)-1 ){
+		logerr(LOG_INFO, "Sendfile_to_OF: lseek failed");
+		return_status = JABORT;
+	}
+	DEBUG3("Sendfile_to_OF: return_status %d, sent %0.0f",
+		return_status, (double)(offset - start) );
+	return( return_status );
+#else
+	return( -1 );
+#endif
+}
+
 /*
  * int Get_status_from_OF( struct job *job, char *title, int of_pid,
  *    int of_error, char *msg, int msgmax,
@@ -1043,7 +1527,7 @@ int Get_status_from_OF( struct job *job, const char *title, int of_pid,
 			do{
 				msglen = safestrlen(msg);
 				if( msglen >= msgmax ){
-					setstatus(job, "%s filter msg - '%s'", title, msg );
+					Filter_status(job, title, msg );
 					msg[0] = 0;
 					msglen = 0;
 				}
@@ -1054,7 +1538,7 @@ int Get_status_from_OF( struct job *job, const char *title, int of_pid,
 				if( count > 0 ){
 					while( (s = safestrchr(msg,'\n')) ){
 						*s++ = 0;
-						setstatus(job, "%s filter msg - '%s'", title, msg );
+						Filter_status(job, title, msg );
 						memmove(msg,s,safestrlen(s)+1);
 					}
 				}
@@ -1065,26 +1549,30 @@ int Get_status_from_OF( struct job *job, const char *title, int of_pid,
 				of_error, left );
 			msglen = safestrlen(msg);
 			if( msglen >= msgmax ){
-				setstatus(job, "%s filter msg - '%s'", title, msg );
+				Filter_status(job, title, msg );
 				msg[0] = 0;
 				msglen = 0;
 			}
 			Set_block_io( of_error );
-			count = Read_fd_len_timeout( left, of_error, msg+msglen, msgmax-msglen );
+			count = Read_fd_len_timeout( Filter_status_wait( left ),
+				of_error, msg+msglen, msgmax-msglen );
 			if( count > 0 ){
 				msglen += count;
 				msg[msglen] = 0;
 				s = msg;
 				while( (s = safestrchr(msg,'\n')) ){
 					*s++ = 0;
-					setstatus(job, "%s filter msg - '%s'", title, msg );
+					Filter_status(job, title, msg );
 					memmove(msg,s,safestrlen(s)+1);
 				}
 			} else if( count == 0 ){
 				done = 1;
 			}
 		} while( count > 0 );
+		/* a throttled message may be due even if the filter is quiet */
+		Flush_filter_status( job, 0 );
 	}
+	Flush_filter_status( job, 1 );
 	return(return_status);
 }
 
@@ -51,6 +51,10 @@
  ***************************************************************************/
 
 static void Put_in_auth( int tempfd, const char *key, char *value );
+static int Send_auth_stream( int *sock, int transfer_timeout,
+	struct job *job, struct job *logjob, char *header, double size,
+	char *tempfile, char *error, int errlen,
+	const struct security *security, struct line_list *info );
 
 /*
  * Send_auth_transfer
@@ -83,11 +87,12 @@ int Send_auth_transfer( int *sock, int transfer_timeout,
 	int ack, len, n, fd;		/* ACME! The best... */
 	int status = JFAIL;			/* job status */
 	char *secure, *destination, *from, *client, *s;
-	char *tempfile;
+	char *tempfile, *header;
 	char buffer[SMALLBUFFER];
+	double size;
 	errno = 0;
 
-	secure = 0;
+	secure = header = 0;
 	fd = Make_temp_fd(&tempfile);
 
 	if( cmd && (s = safestrrchr(cmd,'\n')) ) *s = 0;
@@ -126,7 +131,14 @@ int Send_auth_transfer( int *sock, int transfer_timeout,
 	}
 
 	s = Find_str_value(info, CMD );
-	if( job ){
+	if( job && security->client_send_stream
+		&& (size = Block_file_size( job )) >= 0 ){
+		/* the plugin gets the header and the block file on a pipe */
+		header = Get_fd_image( fd, 0 );
+		size += safestrlen(header);
+		plp_snprintf( buffer,sizeof(buffer), " %0.0f", size );
+		secure = safestrdup3(s,buffer,"\n",__FILE__,__LINE__);
+	} else if( job ){
         status = Send_normal( &fd, job, logjob, transfer_timeout, fd, 0);
         if( status ) return( status );
 		errno = 0;
@@ -201,17 +213,24 @@ int Send_auth_transfer( int *sock, int transfer_timeout,
      * now we do the protocol dependent exchange
      */
 
-	status = security->client_send( sock, transfer_timeout, tempfile,
-		error, errlen, security, info );
+	if( header ){
+		status = Send_auth_stream( sock, transfer_timeout, job, logjob,
+			header, size, tempfile, error, errlen, security, info );
+	} else {
+		status = security->client_send( sock, transfer_timeout, tempfile,
+			error, errlen, security, info );
+	}
 
  error:
 
+	if( job ) Close_data_files( job );
 	DEBUG3("Send_auth_transfer: sock %d, exit status %d, error '%s'",
 		*sock, status, error );
 	/* we are going to put the returned error status in the temp file
 	 * as the device to read from
 	 */
 	if( secure ) free(secure); secure = 0;
+	if( header ) free(header); header = 0;
 	if( error[0] ){
 		if( job ){
 			setstatus(logjob, "Send_auth_transfer: %s", error );
@@ -243,6 +262,73 @@ int Send_auth_transfer( int *sock, int transfer_timeout,
 	return( status );
 }
 
+/*
+ * Send_auth_stream
+ *  A subprocess writes the header and block file into a pipe with
+ *  Send_normal(),  directly from the data files,  and the plugin
+ *  client_send_stream() reads from the pipe.  The job is never copied
+ *  into the tempfile;  the plugin puts the reply (or error) there
+ *  as client_send() does.  The plugin runs in this process so that
+ *  state it keeps between transfers (ssl sessions) is not lost.
+ */
+
+static int Send_auth_stream( int *sock, int transfer_timeout,
+	struct job *job, struct job *logjob, char *header, double size,
+	char *tempfile, char *error, int errlen,
+	const struct security *security, struct line_list *info )
+{
+	int p[2], status, send_status;
+	plp_status_t procstatus;
+	pid_t pid, result;
+
+	DEBUG1("Send_auth_stream: size %0.0f", size );
+	if( pipe( p ) == -1 ){
+		Errorcode = JFAIL;
+		logerr_die(LOG_INFO, "Send_auth_stream: pipe failed" );
+	}
+	if( (pid = dofork(0)) < 0 ){
+		Errorcode = JFAIL;
+		logerr_die(LOG_INFO, "Send_auth_stream: fork failed" );
+	} else if( pid == 0 ){
+		close( p[0] );
+		if( Write_fd_str( p[1], header ) < 0 ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Send_auth_stream: pipe write failed" );
+		}
+		if( (Errorcode = Send_normal( &p[1], job, logjob,
+				transfer_timeout, p[1], 0 )) ){
+			setstatus(logjob, "Send_auth_stream: %s",
+				Find_str_value(&job->info,ERROR) );
+		}
+		cleanup(0);
+	}
+	close( p[1] );
+	/* the subprocess has its own copies */
+	Close_data_files( job );
+
+	status = security->client_send_stream( sock, transfer_timeout,
+		p[0], size, tempfile, error, errlen, security, info );
+	close( p[0] );
+
+	while( (result = plp_waitpid( pid, &procstatus, 0 )) != pid ){
+		if( result == -1 && errno != EINTR ){
+			Errorcode = JFAIL;
+			logerr_die(LOG_INFO, "Send_auth_stream: waitpid %ld failed",
+				(long)pid );
+		}
+	}
+	send_status = WIFEXITED(procstatus) ? WEXITSTATUS(procstatus) : JFAIL;
+	DEBUG1("Send_auth_stream: status %d, send status %d, error '%s'",
+		status, send_status, error );
+	if( send_status ){
+		/* the details are in the status log */
+		if( !status ) status = send_status;
+		plp_snprintf( error, errlen, "job '%s' not sent - %s",
+			Find_str_value(&job->info,IDENTIFIER), Decode_status( &procstatus ) );
+	}
+	return( status );
+}
+
 /***************************************************************************
  *
  * struct security *Fix_send_auth( char *name, struct line_list *info
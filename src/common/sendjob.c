@@ -457,7 +457,12 @@ static int Send_data_files( int *sock, struct job *job, struct job *logjob,
 		 * open file as user; we should be running as user
 		 */
 		size = 0;
-		if( !strcmp(openname,"-") ){
+		if( (fd = Find_decimal_value(lp,OPENFD)) > 0 ){
+			/* opened by Block_file_size(),  which sent this size */
+			size = Find_double_value(lp,OPENSIZE);
+			Set_str_value(lp,OPENFD,0);
+			Set_str_value(lp,OPENSIZE,0);
+		} else if( !strcmp(openname,"-") ){
 			openname = "(STDIN)";
 			fd = 0;
 			size = 0;
@@ -564,7 +569,7 @@ static int Send_data_files( int *sock, struct job *job, struct job *logjob,
 			/* now we need to read the file and transfer it */
 			total = 0;
 			while( total < size && (len = Read_fd_len_timeout(Send_job_rw_timeout_DYN,
-					fd, msg, sizeof(msg))) > 0 ){
+					fd, msg, (size - total < sizeof(msg)) ? (int)(size - total) : (int)sizeof(msg))) > 0 ){
 				if( write( block_fd, msg, len ) < 0 ){
 					goto write_error;
 				}
@@ -597,6 +602,75 @@ static int Send_data_files( int *sock, struct job *job, struct job *logjob,
 	return(status);
 }
 
+/***************************************************************************
+ * double Block_file_size( struct job *job )
+ *  The number of bytes Send_normal() writes to block_fd for the job,
+ *  so the block file can be streamed instead of staged in a file.
+ *  The data files are opened here and the sizes are taken from the
+ *  open files;  Send_data_files() sends those files with those sizes,
+ *  and Close_data_files() closes them if they are not sent.
+ *  Returns -1 if Send_normal() would not write a complete copy:
+ *  data from stdin, or data files that are missing or empty.
+ ***************************************************************************/
+
+double Block_file_size( struct job *job )
+{
+	char msg[SMALLBUFFER];
+	struct line_list *lp;
+	const char *openname, *transfername;
+	struct stat statb;
+	double total;
+	char *cf;
+	int count, fd;
+
+	if( !(cf = Find_str_value(&job->info,CF_OUT_IMAGE)) ) return( -1 );
+	plp_snprintf( msg, sizeof(msg), "%c%d %s\n",
+		CONTROL_FILE, (int)safestrlen(cf),
+		Find_str_value(&job->info,XXCFTRANSFERNAME) );
+	total = safestrlen(msg) + safestrlen(cf);
+	for( count = 0; count < job->datafiles.count; ++count ){
+		lp = (void *)job->datafiles.list[count];
+		transfername = Find_str_value(lp,DFTRANSFERNAME);
+		openname = Find_str_value(lp,OPENNAME);
+		if( !openname ) openname = transfername;
+		if( !openname || !strcmp(openname,"-")
+			|| (fd = Checkread( openname, &statb )) < 0 ){
+			Close_data_files( job );
+			return( -1 );
+		}
+		Set_decimal_value(lp,OPENFD,fd);
+		Set_double_value(lp,OPENSIZE,(double)statb.st_size);
+		if( statb.st_size == 0 ){
+			Close_data_files( job );
+			return( -1 );
+		}
+		plp_snprintf( msg, sizeof(msg), "%c%0.0f %s\n",
+			DATA_FILE, (double)statb.st_size, transfername );
+		total += safestrlen(msg) + statb.st_size;
+	}
+	DEBUG3("Block_file_size: %0.0f", total );
+	return( total );
+}
+
+/*
+ * Close_data_files - close the files opened by Block_file_size()
+ */
+
+void Close_data_files( struct job *job )
+{
+	struct line_list *lp;
+	int count, fd;
+
+	for( count = 0; count < job->datafiles.count; ++count ){
+		lp = (void *)job->datafiles.list[count];
+		if( (fd = Find_decimal_value(lp,OPENFD)) > 0 ){
+			close( fd );
+		}
+		Set_str_value(lp,OPENFD,0);
+		Set_str_value(lp,OPENSIZE,0);
+	}
+}
+
 /***************************************************************************
  * int Send_block(
  * 	char *RemoteHost_DYN,				- RemoteHost_DYN name
@@ -720,3 +794,291 @@ int Send_block( int *sock, struct job *job, struct job *logjob, int transfer_tim
 	return( status );
 }
 
+
+/***************************************************************************
+ * int Send_batch( struct job **jobs, int count,
+ * 	int connect_timeout_len, int transfer_timeout )
+ *
+ *  Send a set of jobs to the RemotePrinter_DYN over a single connection
+ *  (lpr -j).  The server takes any number of jobs after the
+ *  \2RemotePrinter_DYN line,  and queues a job as soon as it gets the
+ *  control file that follows the data files.  So we send the data files
+ *  of each job and then its control file,  and the ACKs for them are
+ *  the result for that job.
+ *
+ *  The files are written without waiting for each ACK;  the ACKs are read
+ *  as they arrive and matched up with the jobs in the order sent.
+ *  After a non-zero ACK the server sends an error message and closes the
+ *  connection,  so that job and the ones after it are not queued.
+ *
+ * 	RETURNS: number of jobs not queued,  with ERROR set in their info
+ ***************************************************************************/
+
+struct batch_acks {
+	int *sent;			/* jobs in the order they were sent */
+	int *pending;		/* ACKs each job is waiting for, -1 if not sent */
+	int count, done;	/* jobs sent, and jobs with all of their ACKs */
+	char error[SMALLBUFFER];	/* why the next job was not queued */
+};
+
+/*
+ * Batch_acks - read the ACKs that have arrived,  or wait for all of them
+ *  returns 0 or the link status
+ */
+
+static int Batch_acks( int sock, struct batch_acks *b, int timeout, int wait )
+{
+	char buffer[SMALLBUFFER];
+	fd_set readfds;
+	struct timeval delay;
+	int i, n, len, ack;
+
+	while( b->done < b->count ){
+		if( !wait ){
+			FD_ZERO( &readfds );
+			FD_SET( sock, &readfds );
+			memset( &delay, 0, sizeof(delay) );
+			if( select( sock+1, &readfds, 0, 0, &delay ) <= 0 ) return( 0 );
+		}
+		n = Read_fd_len_timeout( timeout, sock, buffer, sizeof(buffer)-1 );
+		if( n <= 0 ){
+			plp_snprintf( b->error, sizeof(b->error),
+				Alarm_timed_out ? "timeout waiting for ACK from %s@%s"
+					: "connection closed by %s@%s before ACK",
+				RemotePrinter_DYN, RemoteHost_DYN );
+			return( LINK_TRANSFER_FAIL );
+		}
+		for( i = 0; i < n; ++i ){
+			if( (ack = cval(buffer+i)) ){
+				/* the error message follows,  then the server closes */
+				len = n - i - 1;
+				memmove( buffer, buffer+i+1, len );
+				while( len < (int)sizeof(buffer)-1
+					&& (n = Read_fd_len_timeout( timeout, sock,
+						buffer+len, sizeof(buffer)-1-len )) > 0 ){
+					len += n;
+				}
+				buffer[len] = 0;
+				while( len > 0 && isspace(cval(buffer+len-1)) ) buffer[--len] = 0;
+				plp_snprintf( b->error, sizeof(b->error),
+					"error ack '%s' from %s@%s%s%s", Ack_err_str(ack),
+					RemotePrinter_DYN, RemoteHost_DYN, len?" - ":"", buffer );
+				return( LINK_ACK_FAIL );
+			}
+			if( b->done < b->count && --b->pending[b->sent[b->done]] == 0 ){
+				DEBUG3("Batch_acks: job %d queued", b->sent[b->done] );
+				++b->done;
+			}
+		}
+	}
+	return( 0 );
+}
+
+/*
+ * Batch_write - write to the socket,  and say why not
+ */
+
+static int Batch_write( int sock, int timeout, const char *str, int len,
+	char *error, int errlen )
+{
+	if( Write_fd_len_timeout( timeout, sock, str, len ) < 0 ){
+		plp_snprintf( error, errlen, "write to %s@%s failed - %s",
+			RemotePrinter_DYN, RemoteHost_DYN,
+			Alarm_timed_out ? "timeout" : Errormsg(errno) );
+		return( LINK_TRANSFER_FAIL );
+	}
+	return( 0 );
+}
+
+/*
+ * Batch_send_job - write the data files and then the control file of a job
+ *  fds has the data files open,  and is closed
+ */
+
+static int Batch_send_job( int sock, struct job *job, int *fds, double *sizes,
+	int timeout, char *error, int errlen )
+{
+	struct line_list *lp;
+	char msg[SMALLBUFFER], buffer[LARGEBUFFER];
+	char *cf, *transfername, *openname;
+	double left;
+	int i, n, status = 0;
+
+	for( i = 0; status == 0 && i < job->datafiles.count; ++i ){
+		lp = (void *)job->datafiles.list[i];
+		transfername = Find_str_value(lp,DFTRANSFERNAME);
+		openname = Find_str_value(lp,OPENNAME);
+		if( !openname ) openname = transfername;
+		plp_snprintf( msg, sizeof(msg), "%c%0.0f %s\n",
+			DATA_FILE, sizes[i], transfername );
+		status = Batch_write( sock, timeout, msg, safestrlen(msg), error, errlen );
+		/* not Link_copy(),  the ACKs for earlier files may be waiting */
+		for( left = sizes[i]; status == 0 && left > 0; left -= n ){
+			n = sizeof(buffer);
+			if( n > left ) n = left;
+			if( (n = ok_read( fds[i], buffer, n )) <= 0 ){
+				plp_snprintf( error, errlen, "read from '%s' failed, %0.0f bytes left",
+					openname, left );
+				status = LINK_TRANSFER_FAIL;
+			} else {
+				status = Batch_write( sock, timeout, buffer, n, error, errlen );
+			}
+		}
+		if( !status ) status = Batch_write( sock, timeout, "", 1, error, errlen );
+	}
+	for( i = 0; i < job->datafiles.count; ++i ){
+		if( fds[i] >= 0 ) close( fds[i] );
+		fds[i] = -1;
+	}
+	if( status ) return( status );
+
+	if( !(cf = Find_str_value(&job->info,CF_OUT_IMAGE)) ){
+		Errorcode = JABORT;
+		fatal(LOG_ERR, "Batch_send_job: LOGIC ERROR! missing CF_OUT_IMAGE");
+	}
+	plp_snprintf( msg, sizeof(msg), "%c%d %s\n",
+		CONTROL_FILE, safestrlen(cf), Find_str_value(&job->info,XXCFTRANSFERNAME) );
+	/* we include the 0 at the end */
+	if( !(status = Batch_write( sock, timeout, msg, safestrlen(msg), error, errlen )) ){
+		status = Batch_write( sock, timeout, cf, safestrlen(cf)+1, error, errlen );
+	}
+	return( status );
+}
+
+int Send_batch( struct job **jobs, int count,
+	int connect_timeout_len, int transfer_timeout )
+{
+	struct batch_acks b;
+	struct job *job;
+	struct line_list *lp;
+	struct stat statb;
+	char line[SMALLBUFFER], error[SMALLBUFFER], errmsg[SMALLBUFFER];
+	char *real_host = 0, *save_host = 0, *openname, *s;
+	const char *msg;
+	double *sizes = 0;
+	int *fds = 0;
+	int sock = -1, status = 0, connected = 0, failed = 0, max = 0;
+	int i, j, ack, err;
+
+	memset( &b, 0, sizeof(b) );
+	b.sent = malloc_or_die( (count+1)*sizeof(b.sent[0]),__FILE__,__LINE__);
+	b.pending = malloc_or_die( (count+1)*sizeof(b.pending[0]),__FILE__,__LINE__);
+	for( i = 0; i < count; ++i ){
+		b.pending[i] = -1;
+		Set_str_value(&jobs[i]->info,ERROR,0);
+		if( jobs[i]->datafiles.count > max ) max = jobs[i]->datafiles.count;
+	}
+	fds = malloc_or_die( (max+1)*sizeof(fds[0]),__FILE__,__LINE__);
+	sizes = malloc_or_die( (max+1)*sizeof(sizes[0]),__FILE__,__LINE__);
+	error[0] = 0;
+
+	setstatus(0, "sending %d jobs to %s@%s", count, RemotePrinter_DYN, RemoteHost_DYN );
+	errno = 0;
+	errmsg[0] = 0;
+	sock = Link_open_list( RemoteHost_DYN,
+		&real_host, connect_timeout_len, 0, Unix_socket_path_DYN, errmsg, sizeof(errmsg) );
+	err = errno;
+	if( sock < 0 ){
+		plp_snprintf( error, sizeof(error),
+			"cannot open connection to %s - %s", RemoteHost_DYN,
+				errmsg[0]?errmsg:(err?Errormsg(err):"bad or missing hostname?") );
+		goto done;
+	}
+	save_host = safestrdup(RemoteHost_DYN,__FILE__,__LINE__);
+	Set_DYN(&RemoteHost_DYN, real_host );
+	if( real_host ) free( real_host );
+
+	plp_snprintf( line, sizeof(line), "%c%s\n", REQ_RECV, RemotePrinter_DYN );
+	ack = 0;
+	if( (status = Link_send( RemoteHost_DYN, &sock, transfer_timeout,
+		line, safestrlen(line), &ack )) ){
+		if( (s = safestrchr(line,'\n')) ) *s = 0;
+		plp_snprintf( error, sizeof(error),
+			"error '%s'%s%s\n  sending str '%s' to %s@%s",
+			Link_err_str(status), ack?" with ack ":"", ack?Ack_err_str(ack):"",
+			line, RemotePrinter_DYN, RemoteHost_DYN );
+		goto done;
+	}
+	connected = 1;
+
+	for( i = 0; status == 0 && i < count; ++i ){
+		job = jobs[i];
+		/* open the data files first,  so a job is sent whole or not at all */
+		msg = 0;
+		for( j = 0; j < job->datafiles.count; ++j ) fds[j] = -1;
+		for( j = 0; !msg && j < job->datafiles.count; ++j ){
+			lp = (void *)job->datafiles.list[j];
+			openname = Find_str_value(lp,OPENNAME);
+			if( !openname ) openname = Find_str_value(lp,DFTRANSFERNAME);
+			if( !openname || !strcmp(openname,"-") ){
+				msg = "cannot send STDIN in a batch";
+			} else if( (fds[j] = Checkread( openname, &statb )) < 0 ){
+				plp_snprintf( errmsg, sizeof(errmsg),
+					"cannot open '%s' - '%s'", openname, Errormsg(errno) );
+				msg = errmsg;
+			} else if( statb.st_size == 0 ){
+				plp_snprintf( errmsg, sizeof(errmsg),
+					"zero length file '%s'", openname );
+				msg = errmsg;
+			} else {
+				sizes[j] = statb.st_size;
+			}
+		}
+		if( msg ){
+			for( j = 0; j < job->datafiles.count; ++j ){
+				if( fds[j] >= 0 ) close( fds[j] );
+			}
+			Set_str_value(&job->info,ERROR,msg);
+			continue;
+		}
+		b.sent[b.count++] = i;
+		b.pending[i] = 2 * (job->datafiles.count + 1);
+		DEBUG3("Send_batch: sending job %d, '%s'", i,
+			Find_str_value(&job->info,IDENTIFIER) );
+		if( (status = Batch_send_job( sock, job, fds, sizes, transfer_timeout,
+			error, sizeof(error) )) ){
+			/* the server may have told us why;  it gets EOF and stops */
+			shutdown( sock, 1 );
+			if( Batch_acks( sock, &b, transfer_timeout, 1 ) ){
+				mystrncpy( error, b.error, sizeof(error) );
+			}
+			break;
+		}
+		if( (status = Batch_acks( sock, &b, transfer_timeout, 0 )) ){
+			mystrncpy( error, b.error, sizeof(error) );
+		}
+	}
+	if( status == 0 && (status = Batch_acks( sock, &b, transfer_timeout, 1 )) ){
+		mystrncpy( error, b.error, sizeof(error) );
+	}
+
+ done:
+	/* the job we were waiting for gets the error,  and the rest did not go */
+	if( b.done < b.count && error[0] ){
+		Set_str_value(&jobs[b.sent[b.done]]->info,ERROR,error);
+	}
+	for( i = 0; i < count; ++i ){
+		job = jobs[i];
+		if( b.pending[i] != 0 && !Find_str_value(&job->info,ERROR) ){
+			Set_str_value(&job->info,ERROR,
+				connected ? "an earlier job failed" : error );
+		}
+		if( Find_str_value(&job->info,ERROR) ){
+			Set_nz_flag_value(&job->info,ERROR_TIME,time(0));
+			++failed;
+		}
+	}
+	setstatus(0, "queued %d of %d jobs on %s@%s", b.done, count,
+		RemotePrinter_DYN, RemoteHost_DYN );
+	if( sock >= 0 ) sock = Shutdown_or_close(sock);
+	if( sock >= 0 ) close(sock); sock = -1;
+	if( save_host ){
+		Set_DYN(&RemoteHost_DYN,save_host);
+		free(save_host); save_host = 0;
+	}
+	free( b.sent );
+	free( b.pending );
+	free( fds );
+	free( sizes );
+	return( failed );
+}
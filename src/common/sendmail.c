@@ -16,8 +16,11 @@
 #include "getqueue.h"
 #include "sendmail.h"
 #include "child.h"
+#include "lpd_worker.h"
 /**** ENDINCLUDE ****/
 
+static int Mail_queue( char *mailname, char *opname, int fd, off_t start );
+
 /*
  * sendmail --- tell people about job completion
  * 1. fork a sendmail process
@@ -29,6 +32,7 @@ void Sendmail_to_user( int retval, struct job *job )
 {
 	char buffer[SMALLBUFFER], msg[SMALLBUFFER];
 	int n, tempfd;
+	off_t start;
 	char *id, *mailname, *opname, *s;
 
 	/*
@@ -71,6 +75,11 @@ void Sendmail_to_user( int retval, struct job *job )
 		"%s: %s\n", mailname?"CC":"To", opname );
 		if( Write_fd_str( tempfd, buffer ) < 0 ) goto wr_error;
 	}
+	/* the queued messages have one recipient each */
+	if( (start = lseek( tempfd, 0, SEEK_CUR )) == -1 ){
+		Errorcode = JABORT;
+		logerr_die(LOG_ERR, "Sendmail_to_user: seek failed");
+	}
 	setstatus( job, "sending mail to %s", msg );
 	plp_snprintf(buffer,sizeof(buffer),
 		"From: %s@%s\n",
@@ -113,17 +122,23 @@ void Sendmail_to_user( int retval, struct job *job )
 	/*
 	 * get the last status of the spooler
 	 */
-	if( (s = Get_file_image( Queue_status_file_DYN, Max_status_size_DYN )) ){
+	if( (s = Get_status_file_image( Queue_status_file_DYN, Max_status_size_DYN )) ){
 		if( Write_fd_str( tempfd, "\nStatus:\n\n" ) < 0 ||
 			Write_fd_str( tempfd, s ) < 0 ) goto wr_error;
 		if(s) free(s); s = 0;
 	}
 
-	if( (s = Get_file_image( Status_file_DYN, Max_status_size_DYN )) ){
+	if( (s = Get_status_file_image( Status_file_DYN, Max_status_size_DYN )) ){
 		if( Write_fd_str( tempfd, "\nFilter Status:\n\n" ) < 0 ||
 			Write_fd_str( tempfd, s ) < 0 ) goto wr_error;
 		if(s) free(s); s = 0;
 	}
+	if( cval(Mail_queue_dir_DYN) == '/'
+		&& Mail_queue( mailname, opname, tempfd, start ) == 0 ){
+		DEBUG2("Sendmail_to_user: queued in '%s'", Mail_queue_dir_DYN );
+		close( tempfd );
+		return;
+	}
 	if( lseek( tempfd, 0, SEEK_SET ) == -1 ){
 		Errorcode = JABORT;
 		logerr_die(LOG_ERR, "Sendmail_to_user: seek failed");
@@ -133,9 +148,225 @@ void Sendmail_to_user( int retval, struct job *job )
 		Errorcode = JABORT;
 		logerr(LOG_ERR, "Sendmail_to_user: '%s' failed '%s'", Sendmail_DYN, Server_status(n) );
 	}
+	close( tempfd );
 	return;
 
  wr_error:
 	Errorcode = JABORT;
 	logerr_die(LOG_ERR, "Sendmail_to_user: write failed");
 }
+
+/*
+ * Mail queue
+ *
+ *  If mail_queue_dir is set in lpd.conf the queue server does not run
+ *  sendmail for each job,  which could hold up a queue that is failing
+ *  jobs.  It puts a file with the message for each recipient in the
+ *  directory instead,  written under a name starting with '.' and then
+ *  renamed.  The files are named by the time they were queued.
+ *
+ *  The mail process started by lpd looks at the directory every
+ *  mail_queue_window seconds,  and sends one message to each recipient
+ *  with all of the messages queued for it from the same sender.
+ *  The files are removed when sendmail was run successfully.
+ */
+
+/*
+ * Mail_queue - put the message that starts at 'start' in fd into the
+ *  mail queue directory for each recipient
+ *  returns 0 if they were all queued
+ */
+
+static int Mail_queue( char *mailname, char *opname, int fd, off_t start )
+{
+	static int seq;
+	char *to[2], *tempfile[2], *path[2];
+	char name[SMALLBUFFER], buffer[LARGEBUFFER];
+	struct stat statb;
+	int i, n, out, status = 0;
+
+	to[0] = mailname;
+	to[1] = opname;
+	for( i = 0; i < 2; ++i ){
+		tempfile[i] = path[i] = 0;
+		if( status || to[i] == 0 ) continue;
+		plp_snprintf( name, sizeof(name), ".%010ld.%ld.%d",
+			(long)time( (void *)0 ), (long)getpid(), ++seq );
+		tempfile[i] = Make_pathname( Mail_queue_dir_DYN, name );
+		path[i] = Make_pathname( Mail_queue_dir_DYN, name+1 );
+		if( (out = Checkwrite( tempfile[i], &statb, 0, 1, 0 )) < 0 ){
+			logerr( LOG_INFO, "Mail_queue: cannot open '%s'", tempfile[i] );
+			status = -1;
+			continue;
+		}
+		plp_snprintf( buffer, sizeof(buffer), "To: %s\n", to[i] );
+		if( Write_fd_str( out, buffer ) < 0 || lseek( fd, start, SEEK_SET ) == -1 ){
+			status = -1;
+		}
+		while( status == 0 && (n = ok_read( fd, buffer, sizeof(buffer) )) > 0 ){
+			if( Write_fd_len( out, buffer, n ) < 0 ) status = -1;
+		}
+		if( close( out ) == -1 ) status = -1;
+		if( status ){
+			logerr( LOG_INFO, "Mail_queue: write to '%s' failed", tempfile[i] );
+		}
+	}
+	for( i = 0; i < 2; ++i ){
+		if( tempfile[i] && status == 0 && rename( tempfile[i], path[i] ) == -1 ){
+			logerr( LOG_INFO, "Mail_queue: rename of '%s' failed", tempfile[i] );
+			status = -1;
+		}
+		if( tempfile[i] && status ) unlink( tempfile[i] );
+		if( tempfile[i] ) free( tempfile[i] );
+		if( path[i] ) free( path[i] );
+	}
+	return( status );
+}
+
+/*
+ * Mail_send - send the messages in images.list[first..count-1] that have
+ *  the key (To: and From: lines)
+ *  returns 0 if sendmail was successful
+ */
+
+static int Mail_send( char *key, struct line_list *images, int first, int count )
+{
+	char buffer[SMALLBUFFER];
+	struct job job;
+	char *s, *t, *body;
+	int i, n, fd, keylen = safestrlen(key);
+
+	/* there is no spool directory for temp files, and the process
+	 * runs until lpd exits, so the file is removed when it is sent */
+	fd = Make_temp_fd_in_dir( 0, Server_tmp_dir_DYN );
+	for( n = 0, i = first; i < images->count; ++i ){
+		if( !safestrncmp( images->list[i], key, keylen ) ) ++n;
+	}
+	if( n == 1 ){
+		if( Write_fd_str( fd, images->list[first] ) < 0 ) goto wr_error;
+	} else {
+		plp_snprintf( buffer, sizeof(buffer),
+			"Subject: %d print job notices from %s\n\n", n, FQDNHost_FQDN );
+		if( Write_fd_str( fd, key ) < 0
+			|| Write_fd_str( fd, buffer ) < 0 ) goto wr_error;
+		for( i = first; i < count; ++i ){
+			s = images->list[i];
+			if( safestrncmp( s, key, keylen ) ) continue;
+			s += keylen;
+			if( !(body = strstr( s, "\n\n" )) ) continue;
+			*body = 0;
+			if( !safestrncasecmp( s, "Subject: ", 9 ) ) s += 9;
+			if( (t = safestrchr( s, '\n' )) ) *t = 0;
+			plp_snprintf( buffer, sizeof(buffer), "---- %s\n\n", s );
+			if( t ) *t = '\n';
+			*body = '\n';
+			if( Write_fd_str( fd, buffer ) < 0
+				|| Write_fd_str( fd, body+2 ) < 0
+				|| Write_fd_str( fd, "\n" ) < 0 ) goto wr_error;
+		}
+	}
+	if( lseek( fd, 0, SEEK_SET ) == -1 ){
+		Errorcode = JABORT;
+		logerr_die(LOG_ERR, "Mail_send: seek failed");
+	}
+	Init_job(&job);
+	n = Filter_file( Send_job_rw_timeout_DYN, fd, -1, "MAIL", Sendmail_DYN, 0, &job, 0, 0 );
+	Free_job(&job);
+	close( fd );
+	Remove_tempfiles();
+	if( n ){
+		logerr(LOG_ERR, "Mail_send: '%s' failed '%s'", Sendmail_DYN, Server_status(n) );
+	}
+	return( n );
+
+ wr_error:
+	Errorcode = JABORT;
+	logerr_die(LOG_ERR, "Mail_send: write failed");
+	return( -1 );
+}
+
+/*
+ * Mail_deliver - send the messages in the mail queue directory
+ */
+
+static void Mail_deliver( void )
+{
+	struct line_list names, keys, images;
+	struct stat statb;
+	DIR *dir;
+	plp_dir_t *d;
+	char buffer[LARGEBUFFER];
+	char *image, *path, *s;
+	int fd, i, j, n, len, max;
+
+	if( !(dir = opendir( Mail_queue_dir_DYN )) ){
+		logerr( LOG_INFO, "Mail_deliver: cannot open '%s'", Mail_queue_dir_DYN );
+		return;
+	}
+	Init_line_list(&names);
+	Init_line_list(&keys);
+	Init_line_list(&images);
+	while( (d = readdir(dir)) ){
+		if( d->d_name[0] == '.' ) continue;
+		Add_line_list(&names,d->d_name,0,1,0);
+	}
+	closedir(dir);
+
+	/* read the messages and find the senders and recipients */
+	Check_max(&images,names.count+1);
+	for( i = 0; i < names.count; ++i ){
+		image = 0;
+		len = max = 0;
+		path = Make_pathname( Mail_queue_dir_DYN, names.list[i] );
+		if( (fd = Checkread( path, &statb )) >= 0 ){
+			Init_buf( &image, &max, &len );
+			while( (n = ok_read( fd, buffer, sizeof(buffer) )) > 0 ){
+				Put_buf_len( buffer, n, &image, &max, &len );
+			}
+			close(fd);
+		}
+		free( path );
+		images.list[images.count++] = image;
+		if( image && !safestrncmp( image, "To: ", 4 )
+			&& (s = safestrchr( image, '\n' ))
+			&& !safestrncmp( s+1, "From: ", 6 )
+			&& (s = safestrchr( s+1, '\n' )) ){
+			n = *++s;
+			*s = 0;
+			Add_line_list(&keys,image,0,1,1);
+			*s = n;
+		} else if( image ){
+			logmsg( LOG_ERR, "Mail_deliver: removing bad message '%s'", names.list[i] );
+			path = Make_pathname( Mail_queue_dir_DYN, names.list[i] );
+			unlink( path );
+			free( path );
+		}
+	}
+	DEBUG1("Mail_deliver: %d messages, %d recipients", names.count, keys.count );
+
+	for( i = 0; i < keys.count; ++i ){
+		n = safestrlen( keys.list[i] );
+		for( j = 0; j < images.count
+			&& safestrncmp( images.list[j], keys.list[i], n ); ++j );
+		if( Mail_send( keys.list[i], &images, j, images.count ) ) continue;
+		for( ; j < images.count; ++j ){
+			if( !safestrncmp( images.list[j], keys.list[i], n ) ){
+				path = Make_pathname( Mail_queue_dir_DYN, names.list[j] );
+				unlink( path );
+				free( path );
+			}
+		}
+	}
+	Free_line_list(&names);
+	Free_line_list(&keys);
+	Free_line_list(&images);
+}
+
+/*
+ * Mail process - started by lpd when mail_queue_dir is set.
+ */
+
+pid_t Start_mail( void )
+{
+	return( Start_periodic( "MAIL", Mail_deliver, Mail_queue_window_DYN ) );
+}
@@ -0,0 +1,443 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "errorcodes.h"
+#include "getqueue.h"
+#include "stats.h"
+/**** ENDINCLUDE ****/
+
+#if defined(HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+#endif
+
+/*
+ * LPD statistics
+ *
+ *  The lpd server keeps counters and latency histograms in a segment
+ *  that is set up by Stats_init() in the main lpd process before any
+ *  workers are forked.  The segment is an anonymous shared mapping, so
+ *  every connection server, queue server and subserver updates the same
+ *  counters without talking to the main process.  Counters are updated
+ *  with atomic adds where the compiler supports them;  the worst that
+ *  can happen without them is a lost count.  The histogram time sums
+ *  are doubles and are always plain adds, so the average is approximate.
+ *
+ *  Histograms have power of two buckets in milliseconds, so a report
+ *  can give the count, average and an upper bound for the percentiles.
+ *
+ *  The segment has a slot for each queue,  twice as many as there are
+ *  printcap entries when lpd starts.  It cannot grow,  as the processes
+ *  already forked would keep the old one,  so when there are more queues
+ *  the ones that do not fit are logged and not counted,  and a new
+ *  printcap that is too big is logged when it is read.
+ *
+ *  Programs other than lpd never call Stats_init() and all of the
+ *  Stats_xxx() update calls do nothing.
+ */
+
+#define STATS_BUCKETS 20	/* <= 1ms, 2ms, ... 2^18 ms, overflow */
+#define STATS_QUEUES 256	/* least queues tracked */
+#define STATS_NAMELEN 64
+#define STATS_REQUESTS 11	/* REQ_START .. REQ_LPSTAT */
+
+struct stats_hist {
+	unsigned long count;
+	double sum_usec;
+	unsigned long bucket[STATS_BUCKETS];
+};
+
+struct stats_queue {
+	volatile unsigned long state;	/* 0 free, 1 being claimed, 2 in use */
+	char name[STATS_NAMELEN];
+	unsigned long jobs_received, jobs_printed, jobs_failed;
+	unsigned long kbytes_received, kbytes_printed;
+	struct stats_hist queue_wait, print_time, filter_time;
+};
+
+struct stats_segment {
+	time_t start;
+	unsigned long forks, connections, queues_dropped;
+	volatile unsigned long dropped_logged;
+	int queues;				/* slots in queue[] */
+	struct stats_hist request[STATS_REQUESTS];
+	struct stats_queue queue[1];	/* really queues long */
+};
+
+static struct stats_segment *Stats;
+
+static const char * const Request_name[STATS_REQUESTS] = {
+	"other", "start", "receive", "short_status", "long_status",
+	"remove", "control", "block", "secure", "verbose", "lpstat" };
+
+/*
+ * Stats_init - set up the shared segment for the number of printcap
+ *  entries.  If the system cannot give us a shared mapping we fall back
+ *  to private memory, which only counts what the main process sees.
+ */
+
+void Stats_init( int printers )
+{
+	size_t size;
+	int queues = 2 * printers;
+
+	if( Stats ) return;
+	if( queues < STATS_QUEUES ) queues = STATS_QUEUES;
+	size = sizeof(*Stats) + (queues - 1) * sizeof(Stats->queue[0]);
+	Stats = Shared_segment( size );
+	Stats->start = time( (void *)0 );
+	Stats->queues = queues;
+	DEBUG1("Stats_init: %d queues, segment %ld bytes", queues, (long)size );
+}
+
+/*
+ * Stats_check_size - the printcap was read again,  log it if the queues
+ *  will not all fit in the segment
+ */
+
+void Stats_check_size( int printers )
+{
+	static int logged;
+
+	if( Stats && printers > Stats->queues && printers != logged ){
+		logged = printers;
+		logmsg( LOG_INFO, "Stats_check_size: printcap has %d entries, "
+			"statistics are kept for %d queues - restart lpd to keep them all",
+			printers, Stats->queues );
+	}
+}
+
+/*
+ * Shared_segment - get zeroed memory that is shared with the processes
+ *  forked after this;  if the system cannot give us a shared mapping we
+ *  fall back to private memory.
+ */
+
+void *Shared_segment( size_t size )
+{
+	void *p = 0;
+
+#if defined(HAVE_MMAP) && defined(MAP_SHARED)
+# if defined(MAP_ANONYMOUS)
+	p = mmap( 0, size, PROT_READ|PROT_WRITE,
+		MAP_SHARED|MAP_ANONYMOUS, -1, 0 );
+# elif defined(MAP_ANON)
+	p = mmap( 0, size, PROT_READ|PROT_WRITE,
+		MAP_SHARED|MAP_ANON, -1, 0 );
+# else
+	{
+		int fd;
+		if( (fd = open( "/dev/zero", O_RDWR )) >= 0 ){
+			p = mmap( 0, size, PROT_READ|PROT_WRITE,
+				MAP_SHARED, fd, 0 );
+			close( fd );
+		}
+	}
+# endif
+	if( p == MAP_FAILED ){
+		logerr(LOG_INFO, "Shared_segment: cannot map shared segment" );
+		p = 0;
+	}
+#endif
+	if( p == 0 ){
+		p = malloc_or_die( size, __FILE__,__LINE__ );
+	}
+	memset( p, 0, size );
+	return( p );
+}
+
+double Stats_now( void )
+{
+	struct timeval tv;
+
+	if( gettimeofday( &tv, 0 ) ) return( 0 );
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+static void Stats_hist_add( struct stats_hist *h, double usec )
+{
+	unsigned long ms;
+	int i;
+
+	if( usec < 0 ) usec = 0;
+	ms = (unsigned long)(usec / 1000 + 0.5);
+	for( i = 0; i < STATS_BUCKETS - 1 && ms > (1UL << i); ++i );
+	STATS_ADD( h->bucket[i], 1 );
+	STATS_ADD( h->count, 1 );
+	h->sum_usec += usec;
+}
+
+/*
+ * find the slot for a queue, claiming a free one if it is not there.
+ *  Open addressing on the name hash;  a slot is never given back.
+ */
+
+static struct stats_queue *Stats_queue( const char *printer )
+{
+	struct stats_queue *q;
+	unsigned int h = 0, i;
+	int n;
+	const char *s;
+
+	if( Stats == 0 || ISNULL(printer) ) return( 0 );
+	for( s = printer; *s; ++s ) h = h * 31 + (unsigned char)*s;
+	for( n = 0; n < Stats->queues; ++n ){
+		q = &Stats->queue[(h + n) % Stats->queues];
+		if( q->state == 0 && STATS_CAS( q->state, 0, 1 ) ){
+			mystrncpy( q->name, printer, sizeof(q->name) );
+			STATS_SYNC();
+			q->state = 2;
+			return( q );
+		}
+		/* somebody else is filling in the name */
+		for( i = 0; q->state == 1 && i < 100; ++i ) plp_usleep( 100 );
+		if( q->state == 2 && !strncmp( q->name, printer, sizeof(q->name)-1 ) ){
+			return( q );
+		}
+	}
+	STATS_ADD( Stats->queues_dropped, 1 );
+	if( STATS_CAS( Stats->dropped_logged, 0, 1 ) ){
+		logmsg( LOG_INFO, "Stats_queue: no room for the statistics of '%s', "
+			"%d queues kept - restart lpd to keep them all", printer, Stats->queues );
+	}
+	return( 0 );
+}
+
+void Stats_fork( void )
+{
+	if( Stats ) STATS_ADD( Stats->forks, 1 );
+}
+
+void Stats_connection( void )
+{
+	if( Stats ) STATS_ADD( Stats->connections, 1 );
+}
+
+void Stats_request( int request, double usec )
+{
+	if( Stats == 0 ) return;
+	if( request < 0 || request >= STATS_REQUESTS ) request = 0;
+	Stats_hist_add( &Stats->request[request], usec );
+}
+
+void Stats_job_received( const char *printer, double bytes )
+{
+	struct stats_queue *q;
+
+	if( (q = Stats_queue( printer )) ){
+		STATS_ADD( q->jobs_received, 1 );
+		STATS_ADD( q->kbytes_received, (unsigned long)((bytes+1023)/1024) );
+	}
+}
+
+/*
+ * Stats_job_done - a job was finished by the queue server.
+ *  Held jobs are not finished, they will be back.
+ */
+
+void Stats_job_done( const char *printer, int status, double bytes,
+	double wait_usec, double print_usec )
+{
+	struct stats_queue *q;
+
+	if( status == JHOLD || (q = Stats_queue( printer )) == 0 ) return;
+	if( status == JSUCC ){
+		STATS_ADD( q->jobs_printed, 1 );
+		STATS_ADD( q->kbytes_printed, (unsigned long)((bytes+1023)/1024) );
+	} else {
+		STATS_ADD( q->jobs_failed, 1 );
+	}
+	if( wait_usec > 0 ) Stats_hist_add( &q->queue_wait, wait_usec );
+	if( print_usec > 0 ) Stats_hist_add( &q->print_time, print_usec );
+}
+
+void Stats_filter( const char *printer, double usec )
+{
+	struct stats_queue *q;
+
+	if( (q = Stats_queue( printer )) ){
+		Stats_hist_add( &q->filter_time, usec );
+	}
+}
+
+/*
+ * upper bound in ms of the bucket holding the given fraction of the values
+ */
+
+static unsigned long Stats_percentile( struct stats_hist *h, double fraction )
+{
+	unsigned long want, seen = 0;
+	int i;
+
+	want = (unsigned long)(h->count * fraction + 0.999);
+	if( want == 0 ) return( 0 );
+	for( i = 0; i < STATS_BUCKETS - 1; ++i ){
+		if( (seen += h->bucket[i]) >= want ) break;
+	}
+	return( 1UL << i );
+}
+
+static int Stats_hist_line( int fd, const char *label, struct stats_hist *h )
+{
+	char line[SMALLBUFFER];
+
+	if( h->count == 0 ) return( 0 );
+	plp_snprintf( line, sizeof(line),
+		"  %-14s %8lu %10.1f %8lu %8lu %8lu%s\n", label, h->count,
+		h->sum_usec / 1000 / h->count,
+		Stats_percentile( h, 0.50 ), Stats_percentile( h, 0.90 ),
+		Stats_percentile( h, 0.99 ),
+		h->bucket[STATS_BUCKETS-1] ? " (overflow)" : "" );
+	return( Write_fd_str( fd, line ) );
+}
+
+static int Stats_prom_hist( int fd, const char *name, const char *label,
+	struct stats_hist *h )
+{
+	char line[SMALLBUFFER];
+	unsigned long seen = 0;
+	int i;
+
+	for( i = 0; i < STATS_BUCKETS - 1; ++i ){
+		seen += h->bucket[i];
+		plp_snprintf( line, sizeof(line), "%s_bucket{%s,le=\"%g\"} %lu\n",
+			name, label, (1UL << i) / 1000.0, seen );
+		if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+	}
+	plp_snprintf( line, sizeof(line),
+		"%s_bucket{%s,le=\"+Inf\"} %lu\n%s_sum{%s} %g\n%s_count{%s} %lu\n",
+		name, label, h->count, name, label, h->sum_usec / 1000000,
+		name, label, h->count );
+	return( Write_fd_str( fd, line ) );
+}
+
+static int Stats_prom_type( int fd, const char *name, const char *type )
+{
+	char line[SMALLBUFFER];
+
+	plp_snprintf( line, sizeof(line), "# TYPE %s %s\n", name, type );
+	return( Write_fd_str( fd, line ) );
+}
+
+static int Stats_prometheus( int fd )
+{
+	char line[LINEBUFFER], label[SMALLBUFFER];
+	struct stats_queue *q;
+	int i, j;
+	static const char * const counters[] = {
+		"lpd_jobs_received_total", "lpd_jobs_printed_total",
+		"lpd_jobs_failed_total", "lpd_received_kbytes_total",
+		"lpd_printed_kbytes_total" };
+	static const char * const hists[] = {
+		"lpd_queue_wait_seconds", "lpd_print_time_seconds",
+		"lpd_filter_time_seconds" };
+
+	plp_snprintf( line, sizeof(line),
+		"# TYPE lpd_uptime_seconds gauge\nlpd_uptime_seconds %ld\n"
+		"# TYPE lpd_forks_total counter\nlpd_forks_total %lu\n"
+		"# TYPE lpd_connections_total counter\nlpd_connections_total %lu\n",
+		(long)(time((void *)0) - Stats->start), Stats->forks, Stats->connections );
+	if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+
+	if( Stats_prom_type( fd, "lpd_request_duration_seconds", "histogram" ) < 0 ) return( -1 );
+	for( i = 0; i < STATS_REQUESTS; ++i ){
+		if( Stats->request[i].count == 0 ) continue;
+		plp_snprintf( label, sizeof(label), "request=\"%s\"", Request_name[i] );
+		if( Stats_prom_hist( fd, "lpd_request_duration_seconds", label,
+			&Stats->request[i] ) < 0 ) return( -1 );
+	}
+
+	for( j = 0; j < (int)(sizeof(counters)/sizeof(counters[0])); ++j ){
+		if( Stats_prom_type( fd, counters[j], "counter" ) < 0 ) return( -1 );
+		for( i = 0; i < Stats->queues; ++i ){
+			unsigned long v;
+			q = &Stats->queue[i];
+			if( q->state != 2 ) continue;
+			switch( j ){
+			case 0: v = q->jobs_received; break;
+			case 1: v = q->jobs_printed; break;
+			case 2: v = q->jobs_failed; break;
+			case 3: v = q->kbytes_received; break;
+			default: v = q->kbytes_printed; break;
+			}
+			plp_snprintf( line, sizeof(line), "%s{queue=\"%s\"} %lu\n",
+				counters[j], q->name, v );
+			if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+		}
+	}
+
+	for( j = 0; j < (int)(sizeof(hists)/sizeof(hists[0])); ++j ){
+		if( Stats_prom_type( fd, hists[j], "histogram" ) < 0 ) return( -1 );
+		for( i = 0; i < Stats->queues; ++i ){
+			q = &Stats->queue[i];
+			if( q->state != 2 ) continue;
+			plp_snprintf( label, sizeof(label), "queue=\"%s\"", q->name );
+			if( Stats_prom_hist( fd, hists[j], label,
+				j == 0 ? &q->queue_wait
+				: j == 1 ? &q->print_time : &q->filter_time ) < 0 ) return( -1 );
+		}
+	}
+	return( 0 );
+}
+
+/*
+ * Stats_report - write the statistics to fd
+ *  printer - only report this queue, 0 or "all" for all queues
+ *  prometheus - use the Prometheus text exposition format
+ */
+
+int Stats_report( int fd, const char *printer, int prometheus )
+{
+	char line[LINEBUFFER];
+	struct stats_queue *q;
+	int i, found = 0;
+
+	if( Stats == 0 ){
+		return( Write_fd_str( fd, "lpd statistics not available\n" ) );
+	}
+	if( prometheus ) return( Stats_prometheus( fd ) );
+	if( printer && !safestrcasecmp( printer, ALL ) ) printer = 0;
+
+	plp_snprintf( line, sizeof(line),
+		"lpd statistics on %s: up %ld secs, connections %lu, forks %lu\n"
+		"  %-14s %8s %10s %8s %8s %8s\n",
+		FQDNHost_FQDN, (long)(time((void *)0) - Stats->start),
+		Stats->connections, Stats->forks,
+		"request (ms)", "count", "avg", "p50<=", "p90<=", "p99<=" );
+	if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+	for( i = 0; i < STATS_REQUESTS; ++i ){
+		if( Stats_hist_line( fd, Request_name[i], &Stats->request[i] ) < 0 ) return( -1 );
+	}
+	for( i = 0; i < Stats->queues; ++i ){
+		q = &Stats->queue[i];
+		if( q->state != 2 || (printer && strcmp( printer, q->name )) ) continue;
+		++found;
+		plp_snprintf( line, sizeof(line),
+			"Queue %s: received %lu (%lu KB), printed %lu (%lu KB), failed %lu\n",
+			q->name, q->jobs_received, q->kbytes_received,
+			q->jobs_printed, q->kbytes_printed, q->jobs_failed );
+		if( Write_fd_str( fd, line ) < 0
+			|| Stats_hist_line( fd, "queue wait", &q->queue_wait ) < 0
+			|| Stats_hist_line( fd, "print time", &q->print_time ) < 0
+			|| Stats_hist_line( fd, "filter time", &q->filter_time ) < 0 ){
+			return( -1 );
+		}
+	}
+	if( printer && !found ){
+		plp_snprintf( line, sizeof(line), "Queue %s: no jobs\n", printer );
+		if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+	}
+	if( Stats->queues_dropped ){
+		plp_snprintf( line, sizeof(line),
+			"statistics for more than %d queues not kept, %lu updates dropped\n",
+			Stats->queues, Stats->queues_dropped );
+		if( Write_fd_str( fd, line ) < 0 ) return( -1 );
+	}
+	return( 0 );
+}
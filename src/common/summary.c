@@ -0,0 +1,253 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ *
+ ***************************************************************************/
+
+#include "lp.h"
+#include "stats.h"
+#include "summary.h"
+/**** ENDINCLUDE ****/
+
+/*
+ * Queue status summaries
+ *
+ *  'lpq -a -s' used to cost a Setup_printer() and a Scan_queue() for
+ *  every queue.  The lpd server keeps the short status line of each queue
+ *  in a segment shared by all of the processes it forks,  set up by
+ *  Summary_init() like the statistics segment.
+ *
+ *  Each record has a change count,  which is bumped by Summary_changed()
+ *  wherever the cached lpq status is thrown away:  when a job ticket
+ *  or the spool control file is written,  or a job is removed.
+ *  A process that scans a queue gets the change count with Summary_mark()
+ *  before the scan,  and saves the line it made with Summary_update();
+ *  the line is only used while nothing has changed since the mark.
+ *  The lines are made by Get_queue_status() for short status requests,
+ *  so a queue is only scanned again after it has changed.
+ *
+ *  checkpc and hand cleanups change a queue without lpd knowing,  so a
+ *  line also expires the way the lpq status cache does:  after
+ *  lpq_status_stale seconds,  when the queue or printer status file is
+ *  more than lpq_status_interval seconds newer than it was,  or when
+ *  the lpq status file has been removed.
+ *
+ *  A record is never given back;  if the segment fills up the queues
+ *  that do not fit are simply not summarized.
+ */
+
+#define SUMMARY_QUEUES 8192
+#define SUMMARY_NAMELEN 64
+#define SUMMARY_LINELEN 256
+#define SUMMARY_PATHLEN 128
+
+struct summary_queue {
+	volatile unsigned long state;	/* 0 free, 1 being claimed, 2 in use */
+	volatile unsigned long changes;	/* bumped when the queue changes */
+	volatile unsigned long seen;	/* changes + 1 when the line was made */
+	volatile unsigned long writing;	/* odd while the line is being written */
+	time_t made;			/* when the line was made */
+	time_t modified[2];		/* queue and printer status file times */
+	char status_file[2][SUMMARY_PATHLEN];
+	char lpq_file[SUMMARY_PATHLEN];	/* lpq status file,  if there is one */
+	char name[SUMMARY_NAMELEN];
+	char line[SUMMARY_LINELEN];
+};
+
+struct summary_segment {
+	unsigned long dropped;
+	struct summary_queue queue[SUMMARY_QUEUES];
+};
+
+static struct summary_segment *Summary;
+
+void Summary_init( void )
+{
+	if( Summary ) return;
+	Summary = Shared_segment( sizeof(*Summary) );
+	DEBUG1("Summary_init: segment %ld bytes", (long)sizeof(*Summary) );
+}
+
+/*
+ * find the record for a queue,  claiming a free one if claim is set.
+ *  Open addressing on the name hash,  as in Stats_queue().
+ */
+
+static struct summary_queue *Summary_queue( const char *printer, int claim )
+{
+	struct summary_queue *q;
+	unsigned int h = 0, i, n;
+	const char *s;
+
+	if( Summary == 0 || ISNULL(printer)
+		|| safestrlen(printer) >= SUMMARY_NAMELEN ) return( 0 );
+	for( s = printer; *s; ++s ) h = h * 31 + (unsigned char)*s;
+	for( n = 0; n < SUMMARY_QUEUES; ++n ){
+		q = &Summary->queue[(h + n) % SUMMARY_QUEUES];
+		if( q->state == 0 ){
+			if( !claim ) return( 0 );
+			if( STATS_CAS( q->state, 0, 1 ) ){
+				mystrncpy( q->name, printer, sizeof(q->name) );
+				STATS_SYNC();
+				q->state = 2;
+				return( q );
+			}
+		}
+		/* somebody else is filling in the name */
+		for( i = 0; q->state == 1 && i < 100; ++i ) plp_usleep( 100 );
+		if( q->state == 2 && !strcmp( q->name, printer ) ){
+			return( q );
+		}
+	}
+	if( claim ) STATS_ADD( Summary->dropped, 1 );
+	return( 0 );
+}
+
+/*
+ * Summary_changed - the job tickets or spool control of the queue changed
+ */
+
+void Summary_changed( const char *printer )
+{
+	struct summary_queue *q;
+
+	if( (q = Summary_queue( printer, 0 )) ){
+		STATS_ADD( q->changes, 1 );
+	}
+}
+
+/*
+ * Summary_reset - the configuration was read again,  the printcap
+ *  values in the status lines may have changed
+ */
+
+void Summary_reset( void )
+{
+	int i;
+
+	if( Summary == 0 ) return;
+	for( i = 0; i < SUMMARY_QUEUES; ++i ){
+		if( Summary->queue[i].state == 2 ){
+			STATS_ADD( Summary->queue[i].changes, 1 );
+		}
+	}
+}
+
+/*
+ * Summary_mark - call before the queue is scanned,  and pass the value
+ *  to Summary_update()
+ */
+
+unsigned long Summary_mark( const char *printer )
+{
+	struct summary_queue *q;
+
+	if( (q = Summary_queue( printer, 1 )) == 0 ) return( 0 );
+	STATS_SYNC();
+	return( q->changes );
+}
+
+/*
+ * Summary_path - the modification time of a status file,  0 if there
+ *  is none.  Returns 0 if the name does not fit in a record.
+ */
+
+static int Summary_path( const char *path, char *save, time_t *modified )
+{
+	struct stat statb;
+
+	save[0] = 0;
+	*modified = 0;
+	if( ISNULL(path) ) return( 1 );
+	if( safestrlen(path) >= SUMMARY_PATHLEN ) return( 0 );
+	mystrncpy( save, path, SUMMARY_PATHLEN );
+	if( stat( path, &statb ) == 0 ) *modified = statb.st_mtime;
+	return( 1 );
+}
+
+/*
+ * Summary_update - save the short status line made from a scan
+ *  Called after Setup_printer(),  the status file names are those
+ *  of the queue.  If another process is saving a line we leave it
+ *  to them.
+ */
+
+void Summary_update( const char *printer, unsigned long mark, const char *line )
+{
+	struct summary_queue *q;
+	unsigned long w;
+	const char *lpq_file = 0;
+	int ok;
+
+	if( (q = Summary_queue( printer, 1 )) == 0 ) return;
+	w = q->writing;
+	if( (w & 1) || !STATS_CAS( q->writing, w, w + 1 ) ) return;
+	if( Lpq_status_cached_DYN > 0 ) lpq_file = Lpq_status_file_DYN;
+	ok = Summary_path( Queue_status_file_DYN, q->status_file[0], &q->modified[0] )
+		&& Summary_path( Status_file_DYN, q->status_file[1], &q->modified[1] )
+		&& safestrlen(lpq_file) < SUMMARY_PATHLEN;
+	if( ok ){
+		mystrncpy( q->lpq_file, lpq_file ? lpq_file : "", sizeof(q->lpq_file) );
+		mystrncpy( q->line, line, sizeof(q->line) );
+		q->made = time( (void *)0 );
+		q->seen = mark + 1;
+	} else {
+		q->seen = 0;
+	}
+	STATS_SYNC();
+	q->writing = w + 2;
+	DEBUG3("Summary_update: '%s' mark %lu, changes %lu", printer, mark, q->changes );
+}
+
+/*
+ * Summary_get - copy the short status line of the queue to line
+ *  returns 1 if there is a line,  the queue has not changed since
+ *  it was made and it has not expired,  0 if the queue has to be scanned
+ */
+
+int Summary_get( const char *printer, char *line, int len )
+{
+	struct summary_queue *q;
+	struct stat statb;
+	unsigned long w;
+	char status_file[2][SUMMARY_PATHLEN], lpq_file[SUMMARY_PATHLEN];
+	time_t made, modified[2], now;
+	int i;
+
+	if( (q = Summary_queue( printer, 0 )) == 0 ) return( 0 );
+	w = q->writing;
+	STATS_SYNC();
+	if( (w & 1) || q->seen != q->changes + 1 ) return( 0 );
+	mystrncpy( line, q->line, len );
+	made = q->made;
+	for( i = 0; i < 2; ++i ){
+		mystrncpy( status_file[i], q->status_file[i], sizeof(status_file[i]) );
+		modified[i] = q->modified[i];
+	}
+	mystrncpy( lpq_file, q->lpq_file, sizeof(lpq_file) );
+	STATS_SYNC();
+	if( q->writing != w ) return( 0 );
+
+	now = time( (void *)0 );
+	if( Lpq_status_stale_DYN && now - made > Lpq_status_stale_DYN ){
+		DEBUG3("Summary_get: '%s' stale", printer );
+		return( 0 );
+	}
+	for( i = 0; i < 2; ++i ){
+		if( status_file[i][0] && stat( status_file[i], &statb ) == 0
+			&& statb.st_mtime - modified[i] > Lpq_status_interval_DYN ){
+			DEBUG3("Summary_get: '%s' status file '%s' changed",
+				printer, status_file[i] );
+			return( 0 );
+		}
+	}
+	if( lpq_file[0] && stat( lpq_file, &statb ) < 0 ){
+		DEBUG3("Summary_get: '%s' lpq status file '%s' removed",
+			printer, lpq_file );
+		return( 0 );
+	}
+	return( 1 );
+}
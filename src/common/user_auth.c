@@ -260,6 +260,26 @@ char *ShowSecuritySupported( char *str, int maxlen )
 	return( str );
 }
 
+/*
+ * Init_server_security - called by the lpd server before it starts
+ *  forking connection handlers,  so that security methods can set up
+ *  state they share (ssl keeps its context).  With plugins only ssl
+ *  is loaded for this, and only when it is configured.
+ */
+
+void Init_server_security( void )
+{
+	const struct security *s, **p;
+
+	if( !ISNULL(Ssl_server_cert_DYN) ) (void)FindSecurity( "ssl" );
+	for( p = SecuritySupported ; p != NULL && (s = *p) != NULL ; p++ ) {
+		if( s->server_init ){
+			DEBUG1("Init_server_security: '%s'", s->name );
+			s->server_init();
+		}
+	}
+}
+
 const struct security *FindSecurity( const char *name ) {
 	const struct security *s, **p;
 
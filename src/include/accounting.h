@@ -13,6 +13,8 @@
 #define _ACCOUNTING_H_ 1
 
 /* PROTOTYPES */
+void Accounting_init( void );
 int Do_accounting( int end, char *command, struct job *job, int timeout );
+pid_t Start_accounting( void );
 
 #endif
@@ -0,0 +1,19 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ ***************************************************************************/
+
+#ifndef _BANNER_H_
+#define _BANNER_H_ 1
+
+/* called with each line of the banner page, including the newline */
+typedef void (*BANNER_OUT)( const char *line, int len, void *arg );
+
+/* PROTOTYPES */
+void Banner_page( int width, int length, const char **big, int bigcount,
+	const char **info, int infocount, BANNER_OUT out, void *arg );
+
+#endif
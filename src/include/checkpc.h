@@ -15,6 +15,10 @@
 /* PROTOTYPES */
 int main( int argc, char *argv[], char *envp[] );
 static void mkdir_path( char *path );
+static void Check_work( int *sock, void *arg );
+static void Check_all_printers( struct line_list *spooldirs );
+static void Throttle( void );
+static void Report_fix( const char *action, const char *path, const char *detail );
 static void Scan_printer(struct line_list *spooldirs);
 static void Check_executable_filter( const char *id, char *filter_str );
 static void Make_write_file( char *file, char *printer );
@@ -22,11 +26,13 @@ static void usage(void);
 static int getage( char *age );
 static int getk( char *age );
 static int Check_file( char  *path, int fix, int age, int rmflag );
+static int Check_file_stat( char *path, struct stat *statp, int fix, int age, int rmflag );
 static int Check_read_file( char  *path, int fix, int perms );
 static int Fix_create_dir( char  *path, struct stat *statb );
 static int Fix_owner( char *path );
 static int Fix_perms( char *path, int perms );
 static int Check_spool_dir( char *path );
+static void Fix_tree_owner( char *path, struct stat *statp );
 static void Test_port(int ruid, int euid, char *serial_line );
 static void Fix_clean( char *s, int no );
 static int Check_path_list( char *plist, int allow_missing );
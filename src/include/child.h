@@ -16,6 +16,8 @@ pid_t plp_waitpid (pid_t pid, plp_status_t *statusPtr, int options);
 int Countpid(void);
 void Killchildren( int sig );
 pid_t dofork( int new_process_group );
+void For_all_printers( int workers, int *sock, int redirect,
+	void (*work)( int *sock, void *arg ), void *arg );
 plp_signal_t cleanup_USR1 (int passed_signal) NORETURN;
 plp_signal_t cleanup_HUP (int passed_signal) NORETURN;
 plp_signal_t cleanup_INT (int passed_signal) NORETURN;
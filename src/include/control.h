@@ -44,6 +44,7 @@
 #define  OP_FLUSH		32
 #define  OP_LANG		33
 #define  OP_PPD			34
+#define  OP_STATS		35
 
 /* PROTOTYPES */
 
@@ -47,6 +47,7 @@ EXTERN struct host_information PermHost_IP;		/* for permission lookup */
 /* PROTOTYPES */
 void Clear_all_host_information(void);
 char *Find_fqdn( struct host_information *info, const char *shorthost );
+char *Find_fqdn_again( struct host_information *info, const char *shorthost );
 void Get_local_host( void );
 char *Get_remote_hostbyaddr( struct host_information *info,
 	struct sockaddr *sinaddr, int force_ip_addr_use );
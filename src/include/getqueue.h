@@ -101,7 +101,9 @@ EXTERN const char * NAME				DEFINE( = "name" );
 EXTERN const char * NEW_DEST			DEFINE( = "new_dest" );
 EXTERN const char * NONEP				DEFINE( = "none" );
 EXTERN const char * NUMBER				DEFINE( = "number" );
+EXTERN const char * OPENFD				DEFINE( = "openfd" );
 EXTERN const char * OPENNAME			DEFINE( = "openname" );
+EXTERN const char * OPENSIZE			DEFINE( = "opensize" );
 EXTERN const char * ORIG_IDENTIFIER		DEFINE( = "orig_identifier" );
 EXTERN const char * PORT				DEFINE( = "port" );
 EXTERN const char * PRINTABLE			DEFINE( = "printable" );
@@ -131,8 +133,10 @@ EXTERN const char * SORT_KEY			DEFINE( = "sort_key" );
 EXTERN const char * SPOOLDIR			DEFINE( = "spooldir" );
 EXTERN const char * SPOOLING_DISABLED 	DEFINE( = "spooling_disabled" );
 EXTERN const char * START_TIME			DEFINE( = "start_time" );
+EXTERN const char * START_USEC			DEFINE( = "start_usec" );
 EXTERN const char * STATE				DEFINE( = "state" );
 EXTERN const char * STATUS_CHANGE		DEFINE( = "status_change" );
+EXTERN const char * STATUS_SEGMENT_SUFFIX	DEFINE( = ".0" );
 EXTERN const char * SUBSERVER			DEFINE( = "subserver" );
 EXTERN const char * TRACE				DEFINE( = "trace" );
 /* EXTERN const char * TRANSFERNAME		DEFINE( = "transfername" ); */
@@ -169,6 +173,8 @@ int Set_job_ticket_from_cf_info( struct job *job, char *cf_file_image, int read_
 char *Make_job_ticket_image( struct job *job );
 int Set_job_ticket_file( struct job *job, struct line_list *perm_check, int fd );
 void Get_job_ticket_file( int *lock_fd, struct job *job, char *job_ticket_name );
+char *Lookahead_file( struct job *job, int count );
+void Remove_lookahead_files( struct job *job );
 void Get_spool_control( const char *file, struct line_list *info );
 void Set_spool_control( struct line_list *perm_check, const char *file,
 	struct line_list *info );
@@ -205,7 +211,10 @@ int Server_active( char *file );
 void Update_destination( struct job *job );
 int Get_destination( struct job *job, int n );
 int Get_destination_by_name( struct job *job, char *name );
+int Status_segment_size( int max, int min );
 int Trim_status_file( int status_fd, char *file, int max, int min );
+int Truncate_status_file( char *file, int size );
+char *Get_status_file_image( const char *file, off_t maxsize );
 char *Fix_datafile_infox( struct job *job, const char *number, const char *suffix,
 	const char *xlate_format, int update_df_names );
 void Fix_control( struct job *job, char *filter, char *xlate_format,
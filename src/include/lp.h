@@ -229,8 +229,11 @@ EXTERN char* ShortRemote_FQDN;   /* Short form of Remote host */
 EXTERN int Drop_root_DYN;				/* drop root permissions */
 
 EXTERN int Accounting_check_DYN; /* check accounting at start */
+EXTERN int Accounting_check_cache_DYN; /* seconds to keep accounting check replies */
 EXTERN char* Accounting_end_DYN;/* accounting at start (see also af, la, ar) */
 EXTERN char* Accounting_file_DYN; /* name of accounting file (see also la, ar) */
+EXTERN char* Accounting_journal_DYN; /* journal for accounting records */
+EXTERN int Accounting_journal_interval_DYN; /* interval between journal deliveries */
 EXTERN char* Accounting_namefixup_DYN; /* fix up accounting name */
 EXTERN int Accounting_remote_DYN; /* write remote transfer accounting (if af is set) */
 EXTERN char* Accounting_start_DYN;/* accounting at start (see also af, la, ar) */
@@ -247,8 +250,10 @@ EXTERN char* BK_filter_options_DYN;	/* backwards compatible filter options */
 EXTERN char* BK_of_filter_options_DYN;	/* backwards compatible OF filter options */
 EXTERN int Backwards_compatible_DYN; /* backwards-compatible: job file format */
 EXTERN int Backwards_compatible_filter_DYN; /* backwards-compatible: filter parameters */
+EXTERN char* Banner_big_DYN;	 /* builtin banner big letter lines */
 EXTERN char* Banner_end_DYN;	 /* end banner printing program overrides bp */
 EXTERN int Banner_last_DYN; /* print banner after job instead of before */
+EXTERN char* Banner_info_DYN;	 /* builtin banner information lines */
 EXTERN char* Banner_line_DYN;	 /* short banner line sent to banner printer */
 EXTERN char* Banner_printer_DYN; /* banner printing program (see ep) */
 EXTERN char* Banner_start_DYN;	 /* start banner printing program overrides bp */
@@ -292,12 +297,15 @@ EXTERN int Fifo_DYN; /* FIFO (first in first out) order enforced */
 EXTERN char* Fifo_lock_file_DYN; /* lock file for FIFO */
 
 EXTERN char* Filter_DYN; /* default filter */
+EXTERN int   Filter_copy_replay_DYN; /* filter output saved and sent for each copy */
+EXTERN int   Filter_lookahead_DYN; /* filter the next job while printing */
 EXTERN int   Filter_stderr_to_status_file_DYN; /* filter errors sent to :ps file */
 EXTERN char* Filter_ld_path_DYN;
 EXTERN char* Filter_options_DYN;
 EXTERN char* Filter_path_DYN;
 EXTERN int Fake_large_file_DYN; 	/* fake large file size if you cannot use 0 */
 EXTERN int Filter_poll_interval_DYN; /* intervals at which to check filter */
+EXTERN int Filter_status_interval_DYN; /* minimum interval between filter status updates */
 EXTERN int Force_FQDN_hostname_DYN; /* force FQDN Host name in control file */
 EXTERN int Force_IPADDR_hostname_DYN; /* force IPADDR for Host name in control file */
 EXTERN int Force_localhost_DYN;	/* force localhost for client job transfer */
@@ -343,6 +351,9 @@ EXTERN char* Ipp_port_DYN; /* ipp protocol port */
 EXTERN char* Lpd_path_DYN; /* LPD path for server use */
 EXTERN char* Lpd_port_DYN;	/* client/lpd connect to remote (non-local) lpd servers on this port */
 EXTERN char* Lpd_printcap_path_DYN;
+EXTERN int Lpd_control_workers_DYN; /* processes doing lpc and lprm for all queues */
+EXTERN int Lpd_scan_workers_DYN; /* processes scanning queues at startup */
+EXTERN int Lpd_watch_queues_DYN; /* watch spool queues for changes */
 EXTERN int Lpr_bounce_DYN; /* allow LPR to do bounce queue filtering */
 EXTERN char* Lpq_status_file_DYN; /* cached lpq status */
 EXTERN int   Lpq_status_cached_DYN;  /* how many to cache */
@@ -352,6 +363,8 @@ EXTERN char* Lpr_opts_DYN;		/* addional options for LPR */
 EXTERN int Lpr_send_try_DYN; /* number of times for lpr to try sending job */
 EXTERN char* Mail_from_DYN;
 EXTERN char* Mail_operator_on_error_DYN;
+EXTERN char* Mail_queue_dir_DYN;
+EXTERN int Mail_queue_window_DYN;
 
 EXTERN int Max_accounting_file_size_DYN;	/* maximum accounting file size */
 EXTERN int Max_connect_interval_DYN;	/* maximum connect interval */
@@ -448,6 +461,7 @@ EXTERN char *Ssl_crl_path_DYN;	/* ssl crl cert directory (path) */
 EXTERN char *Ssl_server_cert_DYN;	/* ssl server cert file */
 EXTERN char *Ssl_server_password_file_DYN;	/* ssl server password file */
 EXTERN int Stalled_time_DYN; /* amount of time before reporing stalled job */
+EXTERN char* Stats_socket_DYN; /* UNIX socket for lpd statistics */
 EXTERN char* Status_file_DYN; /* printer status file name */
 EXTERN int Stop_on_abort_DYN; /* stop when job aborts */
 EXTERN char* Stty_command_DYN; /* stty commands to set output line characteristics */
@@ -462,6 +476,7 @@ EXTERN int Use_queuename_flag_DYN;	/* Specified with the -Q option */
 EXTERN int Use_shorthost_DYN;	/* Use short hostname in control file information */
 EXTERN char* User_printcap_DYN;	/* Allow a ${HOME}/.printcap file - name of file*/
 EXTERN int User_is_authuser_DYN;	/* set user to be authentication user value */ 
+EXTERN int Watch_poll_time_DYN; /* polling interval when queues are watched */
 EXTERN char* Xlate_incoming_format_DYN;	/* translate format ids on incoming jobs */
 EXTERN char* Xlate_format_DYN;	/* translate format ids on outgoing jobs */
 
@@ -46,9 +46,11 @@ static int Get_lpd_pid(void);
 static void Set_lpd_pid(int lockfd);
 static int Lock_lpd_pid(void);
 static int Read_server_status( int fd );
+static void Add_server( const char *name );
 static void usage(void);
 static void Get_parms(int argc, char *argv[] );
 static void Accept_connection( int sock );
+static void Send_stats( int sock );
 static int Start_all( int first_scan, int *start_fd );
 plp_signal_t sigchld_handler (int signo);
 static void Setup_waitpid (void);
@@ -0,0 +1,29 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ ***************************************************************************/
+
+#ifndef _LPD_JOBQ_H_
+#define _LPD_JOBQ_H_ 1
+
+/* Jobq_set() values */
+#define JOBQ_KEEP		1
+#define JOBQ_PARK		2
+#define JOBQ_RECHECK	3
+
+/* PROTOTYPES */
+int Jobq_scan( struct line_list *spool_control,
+	struct line_list *sort_order, int *pprintable, int *pheld, int *pmove,
+	int *perr, int *pdone );
+void Jobq_start( void );
+char *Jobq_next( void );
+void Jobq_set( int how );
+int Jobq_active( void );
+char *Jobq_expired( time_t now );
+char *Jobq_oldest_done( int keep );
+int Jobq_expire_wait( time_t now );
+
+#endif
@@ -15,6 +15,7 @@
 int Do_queue_jobs( char *name, int subserver );
 void Service_worker( struct line_list *args, int ) NORETURN;
 void Service_queue( struct line_list *args, int ) NORETURN;
+void Service_lookahead( struct line_list *args, int ) NORETURN;
 int Remove_done_jobs( void );
 
 #endif
@@ -15,6 +15,7 @@
 int Receive_job( int *sock, char *input );
 int Receive_block_job( int *sock, char *input );
 int Scan_block_file( int fd, char *error, int errlen, struct line_list *header_info );
+int Read_one_line( int timeout, int fd, char *buffer, int maxlen );
 int Check_space( double jobsize, int min_space, char *pathname );
 int Check_for_missing_files( struct job *job, struct line_list *files,
 	char *error, int errlen, struct line_list *header_info, int holdfile_fd );
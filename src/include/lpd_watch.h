@@ -0,0 +1,20 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ ***************************************************************************/
+
+#ifndef _LPD_WATCH_H_
+#define _LPD_WATCH_H_ 1
+
+/* PROTOTYPES */
+int Watch_init( void );
+int Watch_active( void );
+void Watch_queue( const char *printer, const char *dir,
+	const char *lockfile, const char *controlfile );
+void Watch_reset( void );
+int Watch_changes( struct line_list *changed );
+
+#endif
@@ -9,6 +9,9 @@
 #ifndef _LPD_WORKER_H_
 #define _LPD_WORKER_H_ 1
 
+typedef void (PeriodicProc)( void );
+
 pid_t Start_worker( const char *name, WorkerProc *proc, struct line_list *parms, int fd );
+pid_t Start_periodic( const char *name, PeriodicProc *deliver, int interval );
 
 #endif
@@ -24,6 +24,7 @@ EXTERN int Show_all;        /* show all status */
 /* PROTOTYPES */
 int main(int argc, char *argv[], char *envp[]);
 static void Show_status(char **argv);
+static void Show_all_short(char **argv);
 static int Read_status_info( char *host, int sock,
 	int output, int timeout, int displayformat,
 	int status_line_count );
@@ -14,6 +14,7 @@
 
 EXTERN char *Accntname_JOB; /* Accounting name: PLP 'R' control file option */
 EXTERN int Auth_JOB;        /* Use authentication */
+EXTERN char *Batch_file_JOB; /* Batch of jobs: -j manifest */
 EXTERN int Binary_JOB;      /* Binary format: 'l' Format */
 EXTERN char *Bnrname_JOB;   /* Banner name: RFC 'L' option */
 EXTERN char *Classname_JOB; /* Class name:  RFC 'C' option */
@@ -48,7 +49,9 @@ EXTERN int Job_number;
 int main(int argc, char *argv[], char *envp[]);
 static void Get_parms(int argc, char *argv[] );
 static void usage(void);
+static int Allowed_user_setting( void );
 static int Make_job( struct job *job );
+static int Lpr_batch( void );
 static int Check_lpr_printable(char *file, int fd, struct stat *statb, int format );
 static void Dienoarg(int option);
 static void Check_int_dup (int option, int *value, char *arg, int maxvalue);
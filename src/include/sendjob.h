@@ -17,6 +17,10 @@ int Send_job( struct job *job, struct job *logjob,
 	int transfer_timeout, char *final_filter );
 int Send_normal( int *sock, struct job *job, struct job *logjob,
 	int transfer_timeout, int block_fd, char *final_filter );
+double Block_file_size( struct job *job );
+void Close_data_files( struct job *job );
 int Send_block( int *sock, struct job *job, struct job *logjob, int transfer_timeout );
+int Send_batch( struct job **jobs, int count,
+	int connect_timeout_len, int transfer_timeout );
 
 #endif
@@ -14,5 +14,6 @@
 
 /* PROTOTYPES */
 void Sendmail_to_user( int retval, struct job *job );
+pid_t Start_mail( void );
 
 #endif
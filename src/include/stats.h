@@ -0,0 +1,37 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ ***************************************************************************/
+
+#ifndef _STATS_H_
+#define _STATS_H_ 1
+
+/* updates of values in a Shared_segment() */
+#if defined(__GNUC__)
+# define STATS_ADD(v,n) ((void)__sync_fetch_and_add(&(v),(n)))
+# define STATS_CAS(v,o,n) __sync_bool_compare_and_swap(&(v),(o),(n))
+# define STATS_SYNC() __sync_synchronize()
+#else
+# define STATS_ADD(v,n) ((void)((v) += (n)))
+# define STATS_CAS(v,o,n) ((v) == (o) ? ((v) = (n), 1) : 0)
+# define STATS_SYNC()
+#endif
+
+/* PROTOTYPES */
+void Stats_init( int printers );
+void Stats_check_size( int printers );
+void *Shared_segment( size_t size );
+double Stats_now( void );
+void Stats_fork( void );
+void Stats_connection( void );
+void Stats_request( int request, double usec );
+void Stats_job_received( const char *printer, double bytes );
+void Stats_job_done( const char *printer, int status, double bytes,
+	double wait_usec, double print_usec );
+void Stats_filter( const char *printer, double usec );
+int Stats_report( int fd, const char *printer, int prometheus );
+
+#endif
@@ -0,0 +1,20 @@
+/***************************************************************************
+ * LPRng - An Extended Print Spooler System
+ *
+ * Copyright 1988-2003, Patrick Powell, San Diego, CA
+ *     papowell@lprng.com
+ * See LICENSE for conditions of use.
+ ***************************************************************************/
+
+#ifndef _SUMMARY_H_
+#define _SUMMARY_H_ 1
+
+/* PROTOTYPES */
+void Summary_init( void );
+void Summary_changed( const char *printer );
+void Summary_reset( void );
+unsigned long Summary_mark( const char *printer );
+void Summary_update( const char *printer, unsigned long mark, const char *line );
+int Summary_get( const char *printer, char *line, int len );
+
+#endif
@@ -27,6 +27,12 @@ typedef int (*SEND_PROC)( int *sock,
 	char *error, int errlen,
 	const struct security *security, struct line_list *info );
 
+typedef int (*SEND_STREAM_PROC)( int *sock,
+	int transfer_timeout,
+	int in_fd, double size, char *tempfile,
+	char *error, int errlen,
+	const struct security *security, struct line_list *info );
+
 typedef int (*GET_REPLY_PROC)( struct job *job, int *sock,
 	int transfer_timeout,
 	char *error, int errlen,
@@ -57,6 +63,21 @@ typedef int (*RECEIVE_PROC)(
 	const struct security *security, char *tempfile,
 	SECURE_WORKER_PROC do_secure_work);
 
+typedef int (*SECURE_STREAM_WORKER_PROC)(
+	char *jobsize, int from_server,
+	int fd, char *tempfile, struct line_list *header_info );
+
+typedef int (*RECEIVE_STREAM_PROC)(
+	int *sock, int transfer_timeout,
+	char *user, char *jobsize, int from_server, char *authtype,
+	struct line_list *info,
+	char *error, int errlen,
+	struct line_list *header_info,
+	const struct security *security, char *tempfile,
+	SECURE_STREAM_WORKER_PROC do_secure_work);
+
+typedef void (*SERVER_INIT_PROC)( void );
+
 typedef int (*REPLY_PROC)(
 	int *sock, char *error, int errlen,
 	struct line_list *info, struct line_list *header_info,
@@ -77,17 +98,22 @@ struct security {
 	SEND_PROC    client_send;		/* client to server authenticate transfer, talk to transfer */
 	ACCEPT_PROC server_accept;		/* server accepts the connection, sets up transfer */
 	RECEIVE_PROC server_receive;	/* server to client, receive from client */
+	/* optional: job transfers without staging the job in the tempfile */
+	SEND_STREAM_PROC client_send_stream;	/* client sends size bytes read from in_fd */
+	RECEIVE_STREAM_PROC server_receive_stream;	/* server passes the job to the worker on a pipe */
+	SERVER_INIT_PROC server_init;	/* lpd server, before it forks connection handlers */
 };
 
 typedef size_t (plugin_get_func)(const struct security **, size_t max);
 
 /* if anything changes, increment this to avoid old plugins getting loaded */
-#define AUTHPLUGINVERSION 0
-#define getter_name(n) get_lprng_auth_0_ ## n
+#define AUTHPLUGINVERSION 2
+#define getter_name(n) get_lprng_auth_2_ ## n
 
 /* PROTOTYPES */
 const struct security *FindSecurity( const char *name );
 char *ShowSecuritySupported( char *str, int maxlen );
+void Init_server_security( void );
 
 #ifndef WITHPLUGINS
 extern const struct security test_auth;
@@ -105,6 +105,12 @@ struct keywords Pc_var_list[] = {
 /* XXSTARTXX */
    /*  always print banner, ignore lpr -h option */
 { "ab", 0,  FLAG_K,  &Always_banner_DYN,0,0,0},
+   /*  seconds to keep accounting check replies when journaling */
+{ "accounting_check_cache", 0,  INTEGER_K,  &Accounting_check_cache_DYN,0,0,"=60"},
+   /*  journal for accounting records, sent in batches by lpd */
+{ "accounting_journal", 0,  STRING_K,  &Accounting_journal_DYN,0,0,0},
+   /*  interval in secs between sending the accounting journal records */
+{ "accounting_journal_interval", 0,  INTEGER_K,  &Accounting_journal_interval_DYN,0,0,"=5"},
    /*  set accounting name in control file based on host name */
 { "accounting_namefixup", 0,  STRING_K,  &Accounting_namefixup_DYN,0,0,0},
    /*  query accounting server when connected */
@@ -133,6 +139,10 @@ struct keywords Pc_var_list[] = {
 { "auth", 0,  STRING_K, &Auth_DYN,0,0,0},
    /*  client to server authentication filter */
 { "auth_forward", 0, STRING_K, &Auth_forward_DYN,0,0,0},
+   /*  builtin banner: big letter lines, separated by ; */
+{ "banner_big", 0,  STRING_K,  &Banner_big_DYN,0,0,"=$-j;$-L;$-h;$-J"},
+   /*  builtin banner: information lines, separated by ; */
+{ "banner_info", 0,  STRING_K,  &Banner_info_DYN,0,0,"=User:  $-n@$-h ($-L);Date:  $-t;Job:   $-J;Class: $-C"},
    /*  end banner printing program overides bp */
 { "be", 0,  STRING_K,  &Banner_end_DYN,0,0,0},
    /*  Berkeley LPD: job file strictly RFC-compliant */
@@ -227,14 +237,20 @@ struct keywords Pc_var_list[] = {
 { "fifo_lock_file", 0, STRING_K, &Fifo_lock_file_DYN,0,0,"=fifo.lock"},
    /* default filter */
 { "filter", 0, STRING_K, &Filter_DYN,0,0,0},
+   /* run the filter once for a multiple copy job and send its output for each copy */
+{ "filter_copy_replay", 0, FLAG_K, &Filter_copy_replay_DYN,0,0,0},
    /* filter LD_LIBRARY_PATH value */
 { "filter_ld_path", 0, STRING_K, &Filter_ld_path_DYN,0,0,"=" FILTER_LD_PATH },
+   /* run the filters for the next job while the current job prints */
+{ "filter_lookahead", 0, FLAG_K, &Filter_lookahead_DYN,0,0,0},
    /* filter options */
 { "filter_options", 0, STRING_K, &Filter_options_DYN,0,0,"=$A $B $C $D $E $F $G $H $I $J $K $L $M $N $O $P $Q $R $S $T $U $V $W $X $Y $Z $a $b $c $d $e $f $g $h $i $j $k $l $m $n $o $p $q $r $s $t $u $v $w $x $y $z $-a"},
    /* filter PATH environment variable */
 { "filter_path", 0, STRING_K, &Filter_path_DYN,0,0,"=" FILTER_PATH },
    /* interval at which to check OF filter for error status */
 { "filter_poll_interval", 0, INTEGER_K, &Filter_poll_interval_DYN,0,0,"=30"},
+   /* minimum interval in seconds between filter progress messages; 0 means report each one */
+{ "filter_status_interval", 0, INTEGER_K, &Filter_status_interval_DYN,0,0,0},
    /* write filter errors to the :ps=status file if there is one */
 { "filter_stderr_to_status_file", 0, FLAG_K, &Filter_stderr_to_status_file_DYN,0,0,0},
    /*  print a form feed when device is opened */
@@ -315,6 +331,8 @@ struct keywords Pc_var_list[] = {
 { "lp", 0,  STRING_K,  &Lp_device_DYN,0,0,0},
    /* force lpd to filter jobs (bounce) before sending to remote queue */
 { "lpd_bounce", 0, FLAG_K, &Lpd_bounce_DYN,0,0,0},
+   /*  number of processes doing an lpc request for all queues */
+{ "lpd_control_workers", 0,  INTEGER_K,  &Lpd_control_workers_DYN,0,0,"=4"},
    /* force a poll operation */
 { "lpd_force_poll", 0, FLAG_K, &Force_poll_DYN,0,0,0},
    /* lpd server listen port, "off" does not open remote port, usual port is 515. */
@@ -331,6 +349,12 @@ struct keywords Pc_var_list[] = {
 { "lpd_port", 0, STRING_K, &Lpd_port_DYN,0,0,"=515"},
    /* lpd printcap path */
 { "lpd_printcap_path", 0, STRING_K, &Lpd_printcap_path_DYN,1,0,"=" LPD_PRINTCAP_PATH},
+   /*  number of processes scanning the queues when lpd starts */
+{ "lpd_scan_workers", 0,  INTEGER_K,  &Lpd_scan_workers_DYN,0,0,"=4"},
+   /*  interval in secs between servicing all queues when they are watched */
+{ "lpd_watch_poll_time", 0,  INTEGER_K,  &Watch_poll_time_DYN,0,0,"=3600"},
+   /*  watch spool queues for changes instead of relying on polling */
+{ "lpd_watch_queues", 0, FLAG_K, &Lpd_watch_queues_DYN,0,0,"=1"},
    /* maximum number of lpq status queries kept in cache */
 { "lpq_status_cached", 0, INTEGER_K, &Lpq_status_cached_DYN,0,0,"=10"},
    /* cached lpq status file */
@@ -351,6 +375,10 @@ struct keywords Pc_var_list[] = {
 { "mail_from", 0, STRING_K, &Mail_from_DYN,0,0,0},
    /* mail to this operator on error */
 { "mail_operator_on_error", 0, STRING_K, &Mail_operator_on_error_DYN,0,0,0},
+   /* directory for mail sent in batches by the lpd mail process */
+{ "mail_queue_dir", 0, STRING_K, &Mail_queue_dir_DYN,0,0,0},
+   /* interval in secs between mail batches */
+{ "mail_queue_window", 0, INTEGER_K, &Mail_queue_window_DYN,0,0,"=30"},
    /* maximum accounting file size in Kbytes; 0 means no limit on size */
 { "max_accounting_file_size", 0, INTEGER_K, &Max_accounting_file_size_DYN,0,0,"=0"},
    /* maximum interval between connection attempts */
@@ -527,6 +555,8 @@ struct keywords Pc_var_list[] = {
 { "ssl_server_password_file", 0,  STRING_K,  &Ssl_server_password_file_DYN,0,0,"=" SSL_SERVER_PASSWORD_FILE },
    /*  stalled job timeout */
 { "stalled_time", 0, INTEGER_K, &Stalled_time_DYN,0,0,"=120"},
+   /*  UNIX socket for lpd statistics in Prometheus format */
+{ "stats_socket", 0,  STRING_K,  &Stats_socket_DYN,0,0,0},
    /*  stop processing queue on filter abort */
 { "stop_on_abort", 0,  FLAG_K,  &Stop_on_abort_DYN,0,0,0},
    /*  stty commands to set output line characteristics */